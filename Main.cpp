@@ -1,7 +1,84 @@
+#include <fstream>
 #include <iostream>
+#include <sstream>
 
-int main(int argc, char** argv) {
-  std::cout << "Hello, world!" << std::endl;
+#include "Driver/CompilerDatabase.hpp"
+#include "Interpreter/BytecodeCompiler.hpp"
+#include "Interpreter/JitMachine.hpp"
+#include "Interpreter/VirtualMachine.hpp"
+#include "Utility/UTF32Functions.hpp"
+
+using namespace Cygni;
+
+namespace {
+
+void Usage() {
+  std::cerr << "usage: cygni [--invocations <n>] [--back-edges <n>] "
+               "[--log-tiering] <source file>"
+            << std::endl;
+}
+
+}; /* namespace */
+
+/* Runs 'func main(): ...' of the given source file and prints its value.
+ * Where the JIT is supported, a function is compiled to machine code once
+ * it has been called '--invocations' times or has looped '--back-edges'
+ * times; '--log-tiering' writes these decisions to the standard error. */
+int main(int argc, char **argv) {
+  Interpreter::TierThresholds thresholds;
+  bool logTiering = false;
+  const char *path = nullptr;
+  try {
+    for (int i = 1; i < argc; i++) {
+      std::string argument = argv[i];
+      if (argument == "--invocations" && i + 1 < argc) {
+        thresholds.invocations = std::stoul(argv[++i]);
+      } else if (argument == "--back-edges" && i + 1 < argc) {
+        thresholds.backEdges = std::stoul(argv[++i]);
+      } else if (argument == "--log-tiering") {
+        logTiering = true;
+      } else if (!path && argument.compare(0, 2, "--") != 0) {
+        path = argv[i];
+      } else {
+        Usage();
+        return 1;
+      }
+    }
+  } catch (const std::exception &) {
+    Usage();
+    return 1;
+  }
+  if (!path) {
+    Usage();
+    return 1;
+  }
+  std::ifstream stream(path);
+  if (!stream) {
+    std::cerr << "cannot open '" << path << "'" << std::endl;
+    return 1;
+  }
+  std::ostringstream text;
+  text << stream.rdbuf();
+
+  try {
+    Driver::CompilerDatabase database;
+    database.SetSourceText(path, Utility::UTF8ToUTF32(text.str()));
+    Interpreter::BytecodeModule module =
+        Interpreter::BytecodeCompiler(&database).Compile();
+    if (Interpreter::JitMachine::IsSupported()) {
+      Interpreter::JitMachine machine(&module, thresholds);
+      if (logTiering) {
+        machine.LogTiering(&std::cerr);
+      }
+      std::cout << machine.Call(U"main", {}).ToString() << std::endl;
+    } else {
+      Interpreter::VirtualMachine machine(&module);
+      std::cout << machine.Call(U"main", {}).ToString() << std::endl;
+    }
+  } catch (const std::exception &exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
 
   return 0;
-}
\ No newline at end of file
+}
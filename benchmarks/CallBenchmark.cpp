@@ -0,0 +1,78 @@
+#include <iostream>
+
+#include "Driver/CompilerDatabase.hpp"
+#include "Interpreter/BytecodeCompiler.hpp"
+#include "Interpreter/VirtualMachine.hpp"
+#include "PerformanceCounter.hpp"
+
+using namespace Cygni::Benchmarks;
+using namespace Cygni::Driver;
+using namespace Cygni::Interpreter;
+
+/* Every loop selects a function the same way; 'direct' then ignores it
+ * and calls f0 by name. */
+const char32_t *PROGRAM =
+    U"func f0(x: Int): Int { x + 1; }\n"
+    U"func f1(x: Int): Int { x + 2; }\n"
+    U"func f2(x: Int): Int { x + 3; }\n"
+    U"func f3(x: Int): Int { x + 4; }\n"
+    U"func f4(x: Int): Int { x + 5; }\n"
+    U"func f5(x: Int): Int { x + 6; }\n"
+    U"func direct(n: Int, targets: Int): Int {"
+    U"  var total = 0; var i = 0; var k = 0; var f = f0;"
+    U"  while (i < n) {"
+    U"    if (k == 0) { f = f0; } if (k == 1) { f = f1; }"
+    U"    if (k == 2) { f = f2; } if (k == 3) { f = f3; }"
+    U"    if (k == 4) { f = f4; } if (k == 5) { f = f5; }"
+    U"    total = f0(total); i = i + 1; k = k + 1;"
+    U"    if (k == targets) { k = 0; }"
+    U"  }"
+    U"  total;"
+    U"}\n"
+    U"func calls(n: Int, targets: Int): Int {"
+    U"  var total = 0; var i = 0; var k = 0; var f = f0;"
+    U"  while (i < n) {"
+    U"    if (k == 0) { f = f0; } if (k == 1) { f = f1; }"
+    U"    if (k == 2) { f = f2; } if (k == 3) { f = f3; }"
+    U"    if (k == 4) { f = f4; } if (k == 5) { f = f5; }"
+    U"    total = f(total); i = i + 1; k = k + 1;"
+    U"    if (k == targets) { k = 0; }"
+    U"  }"
+    U"  total;"
+    U"}\n";
+
+void Report(const std::string &name, VirtualMachine &machine,
+            const std::u32string &function, std::vector<Value> arguments) {
+  uint64_t hits = machine.CacheHits();
+  uint64_t misses = machine.CacheMisses();
+  PerformanceCounter counter;
+  counter.Start();
+  Value result = machine.Call(function, arguments);
+  counter.Stop();
+  hits = machine.CacheHits() - hits;
+  misses = machine.CacheMisses() - misses;
+  std::cout << name << ": " << counter.Milliseconds() << " ms ("
+            << result.ToString() << "), hit rate "
+            << (hits + misses ? 100.0 * hits / (hits + misses) : 0.0)
+            << "%, megamorphic sites " << machine.MegamorphicTransitions()
+            << std::endl;
+}
+
+int main(int argc, char **argv) {
+  int scale = argc > 1 ? std::stoi(argv[1]) : 1;
+  int n = 5000000 * scale;
+
+  CompilerDatabase database;
+  database.SetSourceText("benchmark", PROGRAM);
+  BytecodeModule module = BytecodeCompiler(&database).Compile();
+  VirtualMachine machine(&module);
+
+  Report("direct", machine, U"direct", {Value::Int32(n), Value::Int32(1)});
+  Report("monomorphic", machine, U"calls", {Value::Int32(n), Value::Int32(1)});
+  Report("polymorphic (4)", machine, U"calls",
+         {Value::Int32(n), Value::Int32(4)});
+  VirtualMachine fresh(&module);
+  Report("megamorphic (6)", fresh, U"calls",
+         {Value::Int32(n), Value::Int32(6)});
+  return 0;
+}
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <list>
+#include <sstream>
+
+#include "LexicalAnalysis/Lexer.hpp"
+#include "PerformanceCounter.hpp"
+#include "SyntaxAnalysis/Parser.hpp"
+#include "Utility/UTF32Functions.hpp"
+#include "Visitors/IncrementalTypeChecker.hpp"
+
+using namespace Cygni::Benchmarks;
+using namespace Cygni::LexicalAnalysis;
+using namespace Cygni::SyntaxAnalysis;
+using namespace Cygni::Expressions;
+using namespace Cygni::Visitors;
+
+/* Ten lines per function; every function calls 'util' and its successor. */
+std::string GenerateFunction(int i, int functionCount, int constant) {
+  std::ostringstream stream;
+  stream << "func f" << i << "(x: Int, y: Int): Int {\n"
+         << "  var a = x + y * " << constant << ";\n"
+         << "  {\n"
+         << "    var b = a;\n"
+         << "    while (b < x) { b = b + a * 2 - y; }\n"
+         << "  };\n"
+         << "  if (a == y) { var c = a + 1; c; } else { a - 1; }\n"
+         << "  util(a) + f" << (i + 1) % functionCount << "(a * x, y / 3 - 7);\n"
+         << "}\n\n";
+  return stream.str();
+}
+
+std::shared_ptr<SourceCodeFile> sourceCodeFile =
+    std::make_shared<SourceCodeFile>("benchmark");
+std::list<Parser> parsers;
+
+std::vector<const LambdaExpression *> Parse(const std::string &code) {
+  Lexer lexer(sourceCodeFile, Cygni::Utility::UTF8ToUTF32(code));
+  parsers.emplace_back(lexer.ReadAll(), sourceCodeFile);
+  std::vector<const LambdaExpression *> functions;
+  while (!parsers.back().IsEof()) {
+    functions.push_back(static_cast<const LambdaExpression *>(
+        parsers.back().FunctionDeclarationStatement()));
+  }
+  return functions;
+}
+
+void Edit(IncrementalTypeChecker &checker, const std::string &name,
+          const std::string &code) {
+  PerformanceCounter counter;
+  counter.Start();
+  for (auto function : Parse(code)) {
+    checker.SetFunction(function);
+  }
+  int count = checker.Check();
+  counter.Stop();
+  std::cout << name << ": " << count << " bodies re-checked, "
+            << counter.Milliseconds() << " ms" << std::endl;
+}
+
+int main(int argc, char **argv) {
+  int functionCount = argc > 1 ? std::stoi(argv[1]) : 10000;
+  std::string code = "func util(x: Int): Int { x * 2; }\n";
+  for (int i = 0; i < functionCount; i++) {
+    code += GenerateFunction(i, functionCount, i);
+  }
+  auto functions = Parse(code);
+  std::cout << "functions: " << functions.size() << ", lines: "
+            << 10 * functionCount + 1 << std::endl;
+
+  IncrementalTypeChecker checker;
+  PerformanceCounter counter;
+  counter.Start();
+  for (auto function : functions) {
+    checker.SetFunction(function);
+  }
+  int count = checker.Check();
+  counter.Stop();
+  std::cout << "initial check: " << count << " bodies, "
+            << counter.Milliseconds() << " ms" << std::endl;
+
+  Edit(checker, "edit a body", GenerateFunction(42, functionCount, 7));
+  Edit(checker, "edit the body of a widely called function",
+       "func util(x: Int): Int { x * 3; }");
+  Edit(checker, "edit a signature",
+       "func f42(x: Int, y: Int): Char { 'c'; }");
+  Edit(checker, "edit the signature of a widely called function",
+       "func util(x: Int): Char { 'c'; }");
+
+  return 0;
+}
@@ -0,0 +1,49 @@
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "Expressions/Type.hpp"
+#include "PerformanceCounter.hpp"
+
+using namespace Cygni::Benchmarks;
+using namespace Cygni::Expressions;
+
+const int OPERATIONS = 1 << 21;
+
+double Run(int threadCount, const std::function<void(int, int)> &work) {
+  PerformanceCounter counter;
+  std::vector<std::thread> threads;
+  counter.Start();
+  for (int t = 0; t < threadCount; t++) {
+    threads.emplace_back(work, t, OPERATIONS / threadCount);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  counter.Stop();
+  return counter.Milliseconds();
+}
+
+int main() {
+  const Type *int32Type = TypeFactory::CreateBasicType(TypeCode::Int32);
+  const Type *charType = TypeFactory::CreateBasicType(TypeCode::Char);
+
+  std::cout << "operations per run: " << OPERATIONS << ", hardware threads: "
+            << std::thread::hardware_concurrency() << std::endl;
+  std::cout << "threads, sharded type factory ms" << std::endl;
+  for (int threadCount = 1; threadCount <= 64; threadCount *= 2) {
+    TypeFactory typeFactory;
+    double typeFactoryTime = Run(threadCount, [&](int t, int count) {
+      const Type *type = int32Type;
+      for (int i = 0; i < count; i++) {
+        type = i % 64 == 0 ? int32Type
+                           : typeFactory.CreateCallableType({type}, charType);
+      }
+    });
+
+    std::cout << threadCount << ", " << typeFactoryTime << std::endl;
+  }
+
+  return 0;
+}
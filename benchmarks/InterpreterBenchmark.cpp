@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <functional>
+#include <iostream>
+
+#include "Driver/CompilerDatabase.hpp"
+#include "Interpreter/BytecodeCompiler.hpp"
+#include "Interpreter/ClosureInterpreter.hpp"
+#include "Interpreter/RegisterCompiler.hpp"
+#include "Interpreter/RegisterMachine.hpp"
+#include "Interpreter/VirtualMachine.hpp"
+#include "PerformanceCounter.hpp"
+#include "Utility/UTF32Functions.hpp"
+
+using namespace Cygni::Benchmarks;
+using namespace Cygni::Driver;
+using namespace Cygni::Interpreter;
+
+const char32_t *PROGRAM =
+    U"func fib(n: Int): Int {"
+    U"  if (n < 2) { n; } else { fib(n - 1) + fib(n - 2); }"
+    U"}\n"
+    U"func loop(n: Int): Int {"
+    U"  var total = 0; var i = 0;"
+    U"  while (i < n) { total = total + i * 3 - total / 7; i = i + 1; }"
+    U"  total;"
+    U"}\n"
+    U"func nested(n: Int): Int {"
+    U"  var x = 1; var i = 0;"
+    U"  while (i < n) { x = (x * 3 + i * 7 - (x / 3) * 2) / 5 + i; i = i + 1; }"
+    U"  x;"
+    U"}\n"
+    U"func build(n: Int): String {"
+    U"  var text = \"\"; var i = 0;"
+    U"  while (i < n) { text = text + \"ab\"; i = i + 1; }"
+    U"  text;"
+    U"}\n";
+
+int NativeFib(int n) { return n < 2 ? n : NativeFib(n - 1) + NativeFib(n - 2); }
+
+int NativeLoop(int n) {
+  int total = 0;
+  for (int i = 0; i < n; i++) {
+    total = total + i * 3 - total / 7;
+  }
+  return total;
+}
+
+void Measure(const std::string &name, std::function<std::string()> run) {
+  PerformanceCounter counter;
+  counter.Start();
+  std::string result = run();
+  counter.Stop();
+  std::cout << name << ": " << counter.Milliseconds() << " ms (" << result
+            << ")" << std::endl;
+}
+
+int main(int argc, char **argv) {
+  int scale = argc > 1 ? std::stoi(argv[1]) : 1;
+  volatile int fibArgument = 27;
+  volatile int loopArgument = 10000000 * scale;
+  int buildArgument = 20000 * scale;
+
+  CompilerDatabase database;
+  database.SetSourceText("benchmark", PROGRAM);
+  ClosureInterpreter closures(&database);
+  BytecodeModule module = BytecodeCompiler(&database).Compile();
+  VirtualMachine machine(&module);
+  RegisterModule registerModule = RegisterCompiler(&database).Compile();
+  RegisterMachine registers(&registerModule);
+
+  Measure("native fib(27)",
+          [&]() { return std::to_string(NativeFib(fibArgument)); });
+  Measure("native loop", [&]() {
+    return std::to_string(NativeLoop(loopArgument));
+  });
+  Measure("closures fib(27)", [&]() {
+    return closures.Call(U"fib", {Value::Int32(fibArgument)}).ToString();
+  });
+  Measure("closures loop", [&]() {
+    return closures.Call(U"loop", {Value::Int32(loopArgument)}).ToString();
+  });
+  Measure("closures nested", [&]() {
+    return closures.Call(U"nested", {Value::Int32(loopArgument)}).ToString();
+  });
+  Measure("closures build", [&]() {
+    return std::to_string(
+        closures.Call(U"build", {Value::Int32(buildArgument)}).string->size());
+  });
+  Measure("bytecode fib(27)", [&]() {
+    return machine.Call(U"fib", {Value::Int32(fibArgument)}).ToString();
+  });
+  Measure("bytecode loop", [&]() {
+    return machine.Call(U"loop", {Value::Int32(loopArgument)}).ToString();
+  });
+  Measure("bytecode nested", [&]() {
+    return machine.Call(U"nested", {Value::Int32(loopArgument)}).ToString();
+  });
+  Measure("bytecode build", [&]() {
+    return std::to_string(
+        machine.Call(U"build", {Value::Int32(buildArgument)}).string->size());
+  });
+  Measure("registers fib(27)", [&]() {
+    return registers.Call(U"fib", {Value::Int32(fibArgument)}).ToString();
+  });
+  Measure("registers loop", [&]() {
+    return registers.Call(U"loop", {Value::Int32(loopArgument)}).ToString();
+  });
+  Measure("registers nested", [&]() {
+    return registers.Call(U"nested", {Value::Int32(loopArgument)}).ToString();
+  });
+  Measure("registers build", [&]() {
+    return std::to_string(
+        registers.Call(U"build", {Value::Int32(buildArgument)}).string->size());
+  });
+
+  std::cout << std::endl << "instructions (static, executed):" << std::endl;
+  machine.CountInstructions(true);
+  registers.CountInstructions(true);
+  for (const auto &[name, argument] :
+       std::vector<std::pair<std::u32string, int>>{{U"fib", 20},
+                                                   {U"loop", 100000},
+                                                   {U"nested", 100000},
+                                                   {U"build", 1000}}) {
+    uint64_t stackStart = machine.InstructionCount();
+    machine.Call(name, {Value::Int32(argument)});
+    uint64_t registerStart = registers.InstructionCount();
+    registers.Call(name, {Value::Int32(argument)});
+    const BytecodeFunction &stackCode =
+        module.functions.at(module.functionNumbers.at(name));
+    const RegisterFunction &registerCode =
+        registerModule.functions.at(registerModule.functionNumbers.at(name));
+    std::string listing = Disassemble(stackCode);
+    auto stackStatic = std::count(listing.begin(), listing.end(), '\n');
+    std::cout << Cygni::Utility::UTF32ToUTF8(name) << ": stack "
+              << stackStatic << " (" << stackCode.code.size() << " bytes), "
+              << machine.InstructionCount() - stackStart << "; registers "
+              << registerCode.code.size() << " ("
+              << registerCode.code.size() * sizeof(RegisterInstruction)
+              << " bytes), " << registers.InstructionCount() - registerStart
+              << std::endl;
+  }
+
+  return 0;
+}
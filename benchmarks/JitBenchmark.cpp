@@ -0,0 +1,112 @@
+#include <functional>
+#include <iostream>
+
+#include "Driver/CompilerDatabase.hpp"
+#include "Interpreter/BytecodeCompiler.hpp"
+#include "Interpreter/JitMachine.hpp"
+#include "PerformanceCounter.hpp"
+
+using namespace Cygni::Benchmarks;
+using namespace Cygni::Driver;
+using namespace Cygni::Interpreter;
+
+const char32_t *PROGRAM =
+    U"func fib(n: Int): Int {"
+    U"  if (n < 2) { n; } else { fib(n - 1) + fib(n - 2); }"
+    U"}\n"
+    U"func loop(n: Int): Int {"
+    U"  var total = 0; var i = 0;"
+    U"  while (i < n) { total = total + i * 3 - total / 7; i = i + 1; }"
+    U"  total;"
+    U"}\n"
+    U"func sieve(n: Int): Int {"
+    U"  var count = 0; var i = 2;"
+    U"  while (i < n) {"
+    U"    var prime = true; var j = 2;"
+    U"    while (j * j <= i) {"
+    U"      if (i - (i / j) * j == 0) { prime = false; }"
+    U"      j = j + 1;"
+    U"    }"
+    U"    if (prime) { count = count + 1; }"
+    U"    i = i + 1;"
+    U"  }"
+    U"  count;"
+    U"}\n"
+    U"func mandel(n: Int): Int {"
+    U"  var inside = 0; var y = 0; var ci = 0.0 - 1.5;"
+    U"  while (y < n) {"
+    U"    var x = 0; var cr = 0.0 - 2.0;"
+    U"    while (x < n) {"
+    U"      var zr = 0.0; var zi = 0.0; var m = 0;"
+    U"      while (m < 50) {"
+    U"        if (zr * zr + zi * zi > 4.0) { m = 100; } else {"
+    U"          var t = zr * zr - zi * zi + cr;"
+    U"          zi = 2.0 * zr * zi + ci; zr = t; m = m + 1;"
+    U"        }"
+    U"      }"
+    U"      if (m == 50) { inside = inside + 1; }"
+    U"      cr = cr + 0.046875; x = x + 1;"
+    U"    }"
+    U"    ci = ci + 0.046875; y = y + 1;"
+    U"  }"
+    U"  inside;"
+    U"}\n";
+
+/* The best of three runs. */
+double Measure(std::function<Value()> run, Value &result) {
+  double best = 0;
+  for (int i = 0; i < 3; i++) {
+    PerformanceCounter counter;
+    counter.Start();
+    result = run();
+    counter.Stop();
+    if (i == 0 || counter.Milliseconds() < best) {
+      best = counter.Milliseconds();
+    }
+  }
+  return best;
+}
+
+int main() {
+  CompilerDatabase database;
+  database.SetSourceText("benchmark", PROGRAM);
+  BytecodeModule module = BytecodeCompiler(&database).Compile();
+  VirtualMachine machine(&module);
+  JitMachine jit(&module);
+  JitMachine tiered(&module, TierThresholds());
+  std::cout << "jit " << (JitMachine::IsSupported() ? "enabled" : "disabled")
+            << ", " << jit.CodeSize() << " bytes of code" << std::endl;
+
+  const std::pair<const char32_t *, int> runs[] = {
+      {U"fib", 27}, {U"loop", 3000000}, {U"sieve", 40000}, {U"mandel", 96}};
+  for (const auto &run : runs) {
+    std::u32string name = run.first;
+    std::vector<Value> arguments{Value::Int32(run.second)};
+    Value expected;
+    Value actual;
+    double interpreted =
+        Measure([&]() { return machine.Call(name, arguments); }, expected);
+    double compiled =
+        Measure([&]() { return jit.Call(name, arguments); }, actual);
+    /* The first tiered call interprets until a loop in it gets hot, then
+     * moves over to native code. */
+    PerformanceCounter first;
+    first.Start();
+    tiered.Call(name, arguments);
+    first.Stop();
+    tiered.WaitForCompilation();
+    double warm =
+        Measure([&]() { return tiered.Call(name, arguments); }, actual);
+    std::cout << std::string(name.begin(), name.end()) << ": bytecode "
+              << interpreted << " ms, "
+              << (jit.IsCompiled(name) ? "jit " : "fallback ") << compiled
+              << " ms (" << interpreted / compiled << "x), tiered "
+              << first.Milliseconds() << " ms first, " << warm
+              << " ms warm, results " << expected.ToString() << " / "
+              << actual.ToString() << std::endl;
+  }
+  for (const std::string &line : tiered.TierLog()) {
+    std::cout << line << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,55 @@
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "LexicalAnalysis/Lexer.hpp"
+#include "PerformanceCounter.hpp"
+#include "SyntaxAnalysis/Parser.hpp"
+#include "Utility/UTF32Functions.hpp"
+#include "Visitors/ParallelTypeChecker.hpp"
+
+using namespace Cygni::Benchmarks;
+using namespace Cygni::LexicalAnalysis;
+using namespace Cygni::SyntaxAnalysis;
+using namespace Cygni::Expressions;
+using namespace Cygni::Visitors;
+
+std::u32string GenerateProgram(int functionCount) {
+  std::ostringstream stream;
+  for (int i = 0; i < functionCount; i++) {
+    stream << "func f" << i << "(x: Int, y: Int): Int {"
+           << " var a = x + y * " << i << ";"
+           << " { var b = a; while (b < x) { b = b + a * 2 - y; } };"
+           << " if (a == y) { var c = a + 1; c; } else { a - 1; }"
+           << " { var d = x; { var e = d + a; e; }; };"
+           << " f" << (i + 1) % functionCount << "(a * x, y / 3 - 7); }\n";
+  }
+  return Cygni::Utility::UTF8ToUTF32(stream.str());
+}
+
+int main(int argc, char **argv) {
+  int functionCount = argc > 1 ? std::stoi(argv[1]) : 20000;
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("benchmark");
+  Lexer lexer(sourceCodeFile, GenerateProgram(functionCount));
+  Parser parser(lexer.ReadAll(), sourceCodeFile);
+  std::vector<const LambdaExpression *> functions;
+  while (!parser.IsEof()) {
+    functions.push_back(static_cast<const LambdaExpression *>(
+        parser.FunctionDeclarationStatement()));
+  }
+  std::cout << "functions: " << functions.size() << ", hardware threads: "
+            << std::thread::hardware_concurrency() << std::endl;
+
+  for (int threadCount : {1, 2, 4, 8}) {
+    PerformanceCounter counter;
+    ParallelTypeChecker checker(threadCount);
+    counter.Start();
+    checker.Check(functions);
+    counter.Stop();
+    std::cout << threadCount << " threads: " << counter.Milliseconds()
+              << " ms" << std::endl;
+  }
+
+  return 0;
+}
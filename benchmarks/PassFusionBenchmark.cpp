@@ -0,0 +1,122 @@
+#include <iostream>
+#include <sstream>
+
+#include "LexicalAnalysis/Lexer.hpp"
+#include "PerformanceCounter.hpp"
+#include "SyntaxAnalysis/Parser.hpp"
+#include "Utility/UTF32Functions.hpp"
+#include "Visitors/NameLocator.hpp"
+#include "Visitors/NameResolver.hpp"
+#include "Visitors/PassManager.hpp"
+#include "Visitors/TypeChecker.hpp"
+
+using namespace Cygni::Benchmarks;
+using namespace Cygni::LexicalAnalysis;
+using namespace Cygni::SyntaxAnalysis;
+using namespace Cygni::Expressions;
+using namespace Cygni::Visitors;
+
+std::u32string GenerateProgram(int functionCount) {
+  std::ostringstream stream;
+  for (int i = 0; i < functionCount; i++) {
+    stream << "func f" << i << "(x: Int, y: Int): Int {"
+           << " var a = x + y * " << i << ";"
+           << " { var b = a; while (b < x) { b = b + a * 2 - y; } };"
+           << " if (a == y) { var c = a + 1; c; } else { a - 1; }"
+           << " { var d = x; { var e = d + a; e; }; };"
+           << " a * x + y / 3 - 7; }\n";
+  }
+  return Cygni::Utility::UTF8ToUTF32(stream.str());
+}
+
+void Report(const std::string &name, const PerformanceCounter &counter) {
+  std::cout << name << ": " << counter.Milliseconds() << " ms, ";
+  if (counter.CacheMisses() >= 0) {
+    std::cout << counter.CacheMisses() << " cache misses" << std::endl;
+  } else {
+    std::cout << "cache misses unavailable" << std::endl;
+  }
+}
+
+int main(int argc, char **argv) {
+  int functionCount = argc > 1 ? std::stoi(argv[1]) : 20000;
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("benchmark");
+  Lexer lexer(sourceCodeFile, GenerateProgram(functionCount));
+  Parser parser(lexer.ReadAll(), sourceCodeFile);
+  std::vector<const Expression *> functions;
+  while (!parser.IsEof()) {
+    functions.push_back(parser.FunctionDeclarationStatement());
+  }
+  std::cout << "functions: " << functions.size() << std::endl;
+
+  {
+    PerformanceCounter counter;
+    TypeChecker typeChecker;
+    NameLocator nameLocator;
+    counter.Start();
+    Scope<const Type *> typeScope;
+    for (auto function : functions) {
+      typeChecker.Visit(function, &typeScope);
+    }
+    Scope<NameInfo> nameScope;
+    for (auto function : functions) {
+      nameLocator.Visit(function, &nameScope);
+    }
+    counter.Stop();
+    Report("unfused type checking and name locating", counter);
+  }
+
+  {
+    PerformanceCounter counter;
+    NameResolver nameResolver;
+    TypeChecker typeChecker(&nameResolver.Bindings());
+    NameLocator nameLocator(&nameResolver.Bindings());
+    counter.Start();
+    Scope<const Expression *> resolverScope;
+    for (auto function : functions) {
+      nameResolver.Visit(function, &resolverScope);
+    }
+    Scope<const Type *> typeScope;
+    for (auto function : functions) {
+      typeChecker.Visit(function, &typeScope);
+    }
+    Scope<NameInfo> nameScope;
+    for (auto function : functions) {
+      nameLocator.Visit(function, &nameScope);
+    }
+    counter.Stop();
+    Report("unfused with name resolution", counter);
+  }
+
+  {
+    PerformanceCounter counter;
+    PassManager passManager;
+    counter.Start();
+    for (auto function : functions) {
+      passManager.Run(function);
+    }
+    counter.Stop();
+    Report("fused walk without passes", counter);
+  }
+
+  {
+    PerformanceCounter counter;
+    Scope<const Expression *> scope;
+    NameResolver nameResolver(&scope);
+    TypeChecker typeChecker(&nameResolver.Bindings());
+    NameLocator nameLocator(&nameResolver.Bindings());
+    PassManager passManager;
+    passManager.Add(&nameResolver);
+    passManager.Add(&typeChecker);
+    passManager.Add(&nameLocator);
+    counter.Start();
+    for (auto function : functions) {
+      passManager.Run(function);
+    }
+    counter.Stop();
+    Report("fused name resolution, type checking and name locating", counter);
+  }
+
+  return 0;
+}
@@ -0,0 +1,85 @@
+#ifndef CYGNI_BENCHMARKS_PERFORMANCE_COUNTER_HPP
+#define CYGNI_BENCHMARKS_PERFORMANCE_COUNTER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Cygni {
+namespace Benchmarks {
+
+/* Measures wall time and, where the kernel allows it, hardware cache misses
+ * of the calling thread. CacheMisses() returns -1 when unavailable. */
+class PerformanceCounter {
+private:
+  int fd;
+  std::chrono::steady_clock::time_point start;
+  double milliseconds;
+  int64_t cacheMisses;
+
+public:
+  PerformanceCounter() : fd{-1}, milliseconds{0}, cacheMisses{-1} {
+#if defined(__linux__)
+    perf_event_attr attribute;
+    std::memset(&attribute, 0, sizeof(attribute));
+    attribute.type = PERF_TYPE_HARDWARE;
+    attribute.size = sizeof(attribute);
+    attribute.config = PERF_COUNT_HW_CACHE_MISSES;
+    attribute.disabled = 1;
+    attribute.exclude_kernel = 1;
+    attribute.exclude_hv = 1;
+    fd = static_cast<int>(
+        syscall(__NR_perf_event_open, &attribute, 0, -1, -1, 0));
+#endif
+  }
+  PerformanceCounter(const PerformanceCounter &) = delete;
+  PerformanceCounter &operator=(const PerformanceCounter &) = delete;
+  ~PerformanceCounter() {
+#if defined(__linux__)
+    if (fd != -1) {
+      close(fd);
+    }
+#endif
+  }
+
+  void Start() {
+#if defined(__linux__)
+    if (fd != -1) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    start = std::chrono::steady_clock::now();
+  }
+
+  void Stop() {
+    auto end = std::chrono::steady_clock::now();
+    milliseconds =
+        std::chrono::duration<double, std::milli>(end - start).count();
+#if defined(__linux__)
+    if (fd != -1) {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      int64_t count = 0;
+      if (read(fd, &count, sizeof(count)) == sizeof(count)) {
+        cacheMisses = count;
+      }
+    }
+#endif
+  }
+
+  double Milliseconds() const { return milliseconds; }
+
+  int64_t CacheMisses() const { return cacheMisses; }
+};
+
+}; /* namespace Benchmarks */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_BENCHMARKS_PERFORMANCE_COUNTER_HPP */
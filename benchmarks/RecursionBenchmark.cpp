@@ -0,0 +1,126 @@
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+
+#include "Driver/CompilerDatabase.hpp"
+#include "Interpreter/BytecodeCompiler.hpp"
+#include "Interpreter/ClosureInterpreter.hpp"
+#include "Interpreter/RegisterCompiler.hpp"
+#include "Interpreter/RegisterMachine.hpp"
+#include "Interpreter/VirtualMachine.hpp"
+#include "PerformanceCounter.hpp"
+
+using namespace Cygni::Benchmarks;
+using namespace Cygni::Driver;
+using namespace Cygni::Interpreter;
+
+static uint64_t allocations = 0;
+
+void *operator new(std::size_t size) {
+  allocations++;
+  if (void *pointer = std::malloc(size ? size : 1)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+const char32_t *PROGRAM =
+    U"func fib(n: Int): Int {"
+    U"  if (n < 2) { n; } else { fib(n - 1) + fib(n - 2); }"
+    U"}\n"
+    U"func ack(m: Int, n: Int): Int {"
+    U"  if (m == 0) { n + 1; } else {"
+    U"    if (n == 0) { ack(m - 1, 1); } else { ack(m - 1, ack(m, n - 1)); }"
+    U"  }"
+    U"}\n"
+    U"func countdown(n: Int, steps: Int): Int {"
+    U"  if (n == 0) { steps; } else { countdown(n - 1, steps + 1); }"
+    U"}\n"
+    U"func repeat(k: Int): Int {"
+    U"  var total = 0; var i = 0;"
+    U"  while (i < k) { total = total + countdown(1000, 0); i = i + 1; }"
+    U"  total;"
+    U"}\n";
+
+uint64_t FibCalls(int n) {
+  return n < 2 ? 1 : 1 + FibCalls(n - 1) + FibCalls(n - 2);
+}
+
+uint64_t AckCalls(int m, int n, int &result) {
+  if (m == 0) {
+    result = n + 1;
+    return 1;
+  } else if (n == 0) {
+    return 1 + AckCalls(m - 1, 1, result);
+  } else {
+    uint64_t calls = 1 + AckCalls(m, n - 1, result);
+    return calls + AckCalls(m - 1, result, result);
+  }
+}
+
+void Measure(const std::string &name, uint64_t calls,
+             std::function<Value()> run) {
+  run();
+  uint64_t before = allocations;
+  PerformanceCounter counter;
+  counter.Start();
+  Value result = run();
+  counter.Stop();
+  uint64_t allocated = allocations - before;
+  std::cout << name << ": " << counter.Milliseconds() << " ms ("
+            << result.ToString() << "), " << allocated << " allocations, "
+            << static_cast<double>(allocated) / calls << " per call"
+            << std::endl;
+}
+
+int main() {
+  CompilerDatabase database;
+  database.SetSourceText("benchmark", PROGRAM);
+  ClosureInterpreter closures(&database);
+  BytecodeModule module = BytecodeCompiler(&database).Compile();
+  VirtualMachine machine(&module);
+  RegisterModule registerModule = RegisterCompiler(&database).Compile();
+  RegisterMachine registers(&registerModule);
+
+  int result;
+  uint64_t fibCalls = FibCalls(25);
+  uint64_t ackCalls = AckCalls(2, 500, result);
+  std::vector<Value> fib{Value::Int32(25)};
+  std::vector<Value> ack{Value::Int32(2), Value::Int32(500)};
+  uint64_t repeatCalls = 1000 * 1001 + 1;
+  std::vector<Value> repeat{Value::Int32(1000)};
+  std::cout << "fib(25): " << fibCalls << " calls, ack(2, 500): " << ackCalls
+            << " calls, repeat(1000): " << repeatCalls << " calls"
+            << std::endl;
+
+  Measure("closures fib", fibCalls,
+          [&]() { return closures.Call(U"fib", fib); });
+  Measure("closures ack", ackCalls,
+          [&]() { return closures.Call(U"ack", ack); });
+  Measure("closures repeat", repeatCalls,
+          [&]() { return closures.Call(U"repeat", repeat); });
+  Measure("bytecode fib", fibCalls,
+          [&]() { return machine.Call(U"fib", fib); });
+  Measure("bytecode ack", ackCalls,
+          [&]() { return machine.Call(U"ack", ack); });
+  Measure("bytecode repeat", repeatCalls,
+          [&]() { return machine.Call(U"repeat", repeat); });
+  Measure("registers fib", fibCalls,
+          [&]() { return registers.Call(U"fib", fib); });
+  Measure("registers ack", ackCalls,
+          [&]() { return registers.Call(U"ack", ack); });
+  Measure("registers repeat", repeatCalls,
+          [&]() { return registers.Call(U"repeat", repeat); });
+  /* Only tail calls keep this within the default stack. */
+  Measure("bytecode countdown(10000000)", 10000001, [&]() {
+    return machine.Call(U"countdown",
+                        {Value::Int32(10000000), Value::Int32(0)});
+  });
+  return 0;
+}
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <iostream>
+
+#include "Driver/CompilerDatabase.hpp"
+#include "Interpreter/BytecodeCompiler.hpp"
+#include "Interpreter/VirtualMachine.hpp"
+#include "PerformanceCounter.hpp"
+
+using namespace Cygni::Benchmarks;
+using namespace Cygni::Driver;
+using namespace Cygni::Interpreter;
+
+const char32_t *CORPUS =
+    U"func fib(n: Int): Int {"
+    U"  if (n < 2) { n; } else { fib(n - 1) + fib(n - 2); }"
+    U"}\n"
+    U"func loop(n: Int): Int {"
+    U"  var total = 0; var i = 0;"
+    U"  while (i < n) { total = total + i * 3 - total / 7; i = i + 1; }"
+    U"  total;"
+    U"}\n"
+    U"func nested(n: Int): Int {"
+    U"  var x = 1; var i = 0;"
+    U"  while (i < n) { x = (x * 3 + i * 7 - (x / 3) * 2) / 5 + i; i = i + 1; }"
+    U"  x;"
+    U"}\n"
+    U"func sieve(n: Int): Int {"
+    U"  var count = 0; var i = 2;"
+    U"  while (i < n) {"
+    U"    var prime = true; var j = 2;"
+    U"    while (j * j <= i) {"
+    U"      if (i - (i / j) * j == 0) { prime = false; }"
+    U"      j = j + 1;"
+    U"    }"
+    U"    if (prime) { count = count + 1; }"
+    U"    i = i + 1;"
+    U"  }"
+    U"  count;"
+    U"}\n"
+    U"func collatz(n: Int): Int {"
+    U"  var steps = 0; var i = 1;"
+    U"  while (i < n) {"
+    U"    var x = i;"
+    U"    while (x != 1) {"
+    U"      if (x - (x / 2) * 2 == 0) { x = x / 2; } else { x = 3 * x + 1; }"
+    U"      steps = steps + 1;"
+    U"    }"
+    U"    i = i + 1;"
+    U"  }"
+    U"  steps;"
+    U"}\n"
+    U"func mandel(n: Int): Int {"
+    U"  var inside = 0; var y = 0; var ci = 0.0 - 1.5;"
+    U"  while (y < n) {"
+    U"    var x = 0; var cr = 0.0 - 2.0;"
+    U"    while (x < n) {"
+    U"      var zr = 0.0; var zi = 0.0; var m = 0;"
+    U"      while (m < 50) {"
+    U"        if (zr * zr + zi * zi > 4.0) { m = 100; } else {"
+    U"          var t = zr * zr - zi * zi + cr;"
+    U"          zi = 2.0 * zr * zi + ci; zr = t; m = m + 1;"
+    U"        }"
+    U"      }"
+    U"      if (m == 50) { inside = inside + 1; }"
+    U"      cr = cr + 0.046875; x = x + 1;"
+    U"    }"
+    U"    ci = ci + 0.046875; y = y + 1;"
+    U"  }"
+    U"  inside;"
+    U"}\n";
+
+class Run {
+public:
+  const char32_t *function;
+  int argument;
+};
+
+const Run RUNS[] = {{U"fib", 24},      {U"loop", 1000000},
+                    {U"nested", 1000000}, {U"sieve", 20000},
+                    {U"collatz", 20000},  {U"mandel", 64}};
+
+void Use(VirtualMachine &machine, const std::vector<OpCode> &enabled) {
+  for (const Superinstruction &superinstruction : Superinstructions()) {
+    machine.UseSuperinstruction(
+        superinstruction.opCode,
+        std::find(enabled.begin(), enabled.end(), superinstruction.opCode) !=
+            enabled.end());
+  }
+}
+
+/* The dispatch count of a counted run over the corpus and the best time of
+ * three uncounted ones. */
+std::pair<uint64_t, double> Measure(const BytecodeModule &module,
+                                    const std::vector<OpCode> &enabled) {
+  VirtualMachine counted(&module);
+  Use(counted, enabled);
+  counted.CountInstructions(true);
+  for (const Run &run : RUNS) {
+    counted.Call(run.function, {Value::Int32(run.argument)});
+  }
+  VirtualMachine machine(&module);
+  Use(machine, enabled);
+  double best = 0;
+  for (int i = 0; i < 3; i++) {
+    PerformanceCounter counter;
+    counter.Start();
+    for (const Run &run : RUNS) {
+      machine.Call(run.function, {Value::Int32(run.argument)});
+    }
+    counter.Stop();
+    if (i == 0 || counter.Milliseconds() < best) {
+      best = counter.Milliseconds();
+    }
+  }
+  return {counted.InstructionCount(), best};
+}
+
+int main() {
+  CompilerDatabase database;
+  database.SetSourceText("corpus", CORPUS);
+  BytecodeModule module = BytecodeCompiler(&database).Compile();
+
+  SequenceProfile profile;
+  VirtualMachine machine(&module);
+  Use(machine, {});
+  machine.CountInstructions(true);
+  machine.ProfileSequences(&profile);
+  for (const Run &run : RUNS) {
+    machine.Call(run.function, {Value::Int32(run.argument)});
+  }
+  std::cout << "most frequent sequences:" << std::endl
+            << profile.ToString(6) << std::endl;
+
+  auto baseline = Measure(module, {});
+  std::cout << "no superinstructions: " << baseline.first << " dispatches, "
+            << baseline.second << " ms" << std::endl;
+  std::vector<OpCode> all;
+  for (const Superinstruction &superinstruction : Superinstructions()) {
+    all.push_back(superinstruction.opCode);
+  }
+  for (size_t i = 0; i <= all.size(); i++) {
+    bool alone = i < all.size();
+    auto result = Measure(module, alone ? std::vector<OpCode>{all[i]} : all);
+    std::cout << (alone ? OpCodeName(all[i]) : "all") << ": " << result.first
+              << " dispatches ("
+              << 100.0 * (baseline.first - result.first) / baseline.first
+              << "% fewer), " << result.second << " ms ("
+              << baseline.second / result.second << "x)" << std::endl;
+  }
+  return 0;
+}
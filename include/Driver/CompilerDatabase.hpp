@@ -0,0 +1,283 @@
+#ifndef CYGNI_DRIVER_COMPILER_DATABASE_HPP
+#define CYGNI_DRIVER_COMPILER_DATABASE_HPP
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "LexicalAnalysis/Token.hpp"
+#include "SyntaxAnalysis/Parser.hpp"
+#include "Visitors/NameLocator.hpp"
+#include "Visitors/TypeChecker.hpp"
+
+namespace Cygni {
+namespace Driver {
+
+using Expressions::Expression;
+using Expressions::LambdaExpression;
+using Expressions::Type;
+using LexicalAnalysis::Token;
+
+enum class QueryKind {
+  SourceText,
+  SourceFiles,
+  TokensOfFile,
+  FunctionsOfFile,
+  FunctionIndex,
+  LocationOfFunction,
+  PositionOfFunction,
+  TokensOfFunction,
+  AstOfFunction,
+  SignatureOfFunction,
+  BindingsOfFunction,
+  TypeOfBody,
+  SlotsOfFunction,
+};
+
+class QueryKey {
+public:
+  QueryKind kind;
+  std::u32string argument;
+
+  QueryKey(QueryKind kind, std::u32string argument)
+      : kind{kind}, argument{std::move(argument)} {}
+
+  bool operator==(const QueryKey &other) const {
+    return kind == other.kind && argument == other.argument;
+  }
+};
+
+class QueryKeyHash {
+public:
+  std::size_t operator()(const QueryKey &key) const {
+    return std::hash<std::u32string>()(key.argument) * 31 +
+           static_cast<std::size_t>(key.kind);
+  }
+};
+
+/* Tokens ending with an Eof token, or the message of the lexical error.
+ * Lists compare tags and texts only: a function that merely moves keeps
+ * its tokens, and the queries reading them stay green. */
+class TokenList {
+public:
+  std::vector<Token> tokens;
+  std::string diagnostic;
+
+  bool operator==(const TokenList &other) const;
+};
+
+/* The tokens of a whole file. Unlike a token list these compare source
+ * positions too, so that PositionOfFunction follows a function that
+ * moves. */
+class FileTokens {
+public:
+  TokenList list;
+
+  bool operator==(const FileTokens &other) const;
+};
+
+/* The tokens of one top-level function, from 'func' to its closing brace. */
+class FunctionItem {
+public:
+  std::u32string name;
+  TokenList tokens;
+
+  bool operator==(const FunctionItem &other) const {
+    return name == other.name && tokens == other.tokens;
+  }
+};
+
+/* Where a function is declared; 'number' is its index among all functions
+ * of the module, or -1 if no file declares it. 'duplicate' is the file of
+ * the next declaration of the same name, if there is one. */
+class FunctionLocation {
+public:
+  std::string file;
+  int number;
+  std::string duplicate;
+
+  FunctionLocation() : file(), number{-1}, duplicate() {}
+  FunctionLocation(std::string file, int number)
+      : file{std::move(file)}, number{number}, duplicate() {}
+
+  bool operator==(const FunctionLocation &other) const {
+    return file == other.file && number == other.number &&
+           duplicate == other.duplicate;
+  }
+};
+
+using FunctionIndex = std::unordered_map<std::u32string, FunctionLocation>;
+
+/* The line of a function's 'func' token, counted from 0 as the lexer does,
+ * or -1 if no file declares the function. */
+class SourcePosition {
+public:
+  std::string file;
+  int line;
+
+  SourcePosition() : file(), line{-1} {}
+  SourcePosition(std::string file, int line)
+      : file{std::move(file)}, line{line} {}
+
+  bool operator==(const SourcePosition &other) const {
+    return file == other.file && line == other.line;
+  }
+};
+
+/* A function parsed on its own. The parser owns the nodes. */
+class FunctionAst {
+public:
+  std::shared_ptr<SyntaxAnalysis::Parser> parser;
+  const LambdaExpression *function;
+  std::string diagnostic;
+
+  FunctionAst() : parser(), function{nullptr}, diagnostic() {}
+
+  bool operator==(const FunctionAst &other) const {
+    return function == other.function && diagnostic == other.diagnostic;
+  }
+};
+
+/* What every name of a function is bound to, and the names it uses but
+ * does not declare in order of first use, or the message of the name
+ * resolver's error. Free names are bound to no declaration. */
+class FunctionBindings {
+public:
+  Visitors::BindingTable bindings;
+  std::vector<std::u32string> freeNames;
+  std::string diagnostic;
+
+  bool operator==(const FunctionBindings &other) const;
+};
+
+class BodyTypes {
+public:
+  std::unordered_map<const Expression *, const Type *> nodeTypes;
+  std::string diagnostic;
+
+  bool operator==(const BodyTypes &other) const {
+    return nodeTypes == other.nodeTypes && diagnostic == other.diagnostic;
+  }
+};
+
+/* The frame of a function as the name locator computes it. References to
+ * other functions are located as 'LocationKind::Function' with their
+ * function number. */
+class FunctionSlots {
+public:
+  Visitors::FunctionFrame frame;
+  std::unordered_map<const Expression *, Visitors::NameInfo> nameInfoTable;
+  std::string diagnostic;
+
+  bool operator==(const FunctionSlots &other) const;
+};
+
+/* The compiler as a set of memoized queries over the source texts, which
+ * are its only inputs. Each query records the queries it reads while it
+ * runs. After an edit a query is first revalidated: if none of the queries
+ * it read has changed since it was last verified, its value is kept
+ * (green); otherwise it runs again (red). A query that runs again but
+ * produces an equal value keeps its old revision, so the queries reading it
+ * stay green. This is how a body edit stops at the signature: the interned
+ * signature of the edited function is the same pointer as before.
+ *
+ * Values are kept by the database. A returned reference stays valid until
+ * the next edit. Errors are values too, kept as diagnostics, so a broken
+ * function is not run again until its inputs change. */
+class CompilerDatabase {
+private:
+  class MemoBase {
+  public:
+    bool input;
+    bool hasValue;
+    bool active;
+    int verifiedAt;
+    int changedAt;
+    std::vector<QueryKey> dependencies;
+
+    MemoBase()
+        : input{false}, hasValue{false}, active{false}, verifiedAt{-1},
+          changedAt{-1}, dependencies() {}
+    virtual ~MemoBase() = default;
+  };
+
+  template <typename TValue> class Memo : public MemoBase {
+  public:
+    TValue value;
+  };
+
+  int revision;
+  std::unordered_map<QueryKey, std::unique_ptr<MemoBase>, QueryKeyHash> memos;
+  std::vector<std::vector<QueryKey> *> frames;
+  std::unordered_map<std::string,
+                     std::shared_ptr<LexicalAnalysis::SourceCodeFile>>
+      documents;
+  std::unordered_map<QueryKind, int> executions;
+  Expressions::TypeFactory types;
+
+public:
+  CompilerDatabase();
+  CompilerDatabase(const CompilerDatabase &) = delete;
+  CompilerDatabase &operator=(const CompilerDatabase &) = delete;
+
+  /* Adds a file or replaces its text. */
+  void SetSourceText(const std::string &file, const std::u32string &text);
+  void RemoveSourceFile(const std::string &file);
+
+  int Revision() const { return revision; }
+
+  /* How many times queries of this kind have run, for tests and tools. */
+  int Executions(QueryKind kind) const;
+
+  const std::u32string &SourceText(const std::string &file);
+  const std::vector<std::string> &SourceFiles();
+  const FileTokens &TokensOfFile(const std::string &file);
+  const std::vector<FunctionItem> &FunctionsOfFile(const std::string &file);
+  const FunctionIndex &Functions();
+  const FunctionLocation &LocationOfFunction(const std::u32string &name);
+  /* Where a function is now; no query computing a function's value reads
+   * it, so a function that moves is not compiled again. */
+  const SourcePosition &PositionOfFunction(const std::u32string &name);
+  const TokenList &TokensOfFunction(const std::u32string &name);
+  const FunctionAst &AstOfFunction(const std::u32string &name);
+  /* The callable type of a function, or nullptr if it is not declared or
+   * does not parse. */
+  const Type *SignatureOfFunction(const std::u32string &name);
+  const FunctionBindings &BindingsOfFunction(const std::u32string &name);
+  const BodyTypes &TypeOfBody(const std::u32string &name);
+  const FunctionSlots &SlotsOfFunction(const std::u32string &name);
+
+  /* The first diagnostic of a function, prefixed with the file and line of
+   * its declaration, or an empty string if it has none. A function declared
+   * twice reports the second declaration. */
+  std::string DiagnosticOfFunction(const std::u32string &name);
+
+private:
+  template <typename TValue>
+  void SetInput(const QueryKey &key, const TValue &value);
+  template <typename TValue> const TValue &Input(const QueryKey &key);
+  template <typename TValue, typename TCompute>
+  const TValue &Fetch(const QueryKey &key, TCompute compute);
+  template <typename TValue, typename TCompute>
+  void Execute(Memo<TValue> &memo, const QueryKey &key, TCompute compute);
+  bool TryMarkGreen(MemoBase &memo);
+  void Update(const QueryKey &key);
+  void Record(const QueryKey &key);
+
+  FileTokens ComputeTokensOfFile(const std::string &file);
+  std::vector<FunctionItem> ComputeFunctionsOfFile(const std::string &file);
+  FunctionIndex ComputeFunctions();
+  SourcePosition ComputePositionOfFunction(const std::u32string &name);
+  TokenList ComputeTokensOfFunction(const std::u32string &name);
+  FunctionAst ComputeAstOfFunction(const std::u32string &name);
+  const Type *ComputeSignatureOfFunction(const std::u32string &name);
+  FunctionBindings
+  ComputeBindingsOfFunction(const std::u32string &name);
+  BodyTypes ComputeTypeOfBody(const std::u32string &name);
+  FunctionSlots ComputeSlotsOfFunction(const std::u32string &name);
+};
+
+}; /* namespace Driver */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_DRIVER_COMPILER_DATABASE_HPP */
@@ -0,0 +1,32 @@
+#ifndef CYGNI_EXPRESSIONS_LITERAL_HPP
+#define CYGNI_EXPRESSIONS_LITERAL_HPP
+
+#include <cstdint>
+#include "Expressions/Expression.hpp"
+
+namespace Cygni {
+namespace Expressions {
+
+/* The value of a constant, converted from its text the same way by every
+ * pass. A number that does not fit its type throws a TreeException at the
+ * node. Only string constants keep their text. */
+class Literal {
+public:
+  TypeCode typeCode;
+  union {
+    int32_t int32;
+    int64_t int64;
+    float float32;
+    double float64;
+    bool boolean;
+    char32_t character;
+  };
+  std::u32string text;
+
+  explicit Literal(const ConstantExpression *node);
+};
+
+}; /* namespace Expressions */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_EXPRESSIONS_LITERAL_HPP */
@@ -2,57 +2,79 @@
 #define CYGNI_EXPRESSIONS_NAMESPACE_HPP
 
 #include "Expressions/Expression.hpp"
+#include "Utility/FlatMap.hpp"
 
 namespace Cygni {
 namespace Expressions {
 
+using Utility::FlatMap;
+
 class Namespace;
 
+/* Qualified names join the path from the root with '.'; the root itself has
+ * the empty qualified name. Its hash is computed once at creation. */
 class Namespace {
 private:
   Namespace *parent;
   std::u32string name;
-  std::unordered_map<std::u32string, Namespace *> children;
-  std::unordered_map<std::u32string, ParameterExpression *> globalVariables;
-  std::unordered_map<std::u32string, LambdaExpression *> functions;
+  std::u32string qualifiedName;
+  std::size_t qualifiedNameHash;
+  FlatMap<Namespace *> children;
+  FlatMap<ParameterExpression *> globalVariables;
+  FlatMap<LambdaExpression *> functions;
 
 public:
-  Namespace(Namespace *parent, std::u32string name) : parent{parent}, name{name} {}
+  Namespace(Namespace *parent, std::u32string name);
 
   const Namespace *Parent() { return parent; }
   const std::u32string &Name() const { return name; }
-  std::unordered_map<std::u32string, Namespace *> &Children() { return children; }
-  std::unordered_map<std::u32string, ParameterExpression *> &GlobalVariables() {
-    return globalVariables;
-  }
-  std::unordered_map<std::u32string, LambdaExpression *> &Functions() {
-    return functions;
-  }
+  const std::u32string &QualifiedName() const { return qualifiedName; }
+  std::size_t QualifiedNameHash() const { return qualifiedNameHash; }
+  FlatMap<Namespace *> &Children() { return children; }
+  FlatMap<ParameterExpression *> &GlobalVariables() { return globalVariables; }
+  FlatMap<LambdaExpression *> &Functions() { return functions; }
+
+  /* Appends 'component' to a qualified name, continuing its hash. */
+  static void Qualify(std::u32string &qualifiedName, std::size_t &hash,
+                      const std::u32string &component);
 };
 
+/* Owns the namespaces of one module and indexes them, its functions and its
+ * global variables by fully qualified name, so a lookup of 'a.b.c.f' is a
+ * single probe rather than one per component. The first namespace created
+ * without a parent is the module root. Defining a name twice throws. */
 class NamespaceFactory {
 private:
   std::vector<Namespace *> namespaces;
+  FlatMap<Namespace *> namespaceIndex;
+  FlatMap<LambdaExpression *> functionIndex;
+  FlatMap<ParameterExpression *> globalVariableIndex;
 
 public:
   NamespaceFactory() = default;
+  NamespaceFactory(const NamespaceFactory &) = delete;
+  NamespaceFactory &operator=(const NamespaceFactory &) = delete;
   ~NamespaceFactory() {
     for (auto ns : namespaces) {
       delete ns;
     }
   }
 
-  Namespace *Create(Namespace *parent, const std::u32string &name) {
-    auto ns = new Namespace(parent, name);
-    namespaces.push_back(ns);
-    return ns;
-  }
+  Namespace *Create(Namespace *parent, const std::u32string &name);
 
   void Insert(Namespace* root, const std::vector<std::u32string>& path);
   Namespace* Search(Namespace* root, const std::vector<std::u32string>& path);
+
+  void DefineFunction(Namespace *ns, LambdaExpression *function);
+  void DefineGlobalVariable(Namespace *ns, ParameterExpression *variable);
+  LambdaExpression *SearchFunction(Namespace *root,
+                                   const std::vector<std::u32string> &path);
+  ParameterExpression *
+  SearchGlobalVariable(Namespace *root,
+                       const std::vector<std::u32string> &path);
 };
 
 }; /* namespace Expressions */
 }; /* namespace Cygni */
 
-#endif /* CYGNI_EXPRESSIONS_NAMESPACE_HPP */
\ No newline at end of file
+#endif /* CYGNI_EXPRESSIONS_NAMESPACE_HPP */
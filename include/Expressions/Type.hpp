@@ -1,5 +1,11 @@
 #ifndef CYGNI_EXPRESSIONS_TYPE_HPP
 #define CYGNI_EXPRESSIONS_TYPE_HPP
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace Cygni {
@@ -22,6 +28,7 @@ enum class TypeCode {
 
 class Type {
 public:
+  virtual ~Type() = default;
   virtual TypeCode GetTypeCode() const = 0;
 };
 
@@ -128,12 +135,48 @@ public:
   const std::vector<const Type *> &GetTypes() const { return types; }
 };
 
+/* Interns composite types: creating a type equal in structure to one this
+ * factory made before returns the same pointer, so equal types from one
+ * factory compare equal by address. Types are kept in shards selected by
+ * the hash of their structure, each behind its own reader-writer lock, so
+ * threads interning different types rarely contend and lookups of existing
+ * types only share a lock. Types live as long as the factory. */
 class TypeFactory {
 private:
-  std::vector<Type *> types;
+  class TypeKey {
+  public:
+    TypeCode typeCode;
+    std::vector<const Type *> components;
+
+    bool operator==(const TypeKey &other) const {
+      return typeCode == other.typeCode && components == other.components;
+    }
+  };
+
+  class TypeKeyHash {
+  public:
+    std::size_t operator()(const TypeKey &key) const {
+      std::size_t hash = static_cast<std::size_t>(key.typeCode);
+      for (auto component : key.components) {
+        hash = hash * 31 + std::hash<const Type *>()(component);
+      }
+      return hash;
+    }
+  };
+
+  struct alignas(64) Shard {
+    std::shared_mutex mutex;
+    std::unordered_map<TypeKey, Type *, TypeKeyHash> types;
+  };
+
+  static const int SHARD_COUNT = 16;
+
+  std::array<Shard, SHARD_COUNT> shards;
 
 public:
   TypeFactory() = default;
+  TypeFactory(const TypeFactory &) = delete;
+  TypeFactory &operator=(const TypeFactory &) = delete;
   ~TypeFactory();
 
   static Type *CreateBasicType(TypeCode typeCode);
@@ -151,7 +194,63 @@ private:
   static bool AreUnorderedTypesEqual(const std::vector<const Type *> &a,
                                      const std::vector<const Type *> &b);
 
-  Type *CreateType(Type *type);
+  const Type *InternUnionType(std::vector<const Type *> types);
+  template <typename TType, typename... ArgTypes>
+  TType *Intern(TypeKey key, ArgTypes... arguments);
+};
+
+template <typename TType, typename... ArgTypes>
+TType *TypeFactory::Intern(TypeKey key, ArgTypes... arguments) {
+  Shard &shard = shards[TypeKeyHash()(key) % SHARD_COUNT];
+  {
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.types.find(key);
+    if (it != shard.types.end()) {
+      return static_cast<TType *>(it->second);
+    }
+  }
+  std::unique_lock<std::shared_mutex> lock(shard.mutex);
+  auto result = shard.types.insert({std::move(key), nullptr});
+  if (result.second) {
+    result.first->second = new TType(arguments...);
+  }
+  return static_cast<TType *>(result.first->second);
+}
+
+class TypeRelationCache {
+private:
+  using TypePair = std::pair<const Type *, const Type *>;
+
+  struct TypePairHash {
+    std::size_t operator()(const TypePair &pair) const {
+      std::size_t a = std::hash<const Type *>()(pair.first);
+      std::size_t b = std::hash<const Type *>()(pair.second);
+      return a ^ (b + 0x9e3779b97f4a7c15 + (a << 6) + (a >> 2));
+    }
+  };
+
+  std::unordered_map<TypePair, bool, TypePairHash> equalities;
+  std::unordered_map<TypePair, bool, TypePairHash> assignabilities;
+  std::size_t hits;
+  std::size_t misses;
+
+public:
+  TypeRelationCache() : hits{0}, misses{0} {}
+
+  bool AreTypesEqual(const Type *a, const Type *b);
+  bool IsAssignable(const Type *source, const Type *target);
+
+  std::size_t Hits() const { return hits; }
+  std::size_t Misses() const { return misses; }
+  void Clear();
+
+private:
+  bool ComputeEquality(const Type *a, const Type *b);
+  bool ComputeAssignability(const Type *source, const Type *target);
+  bool AreOrderedTypesEqual(const std::vector<const Type *> &a,
+                            const std::vector<const Type *> &b);
+  bool AreUnorderedTypesEqual(const std::vector<const Type *> &a,
+                              const std::vector<const Type *> &b);
 };
 
 }; /* namespace Expressions */
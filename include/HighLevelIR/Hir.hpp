@@ -0,0 +1,256 @@
+#ifndef CYGNI_HIGH_LEVEL_IR_HIR_HPP
+#define CYGNI_HIGH_LEVEL_IR_HIR_HPP
+
+#include "Expressions/Expression.hpp"
+#include "Visitors/NameLocator.hpp"
+
+namespace Cygni {
+namespace HighLevelIR {
+
+using Expressions::Expression;
+using Expressions::ExpressionType;
+using Expressions::Type;
+using Visitors::NameInfo;
+
+/* The typed, resolved tree produced after type checking. Every node carries
+ * its type, and every variable its declaration and location, inline.
+ *
+ * No back end reads the HIR yet: the interpreters and compilers still walk
+ * the AST and look types and slots up in the database's side tables. */
+class HirNode {
+private:
+  ExpressionType nodeType;
+  const Type *type;
+  const Expression *source;
+
+public:
+  HirNode(ExpressionType nodeType, const Type *type, const Expression *source)
+      : nodeType{nodeType}, type{type}, source{source} {}
+  virtual ~HirNode() = default;
+
+  ExpressionType NodeType() const { return nodeType; }
+
+  const Type *GetType() const { return type; }
+
+  const Expression *Source() const { return source; }
+};
+
+class HirConstant : public HirNode {
+private:
+  std::u32string value;
+
+public:
+  HirConstant(const Type *type, const Expression *source, std::u32string value)
+      : HirNode(ExpressionType::Constant, type, source), value{value} {}
+
+  const std::u32string &Value() const { return value; }
+};
+
+class HirBinary : public HirNode {
+private:
+  const HirNode *left;
+  const HirNode *right;
+
+public:
+  HirBinary(ExpressionType nodeType, const Type *type, const Expression *source,
+            const HirNode *left, const HirNode *right)
+      : HirNode(nodeType, type, source), left{left}, right{right} {}
+
+  const HirNode *Left() const { return left; }
+
+  const HirNode *Right() const { return right; }
+};
+
+class HirUnary : public HirNode {
+private:
+  const HirNode *operand;
+
+public:
+  HirUnary(ExpressionType nodeType, const Type *type, const Expression *source,
+           const HirNode *operand)
+      : HirNode(nodeType, type, source), operand{operand} {}
+
+  const HirNode *Operand() const { return operand; }
+};
+
+class HirVariable : public HirNode {
+private:
+  std::u32string name;
+  const HirNode *declaration;
+  int depth;
+  NameInfo location;
+
+public:
+  /* A lambda parameter, which declares itself. */
+  HirVariable(const Type *type, const Expression *source, std::u32string name,
+              int depth, NameInfo location)
+      : HirNode(ExpressionType::Parameter, type, source), name{name},
+        declaration{this}, depth{depth}, location{location} {}
+
+  HirVariable(const Type *type, const Expression *source, std::u32string name,
+              const HirNode *declaration, int depth, NameInfo location)
+      : HirNode(ExpressionType::Parameter, type, source), name{name},
+        declaration{declaration}, depth{depth}, location{location} {}
+
+  const std::u32string &Name() const { return name; }
+
+  /* The declaring parameter or variable declaration, or nullptr for names
+   * declared outside the lowered tree such as global functions. */
+  const HirNode *Declaration() const { return declaration; }
+
+  int Depth() const { return depth; }
+
+  const NameInfo &Location() const { return location; }
+};
+
+class HirVariableDeclaration : public HirNode {
+private:
+  std::u32string name;
+  const Type *variableType;
+  const HirNode *initializer;
+  int depth;
+  NameInfo location;
+
+public:
+  HirVariableDeclaration(const Type *type, const Expression *source,
+                         std::u32string name, const Type *variableType,
+                         const HirNode *initializer, int depth,
+                         NameInfo location)
+      : HirNode(ExpressionType::VariableDeclaration, type, source), name{name},
+        variableType{variableType}, initializer{initializer}, depth{depth},
+        location{location} {}
+
+  const std::u32string &Name() const { return name; }
+
+  const Type *VariableType() const { return variableType; }
+
+  const HirNode *Initializer() const { return initializer; }
+
+  int Depth() const { return depth; }
+
+  const NameInfo &Location() const { return location; }
+};
+
+class HirBlock : public HirNode {
+private:
+  std::vector<const HirNode *> expressions;
+
+public:
+  HirBlock(const Type *type, const Expression *source,
+           std::vector<const HirNode *> expressions)
+      : HirNode(ExpressionType::Block, type, source), expressions{
+                                                          expressions} {}
+
+  const std::vector<const HirNode *> &Expressions() const {
+    return expressions;
+  }
+};
+
+class HirConditional : public HirNode {
+private:
+  const HirNode *test;
+  const HirNode *ifTrue;
+  const HirNode *ifFalse;
+
+public:
+  HirConditional(const Type *type, const Expression *source,
+                 const HirNode *test, const HirNode *ifTrue,
+                 const HirNode *ifFalse)
+      : HirNode(ExpressionType::Conditional, type, source), test{test},
+        ifTrue{ifTrue}, ifFalse{ifFalse} {}
+
+  const HirNode *Test() const { return test; }
+
+  const HirNode *IfTrue() const { return ifTrue; }
+
+  const HirNode *IfFalse() const { return ifFalse; }
+};
+
+class HirCall : public HirNode {
+private:
+  const HirNode *function;
+  std::vector<const HirNode *> arguments;
+
+public:
+  HirCall(const Type *type, const Expression *source, const HirNode *function,
+          std::vector<const HirNode *> arguments)
+      : HirNode(ExpressionType::Call, type, source), function{function},
+        arguments{arguments} {}
+
+  const HirNode *Function() const { return function; }
+
+  const std::vector<const HirNode *> &Arguments() const { return arguments; }
+};
+
+class HirLambda : public HirNode {
+private:
+  std::u32string name;
+  std::vector<const HirVariable *> parameters;
+  const HirNode *body;
+
+public:
+  HirLambda(const Type *type, const Expression *source, std::u32string name,
+            std::vector<const HirVariable *> parameters, const HirNode *body)
+      : HirNode(ExpressionType::Lambda, type, source), name{name},
+        parameters{parameters}, body{body} {}
+
+  const std::u32string &Name() const { return name; }
+
+  const std::vector<const HirVariable *> &Parameters() const {
+    return parameters;
+  }
+
+  const HirNode *Body() const { return body; }
+};
+
+class HirLoop : public HirNode {
+private:
+  const HirNode *initializer;
+  const HirNode *condition;
+  const HirNode *body;
+
+public:
+  HirLoop(const Type *type, const Expression *source,
+          const HirNode *initializer, const HirNode *condition,
+          const HirNode *body)
+      : HirNode(ExpressionType::Loop, type, source), initializer{initializer},
+        condition{condition}, body{body} {}
+
+  const HirNode *Initializer() const { return initializer; }
+
+  const HirNode *Condition() const { return condition; }
+
+  const HirNode *Body() const { return body; }
+};
+
+class HirDefault : public HirNode {
+public:
+  HirDefault(const Type *type, const Expression *source)
+      : HirNode(ExpressionType::Default, type, source) {}
+};
+
+class HirFactory {
+private:
+  std::vector<HirNode *> nodes;
+
+public:
+  HirFactory() = default;
+  HirFactory(const HirFactory &) = delete;
+  HirFactory &operator=(const HirFactory &) = delete;
+  ~HirFactory() {
+    for (auto node : nodes) {
+      delete node;
+    }
+  }
+  template <typename THirNode, typename... ArgTypes>
+  const THirNode *Create(ArgTypes... arguments) {
+    auto node = new THirNode(arguments...);
+    nodes.push_back(node);
+    return node;
+  }
+};
+
+}; /* namespace HighLevelIR */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_HIGH_LEVEL_IR_HIR_HPP */
@@ -0,0 +1,156 @@
+#ifndef CYGNI_INTERPRETER_ARITHMETIC_HPP
+#define CYGNI_INTERPRETER_ARITHMETIC_HPP
+
+#include <functional>
+#include <type_traits>
+#include "Interpreter/Value.hpp"
+#include "Utility/Exception.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+/* Arithmetic shared by the execution engines. Integers wrap around on
+ * overflow. */
+template <typename T> T Add(T a, T b) {
+  if constexpr (std::is_integral_v<T>) {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<T>(static_cast<U>(a) + static_cast<U>(b));
+  } else {
+    return a + b;
+  }
+}
+template <> inline String Add<String>(String a, String b) {
+  auto result = std::make_shared<std::u32string>();
+  result->reserve(a->size() + b->size());
+  result->append(*a).append(*b);
+  return result;
+}
+
+template <typename T> T Subtract(T a, T b) {
+  if constexpr (std::is_integral_v<T>) {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<T>(static_cast<U>(a) - static_cast<U>(b));
+  } else {
+    return a - b;
+  }
+}
+
+template <typename T> T Multiply(T a, T b) {
+  if constexpr (std::is_integral_v<T>) {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<T>(static_cast<U>(a) * static_cast<U>(b));
+  } else {
+    return a * b;
+  }
+}
+
+/* The caller checks for a zero integer divisor. */
+template <typename T> T Divide(T a, T b) {
+  if constexpr (std::is_integral_v<T>) {
+    if (b == -1) {
+      return Subtract(T(0), a);
+    }
+  }
+  return a / b;
+}
+
+class AddOperation {
+public:
+  template <typename T> T operator()(T a, T b) const { return Add(a, b); }
+};
+
+class SubtractOperation {
+public:
+  template <typename T> T operator()(T a, T b) const { return Subtract(a, b); }
+};
+
+class MultiplyOperation {
+public:
+  template <typename T> T operator()(T a, T b) const { return Multiply(a, b); }
+};
+
+class DivideOperation {
+public:
+  template <typename T> T operator()(T a, T b) const {
+    if constexpr (std::is_integral_v<T>) {
+      if (b == 0) {
+        throw Utility::Exception(__FILE__, __LINE__, "division by zero.",
+                                 nullptr);
+      }
+    }
+    return Divide(a, b);
+  }
+};
+
+/* Operations on tagged values for code that does not know its operand
+ * types. Both operands have the type of 'a'; 'result' may be either of
+ * them. */
+template <typename TOperation>
+inline void Arithmetic(Value &result, const Value &a, const Value &b,
+                       TOperation operation) {
+  switch (a.type) {
+  case TypeCode::Int32:
+    result.int32 = operation(a.int32, b.int32);
+    break;
+  case TypeCode::Int64:
+    result.int64 = operation(a.int64, b.int64);
+    break;
+  case TypeCode::Float32:
+    result.float32 = operation(a.float32, b.float32);
+    break;
+  case TypeCode::Float64:
+    result.float64 = operation(a.float64, b.float64);
+    break;
+  case TypeCode::String:
+    if constexpr (std::is_same_v<TOperation, AddOperation>) {
+      result.string = Add(a.string, b.string);
+      break;
+    }
+    [[fallthrough]];
+  default:
+    throw Utility::Exception(
+        __FILE__, __LINE__,
+        "The operator is not supported by the interpreter.", nullptr);
+  }
+  result.type = a.type;
+}
+
+template <typename TComparison>
+inline void Compare(Value &result, const Value &a, const Value &b,
+                    TComparison comparison) {
+  bool value;
+  switch (a.type) {
+  case TypeCode::Int32:
+    value = comparison(a.int32, b.int32);
+    break;
+  case TypeCode::Int64:
+    value = comparison(a.int64, b.int64);
+    break;
+  case TypeCode::Float32:
+    value = comparison(a.float32, b.float32);
+    break;
+  case TypeCode::Float64:
+    value = comparison(a.float64, b.float64);
+    break;
+  case TypeCode::Boolean:
+    value = comparison(a.boolean, b.boolean);
+    break;
+  case TypeCode::Char:
+    value = comparison(a.character, b.character);
+    break;
+  case TypeCode::String:
+    value = comparison(*a.string, *b.string);
+    break;
+  default:
+    throw Utility::Exception(
+        __FILE__, __LINE__,
+        "The operator is not supported by the interpreter.", nullptr);
+  }
+  result.type = TypeCode::Boolean;
+  result.boolean = value;
+}
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_INTERPRETER_ARITHMETIC_HPP */
@@ -0,0 +1,236 @@
+#ifndef CYGNI_INTERPRETER_BYTECODE_HPP
+#define CYGNI_INTERPRETER_BYTECODE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Interpreter/Value.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+/* One byte per opcode. Operands written as 'u' are unsigned LEB128 varints,
+ * so slots, constants and functions below 128 take one byte; jump offsets
+ * are 4-byte little-endian signed offsets from the end of the instruction,
+ * which keeps forward jumps patchable. The comments give the operands and
+ * the stack effect. */
+enum class OpCode : uint8_t {
+  PushConstant,       /* u constant        -> value */
+  PushString,         /* u module string   -> value */
+  PushDefault,        /* u type code       -> value */
+  PushFunction,       /* u function        -> value */
+  LoadLocal,          /* u slot            -> value */
+  StoreLocal,         /* u slot      value ->       */
+  LoadGlobal,         /* u global          -> value */
+  StoreGlobal,        /* u global    value ->       */
+  Pop,                /*             value ->       */
+  Add,                /*           a, b    -> a + b */
+  Subtract,           /*           a, b    -> a - b */
+  Multiply,           /*           a, b    -> a * b */
+  Divide,             /*           a, b    -> a / b */
+  Equal,              /*           a, b    -> a == b */
+  NotEqual,           /*           a, b    -> a != b */
+  LessThan,           /*           a, b    -> a < b */
+  LessThanOrEqual,    /*           a, b    -> a <= b */
+  GreaterThan,        /*           a, b    -> a > b */
+  GreaterThanOrEqual, /*           a, b    -> a >= b */
+  Not,                /*             value -> !value */
+  Jump,               /* offset            ->       */
+  JumpIfFalse,        /* offset  condition ->       */
+  Call,               /* u function  arguments -> result */
+  CallIndirect,       /* u count  function, arguments -> result */
+  TailCall,           /* u function  arguments -> (returns) */
+  Return,             /*            result ->       */
+  /* The operators specialized for operands of a numeric type, which are
+   * used whenever the type checker has proven it. They check no tags. */
+  AddInt32,
+  SubtractInt32,
+  MultiplyInt32,
+  DivideInt32,
+  EqualInt32,
+  NotEqualInt32,
+  LessThanInt32,
+  LessThanOrEqualInt32,
+  GreaterThanInt32,
+  GreaterThanOrEqualInt32,
+  AddInt64,
+  SubtractInt64,
+  MultiplyInt64,
+  DivideInt64,
+  EqualInt64,
+  NotEqualInt64,
+  LessThanInt64,
+  LessThanOrEqualInt64,
+  GreaterThanInt64,
+  GreaterThanOrEqualInt64,
+  AddFloat32,
+  SubtractFloat32,
+  MultiplyFloat32,
+  DivideFloat32,
+  EqualFloat32,
+  NotEqualFloat32,
+  LessThanFloat32,
+  LessThanOrEqualFloat32,
+  GreaterThanFloat32,
+  GreaterThanOrEqualFloat32,
+  AddFloat64,
+  SubtractFloat64,
+  MultiplyFloat64,
+  DivideFloat64,
+  EqualFloat64,
+  NotEqualFloat64,
+  LessThanFloat64,
+  LessThanOrEqualFloat64,
+  GreaterThanFloat64,
+  GreaterThanOrEqualFloat64,
+  /* Quickened forms of the generic operators. The machine writes one over
+   * a generic operator after it has seen its operand types; it checks the
+   * tags and writes the generic operator back when they differ. */
+  QuickAddInt32,
+  QuickSubtractInt32,
+  QuickMultiplyInt32,
+  QuickDivideInt32,
+  QuickEqualInt32,
+  QuickNotEqualInt32,
+  QuickLessThanInt32,
+  QuickLessThanOrEqualInt32,
+  QuickGreaterThanInt32,
+  QuickGreaterThanOrEqualInt32,
+  QuickAddInt64,
+  QuickSubtractInt64,
+  QuickMultiplyInt64,
+  QuickDivideInt64,
+  QuickEqualInt64,
+  QuickNotEqualInt64,
+  QuickLessThanInt64,
+  QuickLessThanOrEqualInt64,
+  QuickGreaterThanInt64,
+  QuickGreaterThanOrEqualInt64,
+  QuickAddFloat32,
+  QuickSubtractFloat32,
+  QuickMultiplyFloat32,
+  QuickDivideFloat32,
+  QuickEqualFloat32,
+  QuickNotEqualFloat32,
+  QuickLessThanFloat32,
+  QuickLessThanOrEqualFloat32,
+  QuickGreaterThanFloat32,
+  QuickGreaterThanOrEqualFloat32,
+  QuickAddFloat64,
+  QuickSubtractFloat64,
+  QuickMultiplyFloat64,
+  QuickDivideFloat64,
+  QuickEqualFloat64,
+  QuickNotEqualFloat64,
+  QuickLessThanFloat64,
+  QuickLessThanOrEqualFloat64,
+  QuickGreaterThanFloat64,
+  QuickGreaterThanOrEqualFloat64,
+  /* Superinstructions, fused by the machine from the sequences listed in
+   * Superinstructions(). Their operands are those of the sequence. */
+  IncrementLocalInt32,
+  JumpIfNotLessLocalInt32,
+  JumpIfNotLessConstantInt32,
+  LoadLocalLoadLocal,
+  LoadLocalPushConstant,
+  StoreLocalJump,
+  OpCodeCount
+};
+
+const char *OpCodeName(OpCode opCode);
+
+/* The operator 'generic' specialized for operands of 'typeCode', or
+ * 'generic' itself if it has no such form. */
+OpCode SpecializedOpCode(OpCode generic, TypeCode typeCode);
+OpCode QuickenedOpCode(OpCode generic, TypeCode typeCode);
+/* The generic operator of a specialized or quickened one. */
+OpCode GenericOpCode(OpCode typed);
+
+class Superinstruction {
+public:
+  OpCode opCode;
+  std::vector<OpCode> sequence;
+};
+
+/* The sequences worth fusing, chosen from a SequenceProfile of the
+ * benchmarks; longer sequences come first. */
+const std::vector<Superinstruction> &Superinstructions();
+
+inline void WriteOperand(std::vector<uint8_t> &code, uint32_t operand) {
+  while (operand >= 0x80) {
+    code.push_back(static_cast<uint8_t>(operand | 0x80));
+    operand >>= 7;
+  }
+  code.push_back(static_cast<uint8_t>(operand));
+}
+
+inline uint32_t ReadOperand(const uint8_t *&ip) {
+  uint32_t operand = *ip++;
+  if (operand < 0x80) {
+    return operand;
+  }
+  operand &= 0x7F;
+  int shift = 7;
+  uint8_t byte;
+  do {
+    byte = *ip++;
+    operand |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  return operand;
+}
+
+inline int32_t ReadOffset(const uint8_t *&ip) {
+  int32_t offset;
+  std::memcpy(&offset, ip, sizeof(offset));
+  ip += sizeof(offset);
+  return offset;
+}
+
+/* The locals of a function are its first 'frameSize' stack slots, starting
+ * with the parameters; its operands never take more than 'maxStack' slots
+ * above them. */
+class BytecodeFunction {
+public:
+  std::u32string name;
+  int parameterCount;
+  int frameSize;
+  int maxStack;
+  std::vector<TypeCode> parameterTypes;
+  TypeCode returnType;
+  std::vector<Value> constants;
+  std::vector<uint8_t> code;
+
+  BytecodeFunction()
+      : name(), parameterCount{0}, frameSize{0}, maxStack{0},
+        parameterTypes(), returnType{TypeCode::Empty}, constants(), code() {}
+};
+
+/* Functions are numbered as in the compiler database. */
+class BytecodeModule {
+public:
+  std::vector<BytecodeFunction> functions;
+  std::vector<Value> strings;
+  std::vector<Value> globals;
+  std::unordered_map<std::u32string, int> functionNumbers;
+};
+
+/* An instruction of bytecode with its operand decoded; a jump's operand is
+ * its target offset. */
+class DecodedInstruction {
+public:
+  OpCode opCode;
+  size_t offset;
+  uint32_t operand;
+};
+
+std::vector<DecodedInstruction> Decode(const BytecodeFunction &function);
+
+std::string Disassemble(const BytecodeFunction &function);
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_INTERPRETER_BYTECODE_HPP */
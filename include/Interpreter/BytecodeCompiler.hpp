@@ -0,0 +1,72 @@
+#ifndef CYGNI_INTERPRETER_BYTECODE_COMPILER_HPP
+#define CYGNI_INTERPRETER_BYTECODE_COMPILER_HPP
+
+#include <unordered_set>
+#include "Driver/CompilerDatabase.hpp"
+#include "Interpreter/Bytecode.hpp"
+#include "Visitors/Visitor.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+using namespace Expressions;
+
+/* Lowers type checked functions to stack bytecode. Every expression leaves
+ * one value on the operand stack, except expressions of type Empty, which
+ * leave none. Variables and constants keep the slot and constant numbers of
+ * the name locator; string literals go to the module's string pool.
+ *
+ * A call to a named function whose value is returned as it is becomes a
+ * TailCall, which runs the callee in the caller's frame. */
+class BytecodeCompiler : private Visitors::ExpressionVisitor<void> {
+private:
+  Driver::CompilerDatabase *database;
+  BytecodeModule module;
+  std::vector<const LambdaExpression *> lambdas;
+  std::unordered_map<std::u32string, int> stringNumbers;
+  BytecodeFunction *function;
+  const Driver::BodyTypes *bodyTypes;
+  const Driver::FunctionSlots *slots;
+  int stackDepth;
+  std::unordered_set<const CallExpression *> tailCalls;
+
+public:
+  explicit BytecodeCompiler(Driver::CompilerDatabase *database);
+
+  /* Throws the first diagnostic of any function. */
+  BytecodeModule Compile();
+
+private:
+  void VisitBinary(const BinaryExpression *node) override;
+  void VisitConstant(const ConstantExpression *node) override;
+  void VisitParameter(const ParameterExpression *node) override;
+  void VisitBlock(const BlockExpression *node) override;
+  void VisitConditional(const ConditionalExpression *node) override;
+  void VisitUnary(const UnaryExpression *node) override;
+  void VisitCall(const CallExpression *node) override;
+  void VisitLambda(const LambdaExpression *node) override;
+  void VisitLoop(const LoopExpression *node) override;
+  void VisitDefault(const DefaultExpression *node) override;
+  void VisitVariableDeclaration(
+      const VariableDeclarationExpression *node) override;
+
+  void CompileFunction(const std::u32string &name, int number);
+  const Type *TypeOf(const Expression *node) const;
+  const Visitors::NameInfo &Locate(const Expression *node) const;
+  void Assign(const BinaryExpression *node);
+  void Coerce(const Expression *node, const Type *from, const Type *to);
+  bool CoercesFreely(const Type *from, const Type *to) const;
+  void FindTailCalls(const Expression *node, const Type *type);
+  void Store(const Expression *node, const Visitors::NameInfo &nameInfo);
+
+  void Emit(OpCode opCode, int stackEffect);
+  void Emit(OpCode opCode, uint32_t operand, int stackEffect);
+  size_t EmitJump(OpCode opCode, int stackEffect);
+  void PatchJump(size_t jump);
+  void EmitJumpBack(size_t target);
+};
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_INTERPRETER_BYTECODE_COMPILER_HPP */
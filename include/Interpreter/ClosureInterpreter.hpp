@@ -0,0 +1,110 @@
+#ifndef CYGNI_INTERPRETER_CLOSURE_INTERPRETER_HPP
+#define CYGNI_INTERPRETER_CLOSURE_INTERPRETER_HPP
+
+#include <any>
+#include <functional>
+#include <memory>
+#include "Driver/CompilerDatabase.hpp"
+#include "Interpreter/Value.hpp"
+#include "Visitors/Visitor.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+using namespace Expressions;
+
+/* Compiled code of an expression producing a 'T' from the slots of the
+ * running function's frame. */
+template <typename T> using Closure = std::function<T(Value *)>;
+
+/* A compiled expression: 'closure' holds a 'Closure<T>' where 'T' is the
+ * C++ representation of 'type' (void for Empty, 'Value' for unions). */
+class Code {
+public:
+  const Type *type;
+  std::any closure;
+
+  Code() : type{nullptr}, closure() {}
+  Code(const Type *type, std::any closure)
+      : type{type}, closure{std::move(closure)} {}
+};
+
+/* 'body' holds a 'Closure<T>' for the return type. It is created before any
+ * body is compiled, so call sites can keep a pointer to it. */
+class CompiledFunction {
+public:
+  const LambdaExpression *lambda;
+  int frameSize;
+  const Type *returnType;
+  std::any body;
+  Closure<Value> entry;
+
+  CompiledFunction()
+      : lambda{nullptr}, frameSize{0}, returnType{nullptr}, body(), entry() {}
+};
+
+/* Compiles type checked functions into trees of C++ closures and runs them.
+ * Compilation resolves everything the tree walk would otherwise repeat:
+ * variables become frame slots from the name locator, calls hold their
+ * callee, and every operator is a closure specialized for the operand
+ * types from the type checker. Running code does no per-node dispatch,
+ * name lookup or type test.
+ *
+ * Frames are bumped off one contiguous stack allocated up front: a call
+ * claims 'frameSize' slots above the caller's, its arguments are written
+ * straight into them, and it hands them back on return. Calls recurse on
+ * the native stack, so their depth is bounded as well as their frames. */
+class ClosureInterpreter : private Visitors::ExpressionVisitor<Code> {
+private:
+  Driver::CompilerDatabase *database;
+  std::vector<std::unique_ptr<CompiledFunction>> functions;
+  std::unordered_map<std::u32string, CompiledFunction *> functionsByName;
+  const Driver::BodyTypes *bodyTypes;
+  const Driver::FunctionSlots *slots;
+  std::unique_ptr<Value[]> stack;
+  Value *stackEnd;
+  Value *stackTop;
+  size_t callDepth;
+  size_t maxCallDepth;
+
+public:
+  static constexpr size_t DefaultStackSize = 1 << 18;
+  static constexpr size_t DefaultMaxCallDepth = 1 << 12;
+
+  /* Compiles every function of the database. Throws the first diagnostic
+   * of any function. */
+  explicit ClosureInterpreter(Driver::CompilerDatabase *database,
+                              size_t stackSize = DefaultStackSize,
+                              size_t maxCallDepth = DefaultMaxCallDepth);
+  ClosureInterpreter(const ClosureInterpreter &) = delete;
+  ClosureInterpreter &operator=(const ClosureInterpreter &) = delete;
+
+  Value Call(const std::u32string &name, const std::vector<Value> &arguments);
+
+private:
+  Code VisitBinary(const BinaryExpression *node) override;
+  Code VisitConstant(const ConstantExpression *node) override;
+  Code VisitParameter(const ParameterExpression *node) override;
+  Code VisitBlock(const BlockExpression *node) override;
+  Code VisitConditional(const ConditionalExpression *node) override;
+  Code VisitUnary(const UnaryExpression *node) override;
+  Code VisitCall(const CallExpression *node) override;
+  Code VisitLambda(const LambdaExpression *node) override;
+  Code VisitLoop(const LoopExpression *node) override;
+  Code VisitDefault(const DefaultExpression *node) override;
+  Code VisitVariableDeclaration(
+      const VariableDeclarationExpression *node) override;
+
+  void CompileFunction(CompiledFunction *function);
+  const Type *TypeOf(const Expression *node) const;
+  const Visitors::NameInfo &Locate(const Expression *node) const;
+  Code Assign(const BinaryExpression *node);
+  Code Operator(const BinaryExpression *node, ExpressionType operation,
+                Code left, Code right);
+  Code Coerce(const Expression *node, Code code, const Type *type);
+};
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_INTERPRETER_CLOSURE_INTERPRETER_HPP */
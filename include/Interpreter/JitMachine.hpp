@@ -0,0 +1,140 @@
+#ifndef CYGNI_INTERPRETER_JIT_MACHINE_HPP
+#define CYGNI_INTERPRETER_JIT_MACHINE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include "Interpreter/VirtualMachine.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+/* The state compiled code shares with the runtime. Compiled code never
+ * throws: a runtime function that fails records its message here and
+ * returns nonzero, and every frame returns that status to the caller. */
+class JitContext {
+public:
+  Value *stackEnd;
+  int32_t callDepth;
+  int32_t maxCallDepth;
+  std::string error;
+
+  JitContext() : stackEnd{nullptr}, callDepth{0}, maxCallDepth{0}, error() {}
+};
+
+/* A compiled function takes the base of its frame, where its arguments
+ * are, and leaves its result there. */
+using JitEntry = int (*)(Value *base, JitContext *context);
+
+/* When the interpreter hands a function to the JIT. */
+class TierThresholds {
+public:
+  uint32_t invocations;
+  uint32_t backEdges;
+
+  explicit TierThresholds(uint32_t invocations = 1000,
+                          uint32_t backEdges = 10000)
+      : invocations{invocations}, backEdges{backEdges} {}
+};
+
+/* Runs a bytecode module with the functions it can compile translated to
+ * x86-64 machine code, one pre-assembled template per instruction, and the
+ * others on a VirtualMachine.
+ *
+ * A function is compiled when everything it touches is a scalar and all
+ * the functions it calls are compiled too, so compiled code never calls
+ * back into the machine. Integer and floating-point operators are inlined;
+ * the rest and all errors call into the runtime. Frames are laid out as in
+ * the machine.
+ *
+ * By default everything is compiled up front. Given thresholds, the
+ * machine instead interprets every function until it gets hot, and a
+ * background thread compiles it, with the callees that have no code yet,
+ * while the machine keeps interpreting; compiled code then runs on the
+ * machine's stack, and a call caught in a hot loop moves over to it at the
+ * loop header. Every tiering decision is logged.
+ *
+ * Only x86-64 Linux built with CYGNI_JIT compiles anything; elsewhere
+ * every call runs on the machine. */
+class JitMachine : private NativeTier {
+private:
+  const BytecodeModule *module;
+  VirtualMachine machine;
+  std::unique_ptr<Value[]> stack;
+  JitContext context;
+  std::vector<bool> compilable;
+  std::vector<std::vector<DecodedInstruction>> decoded;
+  /* Written by the compiling thread only, and published through 'entries'
+   * once the code is executable. */
+  std::vector<uint8_t *> starts;
+  std::vector<uint8_t *> tailEntries;
+  std::vector<std::vector<std::pair<uint32_t, JitEntry>>> loopEntries;
+  std::vector<std::pair<void *, size_t>> blocks;
+  std::vector<std::atomic<JitEntry>> entries;
+  std::atomic<size_t> codeSize;
+
+  bool tiered;
+  bool synchronous;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable idle;
+  std::deque<int> queue;
+  std::vector<bool> requested;
+  bool compiling;
+  bool stopping;
+  std::vector<std::string> log;
+  std::ostream *logStream;
+  std::thread compiler;
+
+public:
+  explicit JitMachine(
+      const BytecodeModule *module,
+      size_t stackSize = VirtualMachine::DefaultStackSize,
+      size_t maxCallDepth = VirtualMachine::DefaultMaxCallDepth);
+  JitMachine(const BytecodeModule *module, TierThresholds thresholds,
+             size_t stackSize = VirtualMachine::DefaultStackSize,
+             size_t maxCallDepth = VirtualMachine::DefaultMaxCallDepth);
+  JitMachine(const JitMachine &) = delete;
+  JitMachine &operator=(const JitMachine &) = delete;
+  ~JitMachine() override;
+
+  static bool IsSupported();
+
+  Value Call(const std::u32string &name, const std::vector<Value> &arguments);
+
+  bool IsCompiled(const std::u32string &name) const;
+  size_t CodeSize() const { return codeSize.load(); }
+
+  /* Blocks until the background thread has compiled everything queued. */
+  void WaitForCompilation();
+  /* Makes a hot function wait for its compilation, so that it moves to
+   * native code at the same point on every run, as tests need. */
+  void CompileSynchronously(bool enabled) { synchronous = enabled; }
+
+  /* The tiering decisions so far, oldest first. Each is also written to
+   * 'stream', if it is not null, as it is made. */
+  std::vector<std::string> TierLog();
+  void LogTiering(std::ostream *stream);
+
+private:
+  bool Hot(int function, uint32_t invocations, uint32_t backEdges) override;
+  bool IsReady(int function) override;
+  void Run(int function, Value *base, Value *stackEnd,
+           size_t callDepth) override;
+  bool Enter(int function, uint32_t offset, Value *base, Value *stackEnd,
+             size_t callDepth) override;
+
+  void Analyze();
+  void CompileUnit(const std::vector<int> &roots);
+  void CompileQueued();
+  void Log(const std::string &message);
+};
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_INTERPRETER_JIT_MACHINE_HPP */
@@ -0,0 +1,108 @@
+#ifndef CYGNI_INTERPRETER_REGISTER_CODE_HPP
+#define CYGNI_INTERPRETER_REGISTER_CODE_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Interpreter/Value.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+/* Three-address instructions over the registers of the running function.
+ * 'R' is a register, 'K' a constant of the function. The '...Constant'
+ * forms take their right operand from the constants, which covers the
+ * literal operands of most binary expressions without a load. */
+enum class RegisterOpCode : uint8_t {
+  Move,                       /* R[a] = R[b] */
+  LoadConstant,               /* R[a] = K[b] */
+  LoadString,                 /* R[a] = module string b */
+  LoadDefault,                /* R[a] = default value of type code b */
+  LoadGlobal,                 /* R[a] = global b */
+  StoreGlobal,                /* global a = R[b] */
+  Add,                        /* R[a] = R[b] + R[c] */
+  Subtract,                   /* R[a] = R[b] - R[c] */
+  Multiply,                   /* R[a] = R[b] * R[c] */
+  Divide,                     /* R[a] = R[b] / R[c] */
+  Equal,                      /* R[a] = R[b] == R[c] */
+  NotEqual,                   /* R[a] = R[b] != R[c] */
+  LessThan,                   /* R[a] = R[b] < R[c] */
+  LessThanOrEqual,            /* R[a] = R[b] <= R[c] */
+  GreaterThan,                /* R[a] = R[b] > R[c] */
+  GreaterThanOrEqual,         /* R[a] = R[b] >= R[c] */
+  AddConstant,                /* R[a] = R[b] + K[c] */
+  SubtractConstant,           /* R[a] = R[b] - K[c] */
+  MultiplyConstant,           /* R[a] = R[b] * K[c] */
+  DivideConstant,             /* R[a] = R[b] / K[c] */
+  EqualConstant,              /* R[a] = R[b] == K[c] */
+  NotEqualConstant,           /* R[a] = R[b] != K[c] */
+  LessThanConstant,           /* R[a] = R[b] < K[c] */
+  LessThanOrEqualConstant,    /* R[a] = R[b] <= K[c] */
+  GreaterThanConstant,        /* R[a] = R[b] > K[c] */
+  GreaterThanOrEqualConstant, /* R[a] = R[b] >= K[c] */
+  Not,                        /* R[a] = !R[b] */
+  Jump,                       /* go to Target() */
+  JumpIfFalse,                /* if !R[a] go to Target() */
+  Call,                       /* R[a] = function b(R[a], R[a + 1], ...) */
+  Return,                     /* return R[a] */
+  OpCodeCount
+};
+
+const char *RegisterOpCodeName(RegisterOpCode opCode);
+
+/* Jumps keep their target instruction index in 'b' and 'c'. */
+class RegisterInstruction {
+public:
+  RegisterOpCode opCode;
+  uint16_t a;
+  uint16_t b;
+  uint16_t c;
+
+  RegisterInstruction(RegisterOpCode opCode, uint16_t a, uint16_t b,
+                      uint16_t c)
+      : opCode{opCode}, a{a}, b{b}, c{c} {}
+
+  uint32_t Target() const {
+    return static_cast<uint32_t>(b) | (static_cast<uint32_t>(c) << 16);
+  }
+
+  void SetTarget(uint32_t target) {
+    b = static_cast<uint16_t>(target);
+    c = static_cast<uint16_t>(target >> 16);
+  }
+};
+
+/* Registers [0, frameSize) are the slots of the name locator, parameters
+ * first; the temporaries of expressions follow up to 'registerCount'. */
+class RegisterFunction {
+public:
+  std::u32string name;
+  int parameterCount;
+  int frameSize;
+  int registerCount;
+  std::vector<TypeCode> parameterTypes;
+  TypeCode returnType;
+  std::vector<Value> constants;
+  std::vector<RegisterInstruction> code;
+
+  RegisterFunction()
+      : name(), parameterCount{0}, frameSize{0}, registerCount{0},
+        parameterTypes(), returnType{TypeCode::Empty}, constants(), code() {}
+};
+
+/* Functions are numbered as in the compiler database. */
+class RegisterModule {
+public:
+  std::vector<RegisterFunction> functions;
+  std::vector<Value> strings;
+  std::vector<Value> globals;
+  std::unordered_map<std::u32string, int> functionNumbers;
+};
+
+std::string Disassemble(const RegisterFunction &function);
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_INTERPRETER_REGISTER_CODE_HPP */
@@ -0,0 +1,72 @@
+#ifndef CYGNI_INTERPRETER_REGISTER_COMPILER_HPP
+#define CYGNI_INTERPRETER_REGISTER_COMPILER_HPP
+
+#include "Driver/CompilerDatabase.hpp"
+#include "Interpreter/RegisterCode.hpp"
+#include "Visitors/Visitor.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+using namespace Expressions;
+
+/* Lowers type checked functions to three-address register code. Visiting
+ * an expression takes the register its value should end up in, or
+ * 'AnyRegister', and returns the register holding the value (none for
+ * Empty). Variables are read where they live, so operands need no loads,
+ * and the innermost operation of an assignment writes the variable itself.
+ * Temporaries are allocated like a stack above the variables and released
+ * at the end of each statement. */
+class RegisterCompiler : private Visitors::ExpressionVisitor<int, int> {
+private:
+  Driver::CompilerDatabase *database;
+  RegisterModule module;
+  std::vector<const LambdaExpression *> lambdas;
+  std::unordered_map<std::u32string, int> stringNumbers;
+  RegisterFunction *function;
+  const Driver::BodyTypes *bodyTypes;
+  const Driver::FunctionSlots *slots;
+  int temporaryTop;
+
+public:
+  static constexpr int AnyRegister = -1;
+  static constexpr int NoRegister = -1;
+
+  explicit RegisterCompiler(Driver::CompilerDatabase *database);
+
+  /* Throws the first diagnostic of any function. */
+  RegisterModule Compile();
+
+private:
+  int VisitBinary(const BinaryExpression *node, int target) override;
+  int VisitConstant(const ConstantExpression *node, int target) override;
+  int VisitParameter(const ParameterExpression *node, int target) override;
+  int VisitBlock(const BlockExpression *node, int target) override;
+  int VisitConditional(const ConditionalExpression *node,
+                       int target) override;
+  int VisitUnary(const UnaryExpression *node, int target) override;
+  int VisitCall(const CallExpression *node, int target) override;
+  int VisitLambda(const LambdaExpression *node, int target) override;
+  int VisitLoop(const LoopExpression *node, int target) override;
+  int VisitDefault(const DefaultExpression *node, int target) override;
+  int VisitVariableDeclaration(const VariableDeclarationExpression *node,
+                               int target) override;
+
+  void CompileFunction(const std::u32string &name, int number);
+  int Compile(const Expression *node, int target);
+  int Compile(const Expression *node, int target, const Type *type);
+  const Type *TypeOf(const Expression *node) const;
+  const Visitors::NameInfo &Locate(const Expression *node) const;
+  int Assign(const BinaryExpression *node);
+  int StringNumber(const ConstantExpression *node);
+  bool IsVariable(int reg) const;
+  int Allocate();
+  int Destination(int target);
+  void Release(int mark, int result);
+  void Emit(RegisterOpCode opCode, int a, int b, int c);
+};
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_INTERPRETER_REGISTER_COMPILER_HPP */
@@ -0,0 +1,55 @@
+#ifndef CYGNI_INTERPRETER_REGISTER_MACHINE_HPP
+#define CYGNI_INTERPRETER_REGISTER_MACHINE_HPP
+
+#include <memory>
+#include "Interpreter/RegisterCode.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+/* The caller's state saved by a call. */
+class RegisterFrame {
+public:
+  const RegisterFunction *function;
+  const RegisterInstruction *returnAddress;
+  Value *base;
+};
+
+/* Runs register code on one contiguous stack of registers. The registers
+ * of a call start at the caller's argument registers; a call checks once
+ * that all of them fit. */
+class RegisterMachine {
+private:
+  const RegisterModule *module;
+  std::unique_ptr<Value[]> stack;
+  Value *stackEnd;
+  std::vector<Value> globals;
+  std::vector<RegisterFrame> frames;
+  size_t maxCallDepth;
+  bool counting;
+  uint64_t instructionCount;
+
+public:
+  static constexpr size_t DefaultStackSize = 1 << 18;
+  static constexpr size_t DefaultMaxCallDepth = 1 << 16;
+
+  explicit RegisterMachine(const RegisterModule *module,
+                           size_t stackSize = DefaultStackSize,
+                           size_t maxCallDepth = DefaultMaxCallDepth);
+  RegisterMachine(const RegisterMachine &) = delete;
+  RegisterMachine &operator=(const RegisterMachine &) = delete;
+
+  Value Call(const std::u32string &name, const std::vector<Value> &arguments);
+
+  void CountInstructions(bool enabled) { counting = enabled; }
+  uint64_t InstructionCount() const { return instructionCount; }
+
+private:
+  template <bool Counting>
+  Value Run(const RegisterFunction *function, Value *base);
+};
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_INTERPRETER_REGISTER_MACHINE_HPP */
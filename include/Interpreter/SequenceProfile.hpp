@@ -0,0 +1,51 @@
+#ifndef CYGNI_INTERPRETER_SEQUENCE_PROFILE_HPP
+#define CYGNI_INTERPRETER_SEQUENCE_PROFILE_HPP
+
+#include <unordered_map>
+#include "Interpreter/Bytecode.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+class OpCodeSequence {
+public:
+  std::vector<OpCode> opCodes;
+  uint64_t count;
+};
+
+/* Counts the sequences of two to 'MaxLength' consecutively executed
+ * instructions. A sequence may span a call or a taken jump. */
+class SequenceProfile {
+private:
+  std::unordered_map<uint64_t, uint64_t> counts;
+  uint64_t history;
+  int historyLength;
+
+public:
+  static constexpr int MaxLength = 4;
+
+  SequenceProfile() : counts(), history{0}, historyLength{0} {}
+
+  void Record(OpCode opCode) {
+    history = (history << 8 | static_cast<uint8_t>(opCode)) & 0xFFFFFFFF;
+    if (historyLength < MaxLength) {
+      historyLength++;
+    }
+    for (int length = 2; length <= historyLength; length++) {
+      uint64_t mask = (uint64_t(1) << (8 * length)) - 1;
+      counts[uint64_t(length) << 32 | (history & mask)]++;
+    }
+  }
+
+  /* Starts a new run; no sequence spans the previous one. */
+  void Break() { historyLength = 0; }
+
+  /* The 'n' most frequent sequences of 'length' instructions. */
+  std::vector<OpCodeSequence> Top(int length, size_t n) const;
+  std::string ToString(size_t n) const;
+};
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_INTERPRETER_SEQUENCE_PROFILE_HPP */
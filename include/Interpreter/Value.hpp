@@ -0,0 +1,59 @@
+#ifndef CYGNI_INTERPRETER_VALUE_HPP
+#define CYGNI_INTERPRETER_VALUE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "Expressions/Expression.hpp"
+#include "Expressions/Type.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+using Expressions::TypeCode;
+
+/* Strings are immutable and shared between the values holding them. */
+using String = std::shared_ptr<const std::u32string>;
+
+/* A runtime value. Compiled code knows the static type of every value it
+ * touches and reads the matching member directly. 'type' is only kept for
+ * values whose static type is a union and for values exchanged with the
+ * host, which need to know what they hold. */
+class Value {
+public:
+  TypeCode type;
+  union {
+    int32_t int32;
+    int64_t int64;
+    float float32;
+    double float64;
+    bool boolean;
+    char32_t character;
+    /* The number of a function in its module. */
+    int32_t function;
+  };
+  String string;
+
+  Value() : type{TypeCode::Empty}, int64{0}, string() {}
+
+  static Value Int32(int32_t value);
+  static Value Int64(int64_t value);
+  static Value Float32(float value);
+  static Value Float64(double value);
+  static Value Boolean(bool value);
+  static Value Char(char32_t value);
+  static Value Text(const std::u32string &value);
+  static Value Function(int32_t number);
+  /* Zero, false, or the empty string. */
+  static Value Default(TypeCode typeCode);
+
+  std::string ToString() const;
+};
+
+/* The value of a literal. */
+Value ConstantValue(const Expressions::ConstantExpression *node);
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_INTERPRETER_VALUE_HPP */
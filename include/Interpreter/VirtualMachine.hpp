@@ -0,0 +1,192 @@
+#ifndef CYGNI_INTERPRETER_VIRTUAL_MACHINE_HPP
+#define CYGNI_INTERPRETER_VIRTUAL_MACHINE_HPP
+
+#include <memory>
+#include "Interpreter/Bytecode.hpp"
+#include "Interpreter/SequenceProfile.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+class ThreadedFunction;
+
+/* The functions an indirect call site has called, which are known to take
+ * its number of arguments. A site that sees more than 'Capacity' functions
+ * is megamorphic: it keeps its entries but adds no more. */
+class InlineCache {
+public:
+  static constexpr int Capacity = 4;
+
+  class Entry {
+  public:
+    int32_t number;
+    ThreadedFunction *function;
+  };
+
+  int size;
+  bool megamorphic;
+  Entry entries[Capacity];
+
+  InlineCache() : size{0}, megamorphic{false}, entries() {}
+};
+
+/* A cell of threaded code. An instruction is the address of its handler,
+ * or its opcode when the machine dispatches with a switch, followed by one
+ * cell per operand, already decoded: jumps hold their target cell, calls
+ * their callee and indirect calls their argument count and cache. */
+union ThreadedCell {
+  const void *handler;
+  OpCode opCode;
+  uint32_t operand;
+  ThreadedCell *target;
+  ThreadedFunction *function;
+  InlineCache *cache;
+};
+
+/* Where a function stands in tiering: counting its calls and loop
+ * iterations, handed to the tier and waiting for code, running native code,
+ * or left to the interpreter for good. */
+enum class TierState { Counting, Queued, Native, Interpreted };
+
+class ThreadedFunction {
+public:
+  const BytecodeFunction *function;
+  std::vector<ThreadedCell> code;
+  std::vector<InlineCache> caches;
+  /* The header of each loop and its offset in the bytecode. */
+  std::vector<std::pair<const ThreadedCell *, uint32_t>> loops;
+  TierState tier;
+  uint32_t invocations;
+  uint32_t backEdges;
+
+  ThreadedFunction()
+      : function{nullptr}, code(), caches(), loops(),
+        tier{TierState::Counting}, invocations{0}, backEdges{0} {}
+};
+
+/* Compiles the functions the machine finds hot into native code. The
+ * machine reports a function once its calls or its backward jumps reach
+ * their threshold, then asks before each call and each backward jump
+ * whether its code is ready. From then on calls run that instead, and a
+ * call still interpreting moves over at its next loop header. */
+class NativeTier {
+public:
+  virtual ~NativeTier() = default;
+
+  /* Returns whether the function can be compiled at all; compiling must
+   * not block the caller. */
+  virtual bool Hot(int function, uint32_t invocations,
+                   uint32_t backEdges) = 0;
+  virtual bool IsReady(int function) = 0;
+  /* Runs the function on the frame at 'base', leaving the result there,
+   * and throws as the machine would. */
+  virtual void Run(int function, Value *base, Value *stackEnd,
+                   size_t callDepth) = 0;
+  /* Runs the rest of a call from the loop header at 'offset' in its
+   * bytecode, on its frame and operands as they are, or returns false if
+   * the code has no entry there. */
+  virtual bool Enter(int function, uint32_t offset, Value *base,
+                     Value *stackEnd, size_t callDepth) = 0;
+};
+
+/* The caller's state saved by a call. */
+class CallFrame {
+public:
+  ThreadedFunction *function;
+  ThreadedCell *returnAddress;
+  Value *base;
+};
+
+/* Runs a bytecode module on one contiguous stack. The frame of a call
+ * starts at its arguments, which the caller has pushed, and is followed by
+ * the callee's operands. A call checks once that the whole frame fits, so
+ * the instructions themselves never check for overflow.
+ *
+ * Bytecode is translated to threaded code before it runs. With
+ * CYGNI_THREADED_DISPATCH each handler jumps straight to the next one
+ * through a computed goto; otherwise a switch over the opcode dispatches.
+ *
+ * A generic operator rewrites itself to its quickened form for the operand
+ * types it sees, so code whose types the compiler could not prove runs
+ * nearly as fast as specialized code after its first execution. */
+class VirtualMachine {
+private:
+  const BytecodeModule *module;
+  std::unique_ptr<Value[]> stack;
+  Value *stackEnd;
+  std::vector<Value> globals;
+  std::vector<CallFrame> frames;
+  size_t maxCallDepth;
+  std::vector<ThreadedFunction> threaded;
+  const void *const *handlers;
+  std::unordered_map<const void *, OpCode> handlerOpCodes;
+  bool counting;
+  uint64_t instructionCount;
+  uint64_t quickenings;
+  uint64_t deoptimizations;
+  uint64_t cacheHits;
+  uint64_t cacheMisses;
+  uint64_t megamorphicTransitions;
+  SequenceProfile *profile;
+  std::vector<bool> fusing;
+  NativeTier *tier;
+  uint32_t invocationThreshold;
+  uint32_t backEdgeThreshold;
+
+public:
+  static constexpr size_t DefaultStackSize = 1 << 18;
+  static constexpr size_t DefaultMaxCallDepth = 1 << 16;
+
+  explicit VirtualMachine(const BytecodeModule *module,
+                          size_t stackSize = DefaultStackSize,
+                          size_t maxCallDepth = DefaultMaxCallDepth);
+  VirtualMachine(const VirtualMachine &) = delete;
+  VirtualMachine &operator=(const VirtualMachine &) = delete;
+
+  Value Call(const std::u32string &name, const std::vector<Value> &arguments);
+
+  /* Counting runs a separate copy of the dispatch loop, so the default
+   * loop pays nothing for it. */
+  void CountInstructions(bool enabled);
+  uint64_t InstructionCount() const { return instructionCount; }
+
+  /* While counting, also records the executed sequences into 'profile',
+   * if it is not null. */
+  void ProfileSequences(SequenceProfile *profile) { this->profile = profile; }
+
+  /* Superinstructions are all used by default. */
+  void UseSuperinstruction(OpCode opCode, bool enabled);
+
+  uint64_t Quickenings() const { return quickenings; }
+  uint64_t Deoptimizations() const { return deoptimizations; }
+
+  /* Indirect calls found in their site's inline cache, calls that had to
+   * resolve their function, and sites that turned megamorphic. */
+  uint64_t CacheHits() const { return cacheHits; }
+  uint64_t CacheMisses() const { return cacheMisses; }
+  uint64_t MegamorphicTransitions() const { return megamorphicTransitions; }
+
+  /* Counts calls and backward jumps per function and hands hot functions
+   * to 'tier'; a null tier turns tiering off. Counters restart whenever
+   * the code is threaded again. */
+  void UseTier(NativeTier *tier, uint32_t invocationThreshold,
+               uint32_t backEdgeThreshold);
+
+private:
+  void Thread();
+  OpCode OpCodeOf(const ThreadedCell *cell) const;
+  ThreadedFunction *Resolve(InlineCache *cache, int32_t number,
+                            uint32_t argumentCount);
+  bool Promote(ThreadedFunction *function, uint32_t &count,
+               uint32_t threshold);
+  bool Replace(ThreadedFunction *function, const ThreadedCell *header,
+               Value *base);
+  void Report(ThreadedFunction *function);
+  template <bool Counting>
+  Value Run(ThreadedFunction *function, Value *base);
+};
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_INTERPRETER_VIRTUAL_MACHINE_HPP */
@@ -0,0 +1,138 @@
+#ifndef CYGNI_UTILITY_FLAT_MAP_HPP
+#define CYGNI_UTILITY_FLAT_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Cygni {
+namespace Utility {
+
+/* FNV-1a over code points. Passing the hash of a prefix as 'seed' continues
+ * it, so 'HashName(b, HashName(a))' equals 'HashName(a + b)'. */
+inline std::size_t HashName(const std::u32string &name,
+                            std::size_t seed = 14695981039346656037ULL) {
+  std::uint64_t hash = seed;
+  for (char32_t c : name) {
+    hash ^= static_cast<std::uint64_t>(c);
+    hash *= 1099511628211ULL;
+  }
+  return static_cast<std::size_t>(hash);
+}
+
+/* An open-addressing hash map from names to values with linear probing.
+ * Entries live in one array and keep their hash, so a lookup with a
+ * precomputed hash touches no other memory until the keys are compared.
+ * Entries cannot be erased. */
+template <typename TValue> class FlatMap {
+private:
+  struct Slot {
+    bool occupied = false;
+    std::size_t hash = 0;
+    std::u32string key;
+    TValue value{};
+  };
+
+  std::vector<Slot> slots;
+  std::size_t count;
+
+public:
+  FlatMap() : slots(8), count{0} {}
+
+  std::size_t Size() const { return count; }
+
+  /* Returns false and leaves the map unchanged if the key exists. */
+  bool Insert(const std::u32string &key, const TValue &value) {
+    return Insert(key, HashName(key), value);
+  }
+
+  bool Insert(const std::u32string &key, std::size_t hash,
+              const TValue &value);
+
+  TValue *Find(const std::u32string &key) { return Find(key, HashName(key)); }
+
+  TValue *Find(const std::u32string &key, std::size_t hash) {
+    Slot &slot = slots[Probe(key, hash)];
+    return slot.occupied ? &slot.value : nullptr;
+  }
+
+  const TValue *Find(const std::u32string &key) const {
+    return Find(key, HashName(key));
+  }
+
+  const TValue *Find(const std::u32string &key, std::size_t hash) const {
+    const Slot &slot = slots[Probe(key, hash)];
+    return slot.occupied ? &slot.value : nullptr;
+  }
+
+  bool Contains(const std::u32string &key) const {
+    return Find(key) != nullptr;
+  }
+
+  TValue &At(const std::u32string &key) {
+    TValue *value = Find(key);
+    if (value) {
+      return *value;
+    } else {
+      throw std::out_of_range("key not found in flat map");
+    }
+  }
+
+  template <typename TFunction> void ForEach(TFunction function) const {
+    for (const Slot &slot : slots) {
+      if (slot.occupied) {
+        function(slot.key, slot.value);
+      }
+    }
+  }
+
+private:
+  /* The slot holding 'key', or the empty slot where it would go. */
+  std::size_t Probe(const std::u32string &key, std::size_t hash) const {
+    std::size_t mask = slots.size() - 1;
+    std::size_t i = hash & mask;
+    while (slots[i].occupied &&
+           (slots[i].hash != hash || slots[i].key != key)) {
+      i = (i + 1) & mask;
+    }
+    return i;
+  }
+
+  void Grow();
+};
+
+template <typename TValue>
+bool FlatMap<TValue>::Insert(const std::u32string &key, std::size_t hash,
+                             const TValue &value) {
+  if ((count + 1) * 4 > slots.size() * 3) {
+    Grow();
+  }
+  Slot &slot = slots[Probe(key, hash)];
+  if (slot.occupied) {
+    return false;
+  } else {
+    slot.occupied = true;
+    slot.hash = hash;
+    slot.key = key;
+    slot.value = value;
+    count++;
+    return true;
+  }
+}
+
+template <typename TValue> void FlatMap<TValue>::Grow() {
+  std::vector<Slot> old(slots.size() * 2);
+  old.swap(slots);
+  for (Slot &slot : old) {
+    if (slot.occupied) {
+      slots[Probe(slot.key, slot.hash)] = std::move(slot);
+    }
+  }
+}
+
+}; /* namespace Utility */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_UTILITY_FLAT_MAP_HPP */
@@ -0,0 +1,46 @@
+#ifndef CYGNI_UTILITY_THREAD_POOL_HPP
+#define CYGNI_UTILITY_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Cygni {
+namespace Utility {
+
+/* A fixed set of worker threads running submitted tasks in order of
+ * submission. Tasks must not throw; callers capture their own errors. */
+class ThreadPool {
+private:
+  std::vector<std::thread> workers;
+  std::queue<std::function<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable taskReady;
+  std::condition_variable allDone;
+  int running;
+  bool stopping;
+
+public:
+  explicit ThreadPool(int threadCount);
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ~ThreadPool();
+
+  int ThreadCount() const { return static_cast<int>(workers.size()); }
+
+  void Submit(std::function<void()> task);
+
+  /* Blocks until every submitted task has finished. */
+  void Wait();
+
+private:
+  void Work();
+};
+
+}; /* namespace Utility */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_UTILITY_THREAD_POOL_HPP */
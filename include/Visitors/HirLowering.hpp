@@ -0,0 +1,53 @@
+#ifndef CYGNI_VISITORS_HIR_LOWERING_HPP
+#define CYGNI_VISITORS_HIR_LOWERING_HPP
+
+#include "HighLevelIR/Hir.hpp"
+#include "Visitors/NameLocator.hpp"
+#include "Visitors/NameResolver.hpp"
+#include "Visitors/TypeChecker.hpp"
+
+namespace Cygni {
+namespace Visitors {
+
+using HighLevelIR::HirFactory;
+using HighLevelIR::HirNode;
+
+/* Lowers a resolved, type checked and located tree into the HIR, making
+ * implicit conversions explicit as Convert nodes. The lowering is only
+ * exercised by tests so far; see HirNode. */
+class HirLowering : public ExpressionVisitor<const HirNode *> {
+private:
+  HirFactory &factory;
+  TypeChecker &typeChecker;
+  const std::unordered_map<const Expression *, NameInfo> &nameInfoTable;
+  const BindingTable &bindings;
+  TypeRelationCache relations;
+  std::unordered_map<const Expression *, const HirNode *> declarations;
+
+public:
+  HirLowering(
+      HirFactory &factory, TypeChecker &typeChecker,
+      const std::unordered_map<const Expression *, NameInfo> &nameInfoTable,
+      const BindingTable &bindings);
+
+  const HirNode *VisitBinary(const BinaryExpression *node) override;
+  const HirNode *VisitConstant(const ConstantExpression *node) override;
+  const HirNode *VisitParameter(const ParameterExpression *node) override;
+  const HirNode *VisitBlock(const BlockExpression *node) override;
+  const HirNode *VisitConditional(const ConditionalExpression *node) override;
+  const HirNode *VisitUnary(const UnaryExpression *node) override;
+  const HirNode *VisitCall(const CallExpression *node) override;
+  const HirNode *VisitLambda(const LambdaExpression *node) override;
+  const HirNode *VisitLoop(const LoopExpression *node) override;
+  const HirNode *VisitDefault(const DefaultExpression *node) override;
+  const HirNode *
+  VisitVariableDeclaration(const VariableDeclarationExpression *node) override;
+
+private:
+  const HirNode *Convert(const HirNode *node, const Type *type);
+};
+
+}; /* namespace Visitors */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_VISITORS_HIR_LOWERING_HPP */
@@ -0,0 +1,82 @@
+#ifndef CYGNI_VISITORS_INCREMENTAL_TYPE_CHECKER_HPP
+#define CYGNI_VISITORS_INCREMENTAL_TYPE_CHECKER_HPP
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include "Visitors/NameResolver.hpp"
+#include "Visitors/TypeChecker.hpp"
+
+namespace Cygni {
+namespace Visitors {
+
+/* The result of checking one function body: its node types or the message
+ * of the error that stopped it, and the global names the body refers to. */
+class FunctionCheckResult {
+public:
+  const LambdaExpression *function;
+  std::unordered_map<const Expression *, const Type *> nodeTypes;
+  std::string diagnostic;
+  std::vector<std::u32string> dependencies;
+
+  FunctionCheckResult() : function{nullptr} {}
+};
+
+/* Keeps the type checking results of a module between edits. A function
+ * body depends only on the signatures of the global functions and variables
+ * it names, all of which come from declared types. So an edit re-checks the
+ * edited body, plus the bodies naming it if its signature changed, added or
+ * removed; every other result and diagnostic is kept. Global names form one
+ * flat namespace. */
+class IncrementalTypeChecker {
+private:
+  class Symbol {
+  public:
+    const Expression *declaration;
+    const Type *signature;
+  };
+
+  TypeFactory types;
+  std::unordered_map<std::u32string, Symbol> symbols;
+  std::unordered_map<std::u32string, FunctionCheckResult> results;
+  std::unordered_map<std::u32string, std::unordered_set<std::u32string>>
+      dependents;
+  std::unordered_set<std::u32string> dirty;
+  bool symbolsRemoved;
+  std::unique_ptr<Scope<const Expression *>> globalDeclarations;
+  std::unique_ptr<Scope<const Type *>> globalTypes;
+
+public:
+  IncrementalTypeChecker();
+
+  /* Adds a function, or replaces the function with the same name. */
+  void SetFunction(const LambdaExpression *function);
+  void SetGlobalVariable(const ParameterExpression *variable);
+  void Remove(const std::u32string &name);
+
+  /* Re-checks the bodies affected by the edits since the last call and
+   * returns how many were checked. */
+  int Check();
+
+  const FunctionCheckResult &Result(const std::u32string &name) const {
+    return results.at(name);
+  }
+
+  const std::unordered_map<std::u32string, FunctionCheckResult> &
+  Results() const {
+    return results;
+  }
+
+private:
+  void SetSymbol(const std::u32string &name, const Expression *declaration,
+                 const Type *signature);
+  void MarkDependents(const std::u32string &name);
+  void RebuildGlobalScopes();
+  void RemoveResult(const std::u32string &name);
+  void CheckFunction(const std::u32string &name, FunctionCheckResult &result);
+};
+
+}; /* namespace Visitors */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_VISITORS_INCREMENTAL_TYPE_CHECKER_HPP */
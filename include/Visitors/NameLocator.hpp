@@ -3,6 +3,9 @@
 
 #include "Visitors/Visitor.hpp"
 #include "Visitors/Scope.hpp"
+#include "Visitors/NameResolver.hpp"
+#include "Visitors/PassManager.hpp"
+#include <algorithm>
 
 namespace Cygni {
 namespace Visitors {
@@ -11,8 +14,6 @@ enum class LocationKind {
   Global,
   FunctionVariable,
   FunctionConstant,
-  FunctionVariableCount,
-  FunctionConstantCount,
   Function,
 };
 
@@ -25,15 +26,102 @@ public:
   NameInfo(LocationKind kind, int number) : kind{kind}, number{number} {}
 };
 
-class NameLocator : public ExpressionVisitor<void, Scope<NameInfo> *> {
+/* A constant by its value, converted from the literal as the interpreters
+ * do, so '1' and '01' or '1.0' and '1.00' are the same constant. Numbers,
+ * booleans and characters keep the bits of their value; strings their
+ * text. */
+class ConstantKey {
+public:
+  TypeCode typeCode;
+  uint64_t bits;
+  std::u32string text;
+
+  explicit ConstantKey(const ConstantExpression *node);
+
+  bool operator==(const ConstantKey &other) const {
+    return typeCode == other.typeCode && bits == other.bits &&
+           text == other.text;
+  }
+};
+
+class ConstantKeyHash {
+public:
+  std::size_t operator()(const ConstantKey &key) const {
+    return (std::hash<std::u32string>()(key.text) * 31 +
+            std::hash<uint64_t>()(key.bits)) *
+               31 +
+           static_cast<std::size_t>(key.typeCode);
+  }
+};
+
+/* Distinct constants in order of first occurrence. Each entry is the first
+ * literal with that type and value; later equal literals share its index,
+ * however they are spelled. */
+class ConstantPool {
+private:
+  std::unordered_map<ConstantKey, int, ConstantKeyHash> indices;
+  std::vector<const ConstantExpression *> constants;
+
+public:
+  int Add(const ConstantExpression *node);
+
+  int Size() const { return static_cast<int>(constants.size()); }
+
+  const std::vector<const ConstantExpression *> &Constants() const {
+    return constants;
+  }
+};
+
+/* 'variableCount' is the number of slots in use at the current point of the
+ * walk. Slots of a block's variables are released when the block ends, so
+ * sibling blocks share them; 'frameSize' is the most slots ever in use. */
+class FunctionFrame {
+public:
+  int variableCount;
+  int frameSize;
+  ConstantPool constants;
+
+  FunctionFrame() : variableCount{0}, frameSize{0} {}
+
+  int AllocateSlot() {
+    frameSize = std::max(frameSize, variableCount + 1);
+    return variableCount++;
+  }
+};
+
+/* Locates variables in the slots of their function and constants in its
+ * constant pool. String literals are not located; the back end numbers
+ * them once per module by their text. The frame of every lambda is kept for the
+ * back end; constants outside any lambda go to the top level frame.
+ *
+ * Given name bindings, a name is located through its declaration, and the
+ * scope is only read for names declared before the walk (e.g. global
+ * functions). As a fused pass the name locator requires them. */
+class NameLocator : public ExpressionVisitor<void, Scope<NameInfo> *>,
+                    public TreePass {
 private:
   std::unordered_map<const Expression *, NameInfo> nameInfoTable;
+  const BindingTable *bindings;
+  std::vector<FunctionFrame> frames;
+  std::vector<int> slotMarks;
+  std::unordered_map<const LambdaExpression *, FunctionFrame> functionFrames;
 
 public:
+  NameLocator() : bindings{nullptr}, frames(1) {}
+  explicit NameLocator(const BindingTable *bindings)
+      : bindings{bindings}, frames(1) {}
+
   const std::unordered_map<const Expression *, NameInfo> &NameInfoTable() {
     return nameInfoTable;
   }
 
+  const FunctionFrame &TopLevelFrame() const { return frames.front(); }
+
+  const std::unordered_map<const LambdaExpression *, FunctionFrame> &
+  FunctionFrames() const {
+    return functionFrames;
+  }
+
   void VisitBinary(const BinaryExpression *node,
                    Scope<NameInfo> *scope) override;
   void VisitUnary(const UnaryExpression *node, Scope<NameInfo> *scope) override;
@@ -42,20 +130,37 @@ public:
   void VisitParameter(const ParameterExpression *node,
                       Scope<NameInfo> *scope) override;
   void VisitBlock(const BlockExpression *node,
-                  Scope<NameInfo> *parent) override;
+                  Scope<NameInfo> *scope) override;
   void VisitConditional(const ConditionalExpression *node,
                         Scope<NameInfo> *scope) override;
   void VisitCall(const CallExpression *node, Scope<NameInfo> *scope) override;
   void VisitLambda(const LambdaExpression *node,
-                   Scope<NameInfo> *parent) override;
-  void VisitLoop(const LoopExpression *node, Scope<NameInfo> *parent) override;
+                   Scope<NameInfo> *scope) override;
+  void VisitLoop(const LoopExpression *node, Scope<NameInfo> *scope) override;
   void VisitDefault(const DefaultExpression *node,
                     Scope<NameInfo> *scope) override;
   void VisitVariableDeclaration(const VariableDeclarationExpression *node,
                                 Scope<NameInfo> *scope) override;
+
+  void Enter(const Expression *node) override;
+  void Leave(const Expression *node) override;
+
+private:
+  Scope<NameInfo> *Names(Scope<NameInfo> *scope) const {
+    return bindings ? nullptr : scope;
+  }
+  void LocateConstant(const ConstantExpression *node);
+  void LocateParameter(const ParameterExpression *node,
+                       Scope<NameInfo> *scope);
+  void EnterFunction(const LambdaExpression *node, Scope<NameInfo> *scope);
+  void LeaveFunction(const LambdaExpression *node);
+  void EnterBlock();
+  void LeaveBlock();
+  void DeclareVariable(const VariableDeclarationExpression *node,
+                       Scope<NameInfo> *scope);
 };
 
 }; /* namespace Visitors */
 }; /* namespace Cygni */
 
-#endif /* CYGNI_VISITORS_NAME_LOCATOR_HPP */
\ No newline at end of file
+#endif /* CYGNI_VISITORS_NAME_LOCATOR_HPP */
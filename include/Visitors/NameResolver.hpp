@@ -0,0 +1,98 @@
+#ifndef CYGNI_VISITORS_NAME_RESOLVER_HPP
+#define CYGNI_VISITORS_NAME_RESOLVER_HPP
+
+#include <unordered_set>
+#include "Visitors/Visitor.hpp"
+#include "Visitors/Scope.hpp"
+#include "Visitors/PassManager.hpp"
+
+namespace Cygni {
+namespace Visitors {
+
+class Binding {
+public:
+  const Expression *declaration;
+  int depth;
+  int slot;
+
+  Binding() = default;
+  Binding(const Expression *declaration, int depth, int slot)
+      : declaration{declaration}, depth{depth}, slot{slot} {}
+};
+
+using BindingTable = std::unordered_map<const Expression *, Binding>;
+
+/* Binds every identifier use to its declaring node once, so later passes
+ * never look names up by string. Declarations are lambda parameters and
+ * variable declarations; 'depth' is the number of enclosing lambdas of the
+ * declaration and 'slot' its slot within that lambda, numbered as the
+ * NameLocator does, so sibling blocks share slots. Names
+ * declared in the scope before the pass runs (e.g. global functions) are
+ * bound with depth 0 and slot -1. As a fused pass it uses the scope given
+ * to the constructor.
+ *
+ * A name declared nowhere is an error, unless free names are collected:
+ * then it is bound to no declaration, with depth 0 and slot -1, and listed
+ * in FreeNames() in order of first use. */
+class NameResolver
+    : public ExpressionVisitor<void, Scope<const Expression *> *>,
+      public TreePass {
+private:
+  BindingTable bindings;
+  std::vector<int> slotCounters;
+  std::vector<int> slotMarks;
+  bool collecting;
+  std::vector<std::u32string> freeNames;
+  std::unordered_set<std::u32string> freeNameSet;
+  Scope<const Expression *> ownScope;
+  Scope<const Expression *> *passScope;
+
+public:
+  NameResolver();
+  explicit NameResolver(Scope<const Expression *> *scope);
+
+  const BindingTable &Bindings() const { return bindings; }
+  const std::vector<std::u32string> &FreeNames() const { return freeNames; }
+
+  void CollectFreeNames() { collecting = true; }
+
+  void VisitBinary(const BinaryExpression *node,
+                   Scope<const Expression *> *scope) override;
+  void VisitUnary(const UnaryExpression *node,
+                  Scope<const Expression *> *scope) override;
+  void VisitConstant(const ConstantExpression *node,
+                     Scope<const Expression *> *scope) override;
+  void VisitParameter(const ParameterExpression *node,
+                      Scope<const Expression *> *scope) override;
+  void VisitBlock(const BlockExpression *node,
+                  Scope<const Expression *> *scope) override;
+  void VisitConditional(const ConditionalExpression *node,
+                        Scope<const Expression *> *scope) override;
+  void VisitCall(const CallExpression *node,
+                 Scope<const Expression *> *scope) override;
+  void VisitLambda(const LambdaExpression *node,
+                   Scope<const Expression *> *scope) override;
+  void VisitLoop(const LoopExpression *node,
+                 Scope<const Expression *> *scope) override;
+  void VisitDefault(const DefaultExpression *node,
+                    Scope<const Expression *> *scope) override;
+  void VisitVariableDeclaration(const VariableDeclarationExpression *node,
+                                Scope<const Expression *> *scope) override;
+
+  void Enter(const Expression *node) override;
+  void Leave(const Expression *node) override;
+
+private:
+  void Bind(const ParameterExpression *node,
+            Scope<const Expression *> *scope);
+  void DeclareParameters(const LambdaExpression *node,
+                         Scope<const Expression *> *scope);
+  void Allocate(const Expression *node);
+  void EnterBlock();
+  void LeaveBlock();
+};
+
+}; /* namespace Visitors */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_VISITORS_NAME_RESOLVER_HPP */
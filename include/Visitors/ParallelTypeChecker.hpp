@@ -0,0 +1,46 @@
+#ifndef CYGNI_VISITORS_PARALLEL_TYPE_CHECKER_HPP
+#define CYGNI_VISITORS_PARALLEL_TYPE_CHECKER_HPP
+
+#include "Visitors/NameResolver.hpp"
+#include "Visitors/TypeChecker.hpp"
+
+namespace Cygni {
+namespace Visitors {
+
+/* Type checks the functions of a module in two phases. First every function
+ * is declared by name in a global scope. Then the bodies are checked
+ * concurrently: each worker binds the names of a body with its own
+ * NameResolver, over a scope whose outer scope is the global one, and type
+ * checks it through those bindings, so a call finds its callee's signature
+ * from the callee's declared types. The workers' node types are merged when
+ * all are done. If any function fails, the error of the first failing
+ * function in module order is rethrown. */
+class ParallelTypeChecker {
+private:
+  int threadCount;
+  TypeFactory types;
+  Scope<const Expression *> globals;
+  std::unordered_map<const Expression *, const Type *> nodeTypes;
+
+public:
+  explicit ParallelTypeChecker(int threadCount);
+
+  void Check(const std::vector<const LambdaExpression *> &functions);
+
+  const Type *GetType(const Expression *node) const {
+    return nodeTypes.at(node);
+  }
+
+  const std::unordered_map<const Expression *, const Type *> &
+  NodeTypes() const {
+    return nodeTypes;
+  }
+
+private:
+  void DeclareSignatures(const std::vector<const LambdaExpression *> &functions);
+};
+
+}; /* namespace Visitors */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_VISITORS_PARALLEL_TYPE_CHECKER_HPP */
@@ -0,0 +1,68 @@
+#ifndef CYGNI_VISITORS_PASS_MANAGER_HPP
+#define CYGNI_VISITORS_PASS_MANAGER_HPP
+
+#include "Visitors/Visitor.hpp"
+
+namespace Cygni {
+namespace Visitors {
+
+/* A pass that can be fused with others into a single traversal. 'Enter' is
+ * called before the children of a node are walked and 'Leave' after. Lambda
+ * parameters are not walked; passes handle them when entering the lambda. */
+class TreePass {
+public:
+  virtual ~TreePass() = default;
+  virtual void Enter(const Expression *node) = 0;
+  virtual void Leave(const Expression *node) = 0;
+};
+
+/* Walks a tree once and runs every added pass on each node, in the order the
+ * passes were added. A NameResolver added first maintains the only scope and
+ * binds names for the passes after it. The walk keeps its own stack instead
+ * of recursing, so tree depth is bounded by memory rather than the call
+ * stack; the Visit* methods only schedule the children of a node.
+ *
+ * Fusing saves only the walks, which cost little next to the side tables
+ * the passes fill, so a fused run is no faster than separate ones and the
+ * compiler does not fuse by default. It is for callers that want one walk
+ * without recursion, e.g. over trees too deep for the recursive visitors. */
+class PassManager : private ExpressionVisitor<void> {
+private:
+  struct Frame {
+    const Expression *node;
+    bool entered;
+  };
+
+  std::vector<TreePass *> passes;
+  std::vector<Frame> stack;
+
+public:
+  void Add(TreePass *pass) { passes.push_back(pass); }
+
+  void Run(const Expression *node);
+
+private:
+  void VisitBinary(const BinaryExpression *node) override;
+  void VisitUnary(const UnaryExpression *node) override;
+  void VisitConstant(const ConstantExpression *node) override;
+  void VisitParameter(const ParameterExpression *node) override;
+  void VisitBlock(const BlockExpression *node) override;
+  void VisitConditional(const ConditionalExpression *node) override;
+  void VisitCall(const CallExpression *node) override;
+  void VisitLambda(const LambdaExpression *node) override;
+  void VisitLoop(const LoopExpression *node) override;
+  void VisitDefault(const DefaultExpression *node) override;
+  void
+  VisitVariableDeclaration(const VariableDeclarationExpression *node) override;
+
+  void Schedule(const Expression *node) {
+    stack.push_back(Frame{node, false});
+  }
+  void Enter(const Expression *node);
+  void Leave(const Expression *node);
+};
+
+}; /* namespace Visitors */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_VISITORS_PASS_MANAGER_HPP */
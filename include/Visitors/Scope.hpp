@@ -2,21 +2,42 @@
 #define CYGNI_VISITORS_SCOPE_HPP
 
 #include <unordered_map>
+#include <vector>
 #include "Visitors/ScopException.hpp"
 
 namespace Cygni {
 namespace Visitors {
 
+/* A single symbol table per pass. Every name maps to a stack of shadowed
+ * declarations, and an undo log records which stacks to pop when the
+ * innermost scope exits. Names not found fall back to the optional outer
+ * scope, which is only read and so can be shared between threads. */
 template <typename TValue>
 class Scope
 {
 private:
-	Scope<TValue>* parent;
-	std::unordered_map<std::u32string, TValue> values;
+	struct Entry
+	{
+		int depth;
+		TValue value;
+	};
+
+	std::unordered_map<std::u32string, std::vector<Entry>> values;
+	std::vector<std::vector<Entry>*> undoLog;
+	std::vector<size_t> marks;
+	Scope<TValue>* outer = nullptr;
 
 public:
-	Scope() : parent(nullptr) {};
-	Scope(Scope<TValue>* parent) : parent(parent) {}
+	Scope() = default;
+	explicit Scope(Scope<TValue>* outer) : outer(outer) {}
+	Scope(const Scope<TValue>&) = delete;
+	Scope<TValue>& operator=(const Scope<TValue>&) = delete;
+
+	void Enter();
+
+	void Exit();
+
+	int Depth() const { return static_cast<int>(marks.size()); }
 
 	void Declare(const std::u32string& name, const TValue& value);
 
@@ -27,74 +48,117 @@ public:
     const TValue& Get(const std::u32string& name) const;
 };
 
+/* A null scope is left alone, for passes that keep none. */
+template <typename TValue>
+class NestedScope
+{
+private:
+	Scope<TValue>* scope;
+
+public:
+	explicit NestedScope(Scope<TValue>* scope) : scope(scope)
+	{
+		if (scope)
+		{
+			scope->Enter();
+		}
+	}
+	NestedScope(const NestedScope<TValue>&) = delete;
+	NestedScope<TValue>& operator=(const NestedScope<TValue>&) = delete;
+	~NestedScope()
+	{
+		if (scope)
+		{
+			scope->Exit();
+		}
+	}
+};
+
+
+template <typename TValue>
+void Scope<TValue>::Enter()
+{
+    marks.push_back(undoLog.size());
+}
+
+template <typename TValue>
+void Scope<TValue>::Exit()
+{
+    size_t mark = marks.back();
+    marks.pop_back();
+    while (undoLog.size() > mark)
+    {
+        undoLog.back()->pop_back();
+        undoLog.pop_back();
+    }
+}
 
 template <typename TValue>
 void Scope<TValue>::Declare(const std::u32string& name, const TValue& value)
 {
-    values[name] = value;
+    std::vector<Entry>& stack = values[name];
+    if (!stack.empty() && stack.back().depth == Depth())
+    {
+        stack.back().value = value;
+    }
+    else
+    {
+        stack.push_back(Entry{Depth(), value});
+        undoLog.push_back(&stack);
+    }
 }
 
 template <typename TValue>
 bool Scope<TValue>::Exists(const std::u32string& name) const
 {
-    if (values.find(name) != values.end())
+    auto it = values.find(name);
+    if (it != values.end() && !it->second.empty())
     {
         return true;
     }
     else
     {
-        if (parent != nullptr)
-        {
-            return parent->Exists(name);
-        }
-        else
-        {
-            return false;
-        }
+        return outer && outer->Exists(name);
     }
 }
 
 template <typename TValue>
 TValue& Scope<TValue>::Get(const std::u32string& name)
 {
-    if (values.find(name) != values.end())
+    auto it = values.find(name);
+    if (it != values.end() && !it->second.empty())
     {
-        return values[name];
+        return it->second.back().value;
+    }
+    else if (outer)
+    {
+        return outer->Get(name);
     }
     else
     {
-        if (parent != nullptr)
-        {
-            return parent->Get(name);
-        }
-        else
-        {
-            throw ScopeException(__FILE__, __LINE__, "Undefined symbol.", nullptr, name);
-        }
+        throw ScopeException(__FILE__, __LINE__, "Undefined symbol.", nullptr, name);
     }
 }
 
 template <typename TValue>
 const TValue& Scope<TValue>::Get(const std::u32string& name) const
 {
-    if (values.find(name) != values.end())
+    auto it = values.find(name);
+    if (it != values.end() && !it->second.empty())
+    {
+        return it->second.back().value;
+    }
+    else if (outer)
     {
-        return values[name];
+        return outer->Get(name);
     }
     else
     {
-        if (parent != nullptr)
-        {
-            return parent->Get(name);
-        }
-        else
-        {
-            throw ScopeException(__FILE__, __LINE__, "Undefined symbol.", nullptr, name);
-        }
+        throw ScopeException(__FILE__, __LINE__, "Undefined symbol.", nullptr, name);
     }
 }
 
 }; /* namespace Visitors */
 }; /* namespace Cygni */
 
-#endif /* CYGNI_VISITORS_SCOPE_HPP */
\ No newline at end of file
+#endif /* CYGNI_VISITORS_SCOPE_HPP */
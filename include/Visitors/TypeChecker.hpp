@@ -3,19 +3,35 @@
 
 #include "Visitors/Visitor.hpp"
 #include "Visitors/Scope.hpp"
+#include "Visitors/NameResolver.hpp"
+#include "Visitors/PassManager.hpp"
 #include "Expressions/Type.hpp"
 
 namespace Cygni {
 namespace Visitors {
 
+/* Given name bindings, the type checker finds the declaration of every name
+ * through them and keeps no scope of its own; as a fused pass it requires
+ * them. A name bound to no declaration, or to one outside the tree other
+ * than a function, is read from the scope given to Visit. Type checkers
+ * running on several threads share one thread-safe TypeFactory; each keeps
+ * its own result tables. */
 class TypeChecker
-    : public ExpressionVisitor<const Type *, Scope<const Type *> *> {
+    : public ExpressionVisitor<const Type *, Scope<const Type *> *>,
+      public TreePass {
 private:
   std::unordered_map<const Expression *, const Type *> nodeTypes;
-  TypeFactory Types;
+  std::unordered_map<const Expression *, const Type *> variableTypes;
+  const BindingTable *bindings;
+  std::vector<const Type *> typeStack;
+  TypeFactory ownTypes;
+  TypeFactory *types;
+  TypeRelationCache relations;
 
 public:
   TypeChecker();
+  explicit TypeChecker(const BindingTable *bindings);
+  TypeChecker(const BindingTable *bindings, TypeFactory *types);
 
   const Type *VisitBinary(const BinaryExpression *node,
                           Scope<const Type *> *scope) override;
@@ -24,7 +40,7 @@ public:
   const Type *VisitParameter(const ParameterExpression *node,
                              Scope<const Type *> *scope) override;
   const Type *VisitBlock(const BlockExpression *node,
-                         Scope<const Type *> *parent) override;
+                         Scope<const Type *> *scope) override;
   const Type *VisitConditional(const ConditionalExpression *node,
                                Scope<const Type *> *scope) override;
   const Type *VisitUnary(const UnaryExpression *node,
@@ -32,17 +48,53 @@ public:
   const Type *VisitCall(const CallExpression *node,
                         Scope<const Type *> *scope) override;
   const Type *VisitLambda(const LambdaExpression *node,
-                          Scope<const Type *> *parent) override;
+                          Scope<const Type *> *scope) override;
   const Type *VisitLoop(const LoopExpression *node,
-                        Scope<const Type *> *parent) override;
+                        Scope<const Type *> *scope) override;
   const Type *VisitDefault(const DefaultExpression *node,
                            Scope<const Type *> *scope) override;
   const Type *VisitVariableDeclaration(const VariableDeclarationExpression *node,
                            Scope<const Type *> *scope) override;
 
+  void Enter(const Expression *node) override;
+  void Leave(const Expression *node) override;
+
   const Type *GetType(const Expression *node);
 
+  const Type *GetVariableType(const Expression *declaration);
+
+  const std::unordered_map<const Expression *, const Type *> &
+  NodeTypes() const {
+    return nodeTypes;
+  }
+
+  const TypeRelationCache &Relations() const { return relations; }
+
 private:
+  Scope<const Type *> *Names(Scope<const Type *> *scope) const {
+    return bindings ? nullptr : scope;
+  }
+  const Type *LeaveNode(const Expression *node);
+  const Type *PopType();
+  const Type *CheckBinary(const BinaryExpression *node, const Type *left,
+                          const Type *right);
+  const Type *CheckConstant(const ConstantExpression *node);
+  const Type *CheckParameter(const ParameterExpression *node,
+                             Scope<const Type *> *scope);
+  const Type *CheckConditional(const ConditionalExpression *node,
+                               const Type *test, const Type *ifTrue,
+                               const Type *ifFalse);
+  const Type *CheckUnary(const UnaryExpression *node, const Type *operand);
+  const Type *CheckCall(const CallExpression *node, const Type *function,
+                        const std::vector<const Type *> &arguments);
+  void DeclareParameters(const LambdaExpression *node,
+                         Scope<const Type *> *scope);
+  const Type *CheckLambda(const LambdaExpression *node, const Type *bodyType);
+  const Type *CheckLoop(const LoopExpression *node, const Type *condition,
+                        const Type *body);
+  const Type *CheckVariableDeclaration(const VariableDeclarationExpression *node,
+                                       const Type *initializer,
+                                       Scope<const Type *> *scope);
   const Type *Register(const Expression *node, const Type *type);
 };
 
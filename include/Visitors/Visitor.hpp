@@ -3,6 +3,7 @@
 
 #include "Expressions/TreeException.hpp"
 #include "Expressions/Expression.hpp"
+#include <vector>
 
 namespace Cygni {
 namespace Visitors {
@@ -91,6 +92,48 @@ public:
                            ArgTypes... arguments) = 0;
 };
 
+/* Binary nodes that the parser chains through their left operand. Assignment
+ * is excluded because passes do not all visit its operands left to right. */
+inline bool IsChainedBinary(const Expression *node) {
+  switch (node->NodeType()) {
+  case ExpressionType::Add:
+  case ExpressionType::Subtract:
+  case ExpressionType::Multiply:
+  case ExpressionType::Divide:
+  case ExpressionType::Modulo:
+  case ExpressionType::GreaterThan:
+  case ExpressionType::LessThan:
+  case ExpressionType::GreaterThanOrEqual:
+  case ExpressionType::LessThanOrEqual:
+  case ExpressionType::Equal:
+  case ExpressionType::NotEqual:
+  case ExpressionType::And:
+  case ExpressionType::Or:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/* The left spine of a binary chain, outermost node first. Visitors walk it
+ * with a loop, so 'a + b + ... + z' does not recurse once per operator: visit
+ * the innermost left operand, then each right operand from the back.
+ *
+ * This is the only nesting the recursive visitors (TypeChecker, NameLocator,
+ * NameResolver, HirLowering and the JSON serializer) walk without recursion.
+ * Nested blocks, conditionals, unary operators, calls and lambdas still take
+ * a native frame per level, so their depth is bounded by the call stack.
+ * Trees nested that deep should go through the PassManager, which keeps an
+ * explicit stack for the resolver, the type checker and the name locator. */
+inline std::vector<const BinaryExpression *>
+LeftSpine(const BinaryExpression *node) {
+  std::vector<const BinaryExpression *> spine{node};
+  while (IsChainedBinary(spine.back()->Left())) {
+    spine.push_back(static_cast<const BinaryExpression *>(spine.back()->Left()));
+  }
+  return spine;
+}
+
 }; /* namespace Visitors */
 }; /* namespace Cygni */
 
@@ -0,0 +1,667 @@
+#include "Driver/CompilerDatabase.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include "LexicalAnalysis/Lexer.hpp"
+#include "Utility/UTF32Functions.hpp"
+#include "Visitors/NameResolver.hpp"
+
+namespace Cygni {
+namespace Driver {
+
+using LexicalAnalysis::TokenTag;
+using Utility::UTF32ToUTF8;
+using Utility::UTF8ToUTF32;
+
+namespace {
+
+/* Marks a query as running while in scope, so that an exception thrown by
+ * one of its dependencies cannot leave it looking like a cycle. */
+class ActiveQuery {
+private:
+  bool &active;
+
+public:
+  explicit ActiveQuery(bool &active) : active{active} { active = true; }
+  ActiveQuery(const ActiveQuery &) = delete;
+  ActiveQuery &operator=(const ActiveQuery &) = delete;
+  ~ActiveQuery() { active = false; }
+};
+
+/* Records the queries read while in scope into 'dependencies'. */
+class DependencyFrame {
+private:
+  std::vector<std::vector<QueryKey> *> &frames;
+
+public:
+  DependencyFrame(std::vector<std::vector<QueryKey> *> &frames,
+                  std::vector<QueryKey> *dependencies)
+      : frames{frames} {
+    frames.push_back(dependencies);
+  }
+  DependencyFrame(const DependencyFrame &) = delete;
+  DependencyFrame &operator=(const DependencyFrame &) = delete;
+  ~DependencyFrame() { frames.pop_back(); }
+};
+
+/* The line of the 'func' token declaring 'name' outside any braces, after
+ * skipping the first 'skip' such declarations, or -1. */
+int DeclarationLine(const std::vector<Token> &tokens,
+                    const std::u32string &name, int skip) {
+  int depth = 0;
+  for (size_t i = 0; i + 1 < tokens.size(); i++) {
+    const Token &token = tokens[i];
+    if (depth == 0 && token.tag == TokenTag::Func &&
+        tokens[i + 1].tag == TokenTag::Identifier &&
+        tokens[i + 1].text == name && skip-- == 0) {
+      return token.line;
+    }
+    if (token.tag == TokenTag::LeftBrace) {
+      depth++;
+    } else if (token.tag == TokenTag::RightBrace && depth > 0) {
+      depth--;
+    }
+  }
+  return -1;
+}
+
+}; /* namespace */
+
+bool TokenList::operator==(const TokenList &other) const {
+  if (diagnostic != other.diagnostic ||
+      tokens.size() != other.tokens.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < tokens.size(); i++) {
+    const Token &a = tokens[i];
+    const Token &b = other.tokens[i];
+    if (a.tag != b.tag || a.text != b.text) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool FileTokens::operator==(const FileTokens &other) const {
+  if (!(list == other.list)) {
+    return false;
+  }
+  for (size_t i = 0; i < list.tokens.size(); i++) {
+    const Token &a = list.tokens[i];
+    const Token &b = other.list.tokens[i];
+    if (a.line != b.line || a.column != b.column) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool FunctionBindings::operator==(const FunctionBindings &other) const {
+  if (diagnostic != other.diagnostic || freeNames != other.freeNames ||
+      bindings.size() != other.bindings.size()) {
+    return false;
+  }
+  for (const auto &item : bindings) {
+    auto it = other.bindings.find(item.first);
+    if (it == other.bindings.end() ||
+        it->second.declaration != item.second.declaration ||
+        it->second.depth != item.second.depth ||
+        it->second.slot != item.second.slot) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool FunctionSlots::operator==(const FunctionSlots &other) const {
+  if (diagnostic != other.diagnostic ||
+      frame.frameSize != other.frame.frameSize ||
+      frame.constants.Constants() != other.frame.constants.Constants() ||
+      nameInfoTable.size() != other.nameInfoTable.size()) {
+    return false;
+  }
+  for (const auto &item : nameInfoTable) {
+    auto it = other.nameInfoTable.find(item.first);
+    if (it == other.nameInfoTable.end() ||
+        it->second.kind != item.second.kind ||
+        it->second.number != item.second.number) {
+      return false;
+    }
+  }
+  return true;
+}
+
+CompilerDatabase::CompilerDatabase() : revision{0} {
+  SetInput(QueryKey(QueryKind::SourceFiles, U""), std::vector<std::string>());
+}
+
+void CompilerDatabase::SetSourceText(const std::string &file,
+                                     const std::u32string &text) {
+  QueryKey key(QueryKind::SourceText, UTF8ToUTF32(file));
+  std::vector<std::string> files =
+      Input<std::vector<std::string>>(QueryKey(QueryKind::SourceFiles, U""));
+  bool listed = std::find(files.begin(), files.end(), file) != files.end();
+  if (listed && Input<std::u32string>(key) == text) {
+    return;
+  }
+  revision++;
+  if (!documents.count(file)) {
+    documents.insert(
+        {file, std::make_shared<LexicalAnalysis::SourceCodeFile>(file)});
+  }
+  SetInput(key, text);
+  if (!listed) {
+    files.push_back(file);
+    SetInput(QueryKey(QueryKind::SourceFiles, U""), files);
+  }
+}
+
+void CompilerDatabase::RemoveSourceFile(const std::string &file) {
+  std::vector<std::string> files =
+      Input<std::vector<std::string>>(QueryKey(QueryKind::SourceFiles, U""));
+  auto it = std::find(files.begin(), files.end(), file);
+  if (it != files.end()) {
+    revision++;
+    files.erase(it);
+    SetInput(QueryKey(QueryKind::SourceText, UTF8ToUTF32(file)),
+             std::u32string());
+    SetInput(QueryKey(QueryKind::SourceFiles, U""), files);
+  }
+}
+
+int CompilerDatabase::Executions(QueryKind kind) const {
+  auto it = executions.find(kind);
+  if (it != executions.end()) {
+    return it->second;
+  } else {
+    return 0;
+  }
+}
+
+const std::u32string &CompilerDatabase::SourceText(const std::string &file) {
+  return Input<std::u32string>(
+      QueryKey(QueryKind::SourceText, UTF8ToUTF32(file)));
+}
+
+const std::vector<std::string> &CompilerDatabase::SourceFiles() {
+  return Input<std::vector<std::string>>(
+      QueryKey(QueryKind::SourceFiles, U""));
+}
+
+const FileTokens &CompilerDatabase::TokensOfFile(const std::string &file) {
+  return Fetch<FileTokens>(
+      QueryKey(QueryKind::TokensOfFile, UTF8ToUTF32(file)),
+      [&]() { return ComputeTokensOfFile(file); });
+}
+
+const std::vector<FunctionItem> &
+CompilerDatabase::FunctionsOfFile(const std::string &file) {
+  return Fetch<std::vector<FunctionItem>>(
+      QueryKey(QueryKind::FunctionsOfFile, UTF8ToUTF32(file)),
+      [&]() { return ComputeFunctionsOfFile(file); });
+}
+
+const FunctionIndex &CompilerDatabase::Functions() {
+  return Fetch<FunctionIndex>(QueryKey(QueryKind::FunctionIndex, U""),
+                              [&]() { return ComputeFunctions(); });
+}
+
+const FunctionLocation &
+CompilerDatabase::LocationOfFunction(const std::u32string &name) {
+  return Fetch<FunctionLocation>(
+      QueryKey(QueryKind::LocationOfFunction, name), [&]() {
+        const FunctionIndex &index = Functions();
+        auto it = index.find(name);
+        return it != index.end() ? it->second : FunctionLocation();
+      });
+}
+
+const SourcePosition &
+CompilerDatabase::PositionOfFunction(const std::u32string &name) {
+  return Fetch<SourcePosition>(
+      QueryKey(QueryKind::PositionOfFunction, name),
+      [&]() { return ComputePositionOfFunction(name); });
+}
+
+const TokenList &
+CompilerDatabase::TokensOfFunction(const std::u32string &name) {
+  return Fetch<TokenList>(QueryKey(QueryKind::TokensOfFunction, name),
+                          [&]() { return ComputeTokensOfFunction(name); });
+}
+
+const FunctionAst &CompilerDatabase::AstOfFunction(const std::u32string &name) {
+  return Fetch<FunctionAst>(QueryKey(QueryKind::AstOfFunction, name),
+                            [&]() { return ComputeAstOfFunction(name); });
+}
+
+const Type *CompilerDatabase::SignatureOfFunction(const std::u32string &name) {
+  return Fetch<const Type *>(
+      QueryKey(QueryKind::SignatureOfFunction, name),
+      [&]() { return ComputeSignatureOfFunction(name); });
+}
+
+const FunctionBindings &
+CompilerDatabase::BindingsOfFunction(const std::u32string &name) {
+  return Fetch<FunctionBindings>(
+      QueryKey(QueryKind::BindingsOfFunction, name),
+      [&]() { return ComputeBindingsOfFunction(name); });
+}
+
+const BodyTypes &CompilerDatabase::TypeOfBody(const std::u32string &name) {
+  return Fetch<BodyTypes>(QueryKey(QueryKind::TypeOfBody, name),
+                          [&]() { return ComputeTypeOfBody(name); });
+}
+
+const FunctionSlots &
+CompilerDatabase::SlotsOfFunction(const std::u32string &name) {
+  return Fetch<FunctionSlots>(QueryKey(QueryKind::SlotsOfFunction, name),
+                              [&]() { return ComputeSlotsOfFunction(name); });
+}
+
+std::string CompilerDatabase::DiagnosticOfFunction(const std::u32string &name) {
+  const FunctionLocation &location = LocationOfFunction(name);
+  if (!location.duplicate.empty()) {
+    int line = DeclarationLine(TokensOfFile(location.duplicate).list.tokens,
+                               name, location.duplicate == location.file);
+    return location.duplicate + ":" + std::to_string(line + 1) + ": " +
+           UTF32ToUTF8(U"'" + name + U"' defined twice.");
+  }
+  const FunctionAst &ast = AstOfFunction(name);
+  const BodyTypes &types = TypeOfBody(name);
+  const FunctionSlots &slots = SlotsOfFunction(name);
+  for (const auto &diagnostic :
+       {ast.diagnostic, types.diagnostic, slots.diagnostic}) {
+    if (!diagnostic.empty()) {
+      std::string prefix = UTF32ToUTF8(U"'" + name + U"': ");
+      const SourcePosition &position = PositionOfFunction(name);
+      if (position.line >= 0) {
+        prefix = position.file + ":" + std::to_string(position.line + 1) +
+                 ": " + prefix;
+      }
+      return prefix + diagnostic;
+    }
+  }
+  return "";
+}
+
+template <typename TValue>
+void CompilerDatabase::SetInput(const QueryKey &key, const TValue &value) {
+  auto &slot = memos[key];
+  if (!slot) {
+    slot = std::make_unique<Memo<TValue>>();
+    slot->input = true;
+  }
+  auto &memo = static_cast<Memo<TValue> &>(*slot);
+  if (!memo.hasValue || !(memo.value == value)) {
+    memo.value = value;
+    memo.hasValue = true;
+    memo.changedAt = revision;
+  }
+  memo.verifiedAt = revision;
+}
+
+template <typename TValue>
+const TValue &CompilerDatabase::Input(const QueryKey &key) {
+  auto it = memos.find(key);
+  if (it == memos.end()) {
+    throw std::out_of_range("no source file '" + UTF32ToUTF8(key.argument) +
+                            "'");
+  }
+  Record(key);
+  return static_cast<Memo<TValue> &>(*it->second).value;
+}
+
+template <typename TValue, typename TCompute>
+const TValue &CompilerDatabase::Fetch(const QueryKey &key, TCompute compute) {
+  auto &slot = memos[key];
+  if (!slot) {
+    slot = std::make_unique<Memo<TValue>>();
+  }
+  auto &memo = static_cast<Memo<TValue> &>(*slot);
+  if (memo.active) {
+    throw std::logic_error("cyclic query on '" + UTF32ToUTF8(key.argument) +
+                           "'");
+  }
+  if (memo.verifiedAt != revision && !(memo.hasValue && TryMarkGreen(memo))) {
+    Execute(memo, key, compute);
+  }
+  Record(key);
+  return memo.value;
+}
+
+/* An equal value keeps the revision it last changed at, which is what keeps
+ * the queries reading it green. */
+template <typename TValue, typename TCompute>
+void CompilerDatabase::Execute(Memo<TValue> &memo, const QueryKey &key,
+                               TCompute compute) {
+  std::vector<QueryKey> dependencies;
+  TValue value{};
+  executions[key.kind]++;
+  {
+    ActiveQuery active(memo.active);
+    DependencyFrame frame(frames, &dependencies);
+    value = compute();
+  }
+  if (!memo.hasValue || !(memo.value == value)) {
+    memo.value = std::move(value);
+    memo.hasValue = true;
+    memo.changedAt = revision;
+  }
+  memo.verifiedAt = revision;
+  memo.dependencies = std::move(dependencies);
+}
+
+/* Brings the dependencies up to date in the order they were read. The
+ * memo stays valid if none of them changed after it was last verified. */
+bool CompilerDatabase::TryMarkGreen(MemoBase &memo) {
+  {
+    ActiveQuery active(memo.active);
+    for (const auto &dependency : memo.dependencies) {
+      MemoBase &dependencyMemo = *memos.at(dependency);
+      if (!dependencyMemo.input && dependencyMemo.verifiedAt != revision) {
+        Update(dependency);
+      }
+      if (dependencyMemo.changedAt > memo.verifiedAt) {
+        return false;
+      }
+    }
+  }
+  memo.verifiedAt = revision;
+  return true;
+}
+
+/* Revalidates or runs a query for another memo's sake, without recording it
+ * as a dependency of the query running now. */
+void CompilerDatabase::Update(const QueryKey &key) {
+  std::vector<QueryKey> ignored;
+  DependencyFrame frame(frames, &ignored);
+  switch (key.kind) {
+  case QueryKind::TokensOfFile: {
+    TokensOfFile(UTF32ToUTF8(key.argument));
+    break;
+  }
+  case QueryKind::FunctionsOfFile: {
+    FunctionsOfFile(UTF32ToUTF8(key.argument));
+    break;
+  }
+  case QueryKind::FunctionIndex: {
+    Functions();
+    break;
+  }
+  case QueryKind::LocationOfFunction: {
+    LocationOfFunction(key.argument);
+    break;
+  }
+  case QueryKind::PositionOfFunction: {
+    PositionOfFunction(key.argument);
+    break;
+  }
+  case QueryKind::TokensOfFunction: {
+    TokensOfFunction(key.argument);
+    break;
+  }
+  case QueryKind::AstOfFunction: {
+    AstOfFunction(key.argument);
+    break;
+  }
+  case QueryKind::SignatureOfFunction: {
+    SignatureOfFunction(key.argument);
+    break;
+  }
+  case QueryKind::BindingsOfFunction: {
+    BindingsOfFunction(key.argument);
+    break;
+  }
+  case QueryKind::TypeOfBody: {
+    TypeOfBody(key.argument);
+    break;
+  }
+  case QueryKind::SlotsOfFunction: {
+    SlotsOfFunction(key.argument);
+    break;
+  }
+  default: {
+    break;
+  }
+  }
+}
+
+void CompilerDatabase::Record(const QueryKey &key) {
+  if (!frames.empty()) {
+    frames.back()->push_back(key);
+  }
+}
+
+FileTokens CompilerDatabase::ComputeTokensOfFile(const std::string &file) {
+  const std::u32string &text = SourceText(file);
+  FileTokens result;
+  try {
+    LexicalAnalysis::Lexer lexer(documents.at(file), text);
+    result.list.tokens = lexer.ReadAll();
+  } catch (const std::exception &exception) {
+    result.list.tokens.clear();
+    result.list.diagnostic = exception.what();
+  }
+  return result;
+}
+
+/* A function runs from a 'func' token outside any braces to the next one.
+ * Tokens before the first function, or a file that does not lex, form an
+ * item without a name, which no function lookup reaches. */
+std::vector<FunctionItem>
+CompilerDatabase::ComputeFunctionsOfFile(const std::string &file) {
+  const TokenList &list = TokensOfFile(file).list;
+  std::vector<FunctionItem> items;
+  if (!list.diagnostic.empty()) {
+    items.emplace_back();
+    items.back().tokens.diagnostic = list.diagnostic;
+    return items;
+  }
+  int depth = 0;
+  for (const auto &token : list.tokens) {
+    if (token.tag == TokenTag::Eof) {
+      break;
+    }
+    if (items.empty() || (depth == 0 && token.tag == TokenTag::Func)) {
+      items.emplace_back();
+    }
+    items.back().tokens.tokens.push_back(token);
+    if (token.tag == TokenTag::LeftBrace) {
+      depth++;
+    } else if (token.tag == TokenTag::RightBrace && depth > 0) {
+      depth--;
+    }
+  }
+  for (auto &item : items) {
+    auto &tokens = item.tokens.tokens;
+    if (tokens.size() > 1 && tokens[0].tag == TokenTag::Func &&
+        tokens[1].tag == TokenTag::Identifier) {
+      item.name = tokens[1].text;
+    }
+    const Token &last = tokens.back();
+    tokens.emplace_back(last.sourceCodeFile, last.line,
+                        last.column + static_cast<int>(last.text.size()),
+                        TokenTag::Eof, U"");
+  }
+  return items;
+}
+
+/* Functions are numbered in file order; a name declared twice keeps its
+ * first declaration and notes where the second one is. */
+FunctionIndex CompilerDatabase::ComputeFunctions() {
+  FunctionIndex index;
+  int number = 0;
+  for (const auto &file : SourceFiles()) {
+    for (const auto &item : FunctionsOfFile(file)) {
+      if (!item.name.empty()) {
+        auto result =
+            index.insert({item.name, FunctionLocation(file, number)});
+        if (result.second) {
+          number++;
+        } else if (result.first->second.duplicate.empty()) {
+          result.first->second.duplicate = file;
+        }
+      }
+    }
+  }
+  return index;
+}
+
+/* Reads the file's tokens rather than the function's, whose positions are
+ * not kept up to date when the function moves. */
+SourcePosition
+CompilerDatabase::ComputePositionOfFunction(const std::u32string &name) {
+  const FunctionLocation &location = LocationOfFunction(name);
+  if (location.number < 0) {
+    return SourcePosition();
+  }
+  int line =
+      DeclarationLine(TokensOfFile(location.file).list.tokens, name, 0);
+  return line >= 0 ? SourcePosition(location.file, line) : SourcePosition();
+}
+
+TokenList
+CompilerDatabase::ComputeTokensOfFunction(const std::u32string &name) {
+  const FunctionLocation &location = LocationOfFunction(name);
+  if (location.number >= 0) {
+    for (const auto &item : FunctionsOfFile(location.file)) {
+      if (item.name == name) {
+        return item.tokens;
+      }
+    }
+  }
+  TokenList result;
+  result.diagnostic = UTF32ToUTF8(U"'" + name + U"' not defined.");
+  return result;
+}
+
+FunctionAst CompilerDatabase::ComputeAstOfFunction(const std::u32string &name) {
+  const TokenList &list = TokensOfFunction(name);
+  FunctionAst ast;
+  if (!list.diagnostic.empty()) {
+    ast.diagnostic = list.diagnostic;
+    return ast;
+  }
+  try {
+    ast.parser = std::make_shared<SyntaxAnalysis::Parser>(
+        list.tokens, list.tokens.front().sourceCodeFile);
+    auto function = static_cast<const LambdaExpression *>(
+        ast.parser->FunctionDeclarationStatement());
+    if (ast.parser->IsEof()) {
+      ast.function = function;
+    } else {
+      ast.diagnostic =
+          UTF32ToUTF8(U"unexpected tokens after '" + name + U"'.");
+    }
+  } catch (const std::exception &exception) {
+    ast.diagnostic = exception.what();
+  }
+  return ast;
+}
+
+const Type *
+CompilerDatabase::ComputeSignatureOfFunction(const std::u32string &name) {
+  const FunctionAst &ast = AstOfFunction(name);
+  if (!ast.function) {
+    return nullptr;
+  }
+  std::vector<const Type *> argumentTypes;
+  argumentTypes.reserve(ast.function->Parameters().size());
+  for (const auto &parameter : ast.function->Parameters()) {
+    argumentTypes.push_back(parameter->GetType());
+  }
+  return types.CreateCallableType(argumentTypes, ast.function->ReturnType());
+}
+
+/* The resolver runs without the module's functions in scope, so the result
+ * depends on the function's own tree only. */
+FunctionBindings
+CompilerDatabase::ComputeBindingsOfFunction(const std::u32string &name) {
+  const FunctionAst &ast = AstOfFunction(name);
+  FunctionBindings result;
+  if (!ast.function) {
+    result.diagnostic = ast.diagnostic;
+    return result;
+  }
+  Visitors::Scope<const Expression *> scope;
+  Visitors::NameResolver resolver;
+  resolver.CollectFreeNames();
+  try {
+    resolver.Visit(ast.function, &scope);
+    result.bindings = resolver.Bindings();
+    result.freeNames = resolver.FreeNames();
+  } catch (const std::exception &exception) {
+    result.diagnostic = exception.what();
+  }
+  return result;
+}
+
+BodyTypes CompilerDatabase::ComputeTypeOfBody(const std::u32string &name) {
+  const FunctionAst &ast = AstOfFunction(name);
+  BodyTypes result;
+  if (!ast.function) {
+    result.diagnostic = ast.diagnostic;
+    return result;
+  }
+  const FunctionBindings &bindings = BindingsOfFunction(name);
+  if (!bindings.diagnostic.empty()) {
+    result.diagnostic = bindings.diagnostic;
+    return result;
+  }
+  Visitors::Scope<const Type *> globals;
+  for (const auto &freeName : bindings.freeNames) {
+    const Type *signature = SignatureOfFunction(freeName);
+    if (!signature) {
+      result.diagnostic = UTF32ToUTF8(U"'" + freeName + U"' not defined.");
+      return result;
+    }
+    globals.Declare(freeName, signature);
+  }
+  Visitors::Scope<const Type *> scope(&globals);
+  Visitors::TypeChecker typeChecker(&bindings.bindings, &types);
+  try {
+    typeChecker.Visit(ast.function, &scope);
+    result.nodeTypes = typeChecker.NodeTypes();
+  } catch (const std::exception &exception) {
+    result.diagnostic = exception.what();
+  }
+  return result;
+}
+
+FunctionSlots
+CompilerDatabase::ComputeSlotsOfFunction(const std::u32string &name) {
+  const FunctionAst &ast = AstOfFunction(name);
+  FunctionSlots result;
+  if (!ast.function) {
+    result.diagnostic = ast.diagnostic;
+    return result;
+  }
+  const FunctionBindings &bindings = BindingsOfFunction(name);
+  if (!bindings.diagnostic.empty()) {
+    result.diagnostic = bindings.diagnostic;
+    return result;
+  }
+  Visitors::Scope<Visitors::NameInfo> globals;
+  for (const auto &freeName : bindings.freeNames) {
+    int number = LocationOfFunction(freeName).number;
+    if (number < 0) {
+      result.diagnostic = UTF32ToUTF8(U"'" + freeName + U"' not defined.");
+      return result;
+    }
+    globals.Declare(freeName, Visitors::NameInfo(
+                                  Visitors::LocationKind::Function, number));
+  }
+  Visitors::Scope<Visitors::NameInfo> scope(&globals);
+  Visitors::NameLocator nameLocator(&bindings.bindings);
+  try {
+    nameLocator.Visit(ast.function, &scope);
+    result.frame = nameLocator.FunctionFrames().at(ast.function);
+    result.nameInfoTable = nameLocator.NameInfoTable();
+  } catch (const std::exception &exception) {
+    result.diagnostic = exception.what();
+  }
+  return result;
+}
+
+}; /* namespace Driver */
+}; /* namespace Cygni */
@@ -0,0 +1,58 @@
+#include "Expressions/Literal.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include "Expressions/TreeException.hpp"
+#include "Utility/UTF32Functions.hpp"
+
+namespace Cygni {
+namespace Expressions {
+
+Literal::Literal(const ConstantExpression *node)
+    : typeCode{node->GetTypeCode()}, int64{0}, text() {
+  const std::u32string &literal =
+      *std::any_cast<std::u32string>(&node->Value());
+  try {
+    switch (typeCode) {
+    case TypeCode::Int32: {
+      long long value = std::stoll(Utility::UTF32ToUTF8(literal));
+      if (value < std::numeric_limits<int32_t>::min() ||
+          value > std::numeric_limits<int32_t>::max()) {
+        throw std::out_of_range("int32");
+      }
+      int32 = static_cast<int32_t>(value);
+      break;
+    }
+    case TypeCode::Int64: {
+      int64 = std::stoll(Utility::UTF32ToUTF8(literal));
+      break;
+    }
+    case TypeCode::Float32: {
+      float32 = std::stof(Utility::UTF32ToUTF8(literal));
+      break;
+    }
+    case TypeCode::Float64: {
+      float64 = std::stod(Utility::UTF32ToUTF8(literal));
+      break;
+    }
+    case TypeCode::Boolean: {
+      boolean = literal == U"true";
+      break;
+    }
+    case TypeCode::Char: {
+      character = literal.empty() ? U'\0' : literal.front();
+      break;
+    }
+    default: {
+      text = literal;
+      break;
+    }
+    }
+  } catch (const std::out_of_range &) {
+    throw TreeException(__FILE__, __LINE__, "literal out of range.", node,
+                        nullptr);
+  }
+}
+
+}; /* namespace Expressions */
+}; /* namespace Cygni */
@@ -1,35 +1,117 @@
 #include "Expressions/Namespace.hpp"
 
+#include <stdexcept>
+
 namespace Cygni {
 namespace Expressions {
 
+Namespace::Namespace(Namespace *parent, std::u32string name)
+    : parent{parent}, name{name} {
+  if (parent) {
+    qualifiedName = parent->QualifiedName();
+    qualifiedNameHash = parent->QualifiedNameHash();
+    Qualify(qualifiedName, qualifiedNameHash, name);
+  } else {
+    qualifiedNameHash = Utility::HashName(qualifiedName);
+  }
+}
+
+void Namespace::Qualify(std::u32string &qualifiedName, std::size_t &hash,
+                        const std::u32string &component) {
+  if (!qualifiedName.empty()) {
+    qualifiedName += U'.';
+    hash = Utility::HashName(U".", hash);
+  }
+  qualifiedName += component;
+  hash = Utility::HashName(component, hash);
+}
+
+static void QualifyPath(std::u32string &qualifiedName, std::size_t &hash,
+                        const std::vector<std::u32string> &path) {
+  for (const std::u32string &component : path) {
+    Namespace::Qualify(qualifiedName, hash, component);
+  }
+}
+
+Namespace *NamespaceFactory::Create(Namespace *parent,
+                                    const std::u32string &name) {
+  if (!parent && namespaceIndex.Size() != 0) {
+    throw std::invalid_argument("a module has a single root namespace");
+  }
+  auto ns = new Namespace(parent, name);
+  namespaces.push_back(ns);
+  if (!namespaceIndex.Insert(ns->QualifiedName(), ns->QualifiedNameHash(),
+                             ns)) {
+    throw std::invalid_argument("namespace already exists");
+  }
+  if (parent) {
+    parent->Children().Insert(name, ns);
+  }
+  return ns;
+}
+
 void NamespaceFactory::Insert(Namespace *root,
                               const std::vector<std::u32string> &path) {
-
   for (const std::u32string &name : path) {
-    if (root->Children().count(name)) {
-      root = root->Children().at(name);
+    Namespace **child = root->Children().Find(name);
+    if (child) {
+      root = *child;
     } else {
-      Namespace *ns = Create(root, name);
-      root->Children().insert({name, ns});
-      root = ns;
+      root = Create(root, name);
     }
   }
 }
 
 Namespace* NamespaceFactory::Search(Namespace *root,
                               const std::vector<std::u32string> &path) {
-  for (const std::u32string &name : path) {
-    if (root->Children().count(name)) {
-      root = root->Children().at(name);
-    } else {
+  std::u32string qualifiedName = root->QualifiedName();
+  std::size_t hash = root->QualifiedNameHash();
+  QualifyPath(qualifiedName, hash, path);
+  Namespace **ns = namespaceIndex.Find(qualifiedName, hash);
+  return ns ? *ns : nullptr;
+}
 
-        return nullptr;
-    }
+void NamespaceFactory::DefineFunction(Namespace *ns,
+                                      LambdaExpression *function) {
+  std::u32string qualifiedName = ns->QualifiedName();
+  std::size_t hash = ns->QualifiedNameHash();
+  Namespace::Qualify(qualifiedName, hash, function->Name());
+  if (!functionIndex.Insert(qualifiedName, hash, function)) {
+    throw std::invalid_argument("function already defined");
   }
+  ns->Functions().Insert(function->Name(), function);
+}
+
+void NamespaceFactory::DefineGlobalVariable(Namespace *ns,
+                                            ParameterExpression *variable) {
+  std::u32string qualifiedName = ns->QualifiedName();
+  std::size_t hash = ns->QualifiedNameHash();
+  Namespace::Qualify(qualifiedName, hash, variable->Name());
+  if (!globalVariableIndex.Insert(qualifiedName, hash, variable)) {
+    throw std::invalid_argument("global variable already defined");
+  }
+  ns->GlobalVariables().Insert(variable->Name(), variable);
+}
+
+LambdaExpression *
+NamespaceFactory::SearchFunction(Namespace *root,
+                                 const std::vector<std::u32string> &path) {
+  std::u32string qualifiedName = root->QualifiedName();
+  std::size_t hash = root->QualifiedNameHash();
+  QualifyPath(qualifiedName, hash, path);
+  LambdaExpression **function = functionIndex.Find(qualifiedName, hash);
+  return function ? *function : nullptr;
+}
 
-  return root;
+ParameterExpression *
+NamespaceFactory::SearchGlobalVariable(Namespace *root,
+                                       const std::vector<std::u32string> &path) {
+  std::u32string qualifiedName = root->QualifiedName();
+  std::size_t hash = root->QualifiedNameHash();
+  QualifyPath(qualifiedName, hash, path);
+  ParameterExpression **variable = globalVariableIndex.Find(qualifiedName, hash);
+  return variable ? *variable : nullptr;
 }
 
 }; /* namespace Expressions */
-}; /* namespace Cygni */
\ No newline at end of file
+}; /* namespace Cygni */
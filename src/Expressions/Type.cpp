@@ -1,12 +1,15 @@
 #include "Expressions/Type.hpp"
+#include <algorithm>
 #include <stdexcept>
 
 namespace Cygni {
 namespace Expressions {
 
 TypeFactory::~TypeFactory() {
-  for (auto type : types) {
-    delete type;
+  for (auto &shard : shards) {
+    for (auto &item : shard.types) {
+      delete item.second;
+    }
   }
 }
 
@@ -89,7 +92,8 @@ bool TypeFactory::AreTypesEqual(const Type *a, const Type *b) {
 }
 
 ArrayType *TypeFactory::CreateArrayType(const Type *elementType) {
-  return static_cast<ArrayType *>(CreateType(new ArrayType(elementType)));
+  return Intern<ArrayType>(TypeKey{TypeCode::Array, {elementType}},
+                           elementType);
 }
 
 const Type *TypeFactory::CreateUnionType(const Type *a, const Type *b) {
@@ -107,7 +111,7 @@ const Type *TypeFactory::CreateUnionType(const Type *a, const Type *b) {
       std::vector<const Type *> types = unionA->GetTypes();
       types.push_back(b);
 
-      return CreateType(new UnionType(types));
+      return InternUnionType(types);
     } else if (a->GetTypeCode() != TypeCode::Union &&
                b->GetTypeCode() == TypeCode::Union) {
       return CreateUnionType(b, a);
@@ -129,9 +133,9 @@ const Type *TypeFactory::CreateUnionType(const Type *a, const Type *b) {
         }
       }
 
-      return CreateType(new UnionType(types));
+      return InternUnionType(types);
     } else {
-      return CreateType(new UnionType({a, b}));
+      return InternUnionType({a, b});
     }
   }
 }
@@ -139,8 +143,9 @@ const Type *TypeFactory::CreateUnionType(const Type *a, const Type *b) {
 CallableType *
 TypeFactory::CreateCallableType(std::vector<const Type *> arguments,
                                 const Type *returnType) {
-  return static_cast<CallableType *>(
-      CreateType(new CallableType(arguments, returnType)));
+  TypeKey key{TypeCode::Callable, arguments};
+  key.components.push_back(returnType);
+  return Intern<CallableType>(std::move(key), arguments, returnType);
 }
 
 bool TypeFactory::AreOrderedTypesEqual(const std::vector<const Type *> &a,
@@ -178,9 +183,159 @@ bool TypeFactory::AreUnorderedTypesEqual(const std::vector<const Type *> &a,
   }
 }
 
-Type *TypeFactory::CreateType(Type *type) {
-  types.push_back(type);
-  return type;
+/* Unions are keyed by their members in address order, so the same members
+ * in a different order intern to one type. */
+const Type *TypeFactory::InternUnionType(std::vector<const Type *> types) {
+  TypeKey key{TypeCode::Union, types};
+  std::sort(key.components.begin(), key.components.end());
+  return Intern<UnionType>(std::move(key), types);
+}
+
+bool TypeRelationCache::AreTypesEqual(const Type *a, const Type *b) {
+  if (a == b) {
+    return true;
+  } else if (TypeFactory::IsBasicType(a->GetTypeCode()) ||
+             TypeFactory::IsBasicType(b->GetTypeCode())) {
+    return a->GetTypeCode() == b->GetTypeCode();
+  } else {
+    TypePair key = a < b ? TypePair(a, b) : TypePair(b, a);
+    auto it = equalities.find(key);
+    if (it != equalities.end()) {
+      hits++;
+      return it->second;
+    } else {
+      misses++;
+      bool result = ComputeEquality(a, b);
+      equalities.insert({key, result});
+      return result;
+    }
+  }
+}
+
+bool TypeRelationCache::IsAssignable(const Type *source, const Type *target) {
+  if (source == target) {
+    return true;
+  } else if (TypeFactory::IsBasicType(source->GetTypeCode()) &&
+             TypeFactory::IsBasicType(target->GetTypeCode())) {
+    return source->GetTypeCode() == target->GetTypeCode();
+  } else {
+    TypePair key(source, target);
+    auto it = assignabilities.find(key);
+    if (it != assignabilities.end()) {
+      hits++;
+      return it->second;
+    } else {
+      misses++;
+      bool result = ComputeAssignability(source, target);
+      assignabilities.insert({key, result});
+      return result;
+    }
+  }
+}
+
+void TypeRelationCache::Clear() {
+  equalities.clear();
+  assignabilities.clear();
+  hits = 0;
+  misses = 0;
+}
+
+bool TypeRelationCache::ComputeEquality(const Type *a, const Type *b) {
+  if (a->GetTypeCode() == b->GetTypeCode()) {
+    if (a->GetTypeCode() == TypeCode::Array) {
+      return AreTypesEqual(static_cast<const ArrayType *>(a)->ElementType(),
+                           static_cast<const ArrayType *>(b)->ElementType());
+    } else if (a->GetTypeCode() == TypeCode::Callable) {
+      auto callableA = static_cast<const CallableType *>(a);
+      auto callableB = static_cast<const CallableType *>(b);
+      return AreOrderedTypesEqual(callableA->Arguments(),
+                                  callableB->Arguments()) &&
+             AreTypesEqual(callableA->GetReturnType(),
+                           callableB->GetReturnType());
+    } else if (a->GetTypeCode() == TypeCode::Union) {
+      auto unionA = static_cast<const UnionType *>(a);
+      auto unionB = static_cast<const UnionType *>(b);
+      return AreUnorderedTypesEqual(unionA->GetTypes(), unionB->GetTypes());
+    } else {
+      throw std::invalid_argument("not supported type");
+    }
+  } else {
+    return false;
+  }
+}
+
+bool TypeRelationCache::ComputeAssignability(const Type *source,
+                                             const Type *target) {
+  if (AreTypesEqual(source, target)) {
+    return true;
+  } else if (source->GetTypeCode() == TypeCode::Union) {
+    for (auto type : static_cast<const UnionType *>(source)->GetTypes()) {
+      if (!IsAssignable(type, target)) {
+        return false;
+      }
+    }
+    return true;
+  } else if (target->GetTypeCode() == TypeCode::Union) {
+    for (auto type : static_cast<const UnionType *>(target)->GetTypes()) {
+      if (IsAssignable(source, type)) {
+        return true;
+      }
+    }
+    return false;
+  } else if (source->GetTypeCode() == TypeCode::Callable &&
+             target->GetTypeCode() == TypeCode::Callable) {
+    auto callableSource = static_cast<const CallableType *>(source);
+    auto callableTarget = static_cast<const CallableType *>(target);
+    if (callableSource->Arguments().size() !=
+        callableTarget->Arguments().size()) {
+      return false;
+    }
+    for (size_t i = 0; i < callableSource->Arguments().size(); i++) {
+      if (!IsAssignable(callableTarget->Arguments()[i],
+                        callableSource->Arguments()[i])) {
+        return false;
+      }
+    }
+    return IsAssignable(callableSource->GetReturnType(),
+                        callableTarget->GetReturnType());
+  } else {
+    return false;
+  }
+}
+
+bool TypeRelationCache::AreOrderedTypesEqual(
+    const std::vector<const Type *> &a, const std::vector<const Type *> &b) {
+  if (a.size() == b.size()) {
+    for (size_t i = 0; i < a.size(); i++) {
+      if (!AreTypesEqual(a[i], b[i])) {
+        return false;
+      }
+    }
+    return true;
+  } else {
+    return false;
+  }
+}
+
+bool TypeRelationCache::AreUnorderedTypesEqual(
+    const std::vector<const Type *> &a, const std::vector<const Type *> &b) {
+  if (a.size() == b.size()) {
+    for (size_t i = 0; i < a.size(); i++) {
+      bool found = false;
+      for (size_t j = 0; j < b.size(); j++) {
+        if (AreTypesEqual(a[i], b[j])) {
+          found = true;
+          break;
+        }
+      }
+      if (!found) {
+        return false;
+      }
+    }
+    return true;
+  } else {
+    return false;
+  }
 }
 
 }; /* namespace Expressions */
@@ -0,0 +1,392 @@
+#include "Interpreter/Bytecode.hpp"
+
+#include <sstream>
+
+namespace Cygni {
+namespace Interpreter {
+
+const char *OpCodeName(OpCode opCode) {
+  switch (opCode) {
+  case OpCode::PushConstant:
+    return "PushConstant";
+  case OpCode::PushString:
+    return "PushString";
+  case OpCode::PushDefault:
+    return "PushDefault";
+  case OpCode::PushFunction:
+    return "PushFunction";
+  case OpCode::LoadLocal:
+    return "LoadLocal";
+  case OpCode::StoreLocal:
+    return "StoreLocal";
+  case OpCode::LoadGlobal:
+    return "LoadGlobal";
+  case OpCode::StoreGlobal:
+    return "StoreGlobal";
+  case OpCode::Pop:
+    return "Pop";
+  case OpCode::Add:
+    return "Add";
+  case OpCode::Subtract:
+    return "Subtract";
+  case OpCode::Multiply:
+    return "Multiply";
+  case OpCode::Divide:
+    return "Divide";
+  case OpCode::Equal:
+    return "Equal";
+  case OpCode::NotEqual:
+    return "NotEqual";
+  case OpCode::LessThan:
+    return "LessThan";
+  case OpCode::LessThanOrEqual:
+    return "LessThanOrEqual";
+  case OpCode::GreaterThan:
+    return "GreaterThan";
+  case OpCode::GreaterThanOrEqual:
+    return "GreaterThanOrEqual";
+  case OpCode::Not:
+    return "Not";
+  case OpCode::Jump:
+    return "Jump";
+  case OpCode::JumpIfFalse:
+    return "JumpIfFalse";
+  case OpCode::Call:
+    return "Call";
+  case OpCode::CallIndirect:
+    return "CallIndirect";
+  case OpCode::TailCall:
+    return "TailCall";
+  case OpCode::Return:
+    return "Return";
+  case OpCode::AddInt32:
+    return "AddInt32";
+  case OpCode::SubtractInt32:
+    return "SubtractInt32";
+  case OpCode::MultiplyInt32:
+    return "MultiplyInt32";
+  case OpCode::DivideInt32:
+    return "DivideInt32";
+  case OpCode::EqualInt32:
+    return "EqualInt32";
+  case OpCode::NotEqualInt32:
+    return "NotEqualInt32";
+  case OpCode::LessThanInt32:
+    return "LessThanInt32";
+  case OpCode::LessThanOrEqualInt32:
+    return "LessThanOrEqualInt32";
+  case OpCode::GreaterThanInt32:
+    return "GreaterThanInt32";
+  case OpCode::GreaterThanOrEqualInt32:
+    return "GreaterThanOrEqualInt32";
+  case OpCode::AddInt64:
+    return "AddInt64";
+  case OpCode::SubtractInt64:
+    return "SubtractInt64";
+  case OpCode::MultiplyInt64:
+    return "MultiplyInt64";
+  case OpCode::DivideInt64:
+    return "DivideInt64";
+  case OpCode::EqualInt64:
+    return "EqualInt64";
+  case OpCode::NotEqualInt64:
+    return "NotEqualInt64";
+  case OpCode::LessThanInt64:
+    return "LessThanInt64";
+  case OpCode::LessThanOrEqualInt64:
+    return "LessThanOrEqualInt64";
+  case OpCode::GreaterThanInt64:
+    return "GreaterThanInt64";
+  case OpCode::GreaterThanOrEqualInt64:
+    return "GreaterThanOrEqualInt64";
+  case OpCode::AddFloat32:
+    return "AddFloat32";
+  case OpCode::SubtractFloat32:
+    return "SubtractFloat32";
+  case OpCode::MultiplyFloat32:
+    return "MultiplyFloat32";
+  case OpCode::DivideFloat32:
+    return "DivideFloat32";
+  case OpCode::EqualFloat32:
+    return "EqualFloat32";
+  case OpCode::NotEqualFloat32:
+    return "NotEqualFloat32";
+  case OpCode::LessThanFloat32:
+    return "LessThanFloat32";
+  case OpCode::LessThanOrEqualFloat32:
+    return "LessThanOrEqualFloat32";
+  case OpCode::GreaterThanFloat32:
+    return "GreaterThanFloat32";
+  case OpCode::GreaterThanOrEqualFloat32:
+    return "GreaterThanOrEqualFloat32";
+  case OpCode::AddFloat64:
+    return "AddFloat64";
+  case OpCode::SubtractFloat64:
+    return "SubtractFloat64";
+  case OpCode::MultiplyFloat64:
+    return "MultiplyFloat64";
+  case OpCode::DivideFloat64:
+    return "DivideFloat64";
+  case OpCode::EqualFloat64:
+    return "EqualFloat64";
+  case OpCode::NotEqualFloat64:
+    return "NotEqualFloat64";
+  case OpCode::LessThanFloat64:
+    return "LessThanFloat64";
+  case OpCode::LessThanOrEqualFloat64:
+    return "LessThanOrEqualFloat64";
+  case OpCode::GreaterThanFloat64:
+    return "GreaterThanFloat64";
+  case OpCode::GreaterThanOrEqualFloat64:
+    return "GreaterThanOrEqualFloat64";
+  case OpCode::QuickAddInt32:
+    return "QuickAddInt32";
+  case OpCode::QuickSubtractInt32:
+    return "QuickSubtractInt32";
+  case OpCode::QuickMultiplyInt32:
+    return "QuickMultiplyInt32";
+  case OpCode::QuickDivideInt32:
+    return "QuickDivideInt32";
+  case OpCode::QuickEqualInt32:
+    return "QuickEqualInt32";
+  case OpCode::QuickNotEqualInt32:
+    return "QuickNotEqualInt32";
+  case OpCode::QuickLessThanInt32:
+    return "QuickLessThanInt32";
+  case OpCode::QuickLessThanOrEqualInt32:
+    return "QuickLessThanOrEqualInt32";
+  case OpCode::QuickGreaterThanInt32:
+    return "QuickGreaterThanInt32";
+  case OpCode::QuickGreaterThanOrEqualInt32:
+    return "QuickGreaterThanOrEqualInt32";
+  case OpCode::QuickAddInt64:
+    return "QuickAddInt64";
+  case OpCode::QuickSubtractInt64:
+    return "QuickSubtractInt64";
+  case OpCode::QuickMultiplyInt64:
+    return "QuickMultiplyInt64";
+  case OpCode::QuickDivideInt64:
+    return "QuickDivideInt64";
+  case OpCode::QuickEqualInt64:
+    return "QuickEqualInt64";
+  case OpCode::QuickNotEqualInt64:
+    return "QuickNotEqualInt64";
+  case OpCode::QuickLessThanInt64:
+    return "QuickLessThanInt64";
+  case OpCode::QuickLessThanOrEqualInt64:
+    return "QuickLessThanOrEqualInt64";
+  case OpCode::QuickGreaterThanInt64:
+    return "QuickGreaterThanInt64";
+  case OpCode::QuickGreaterThanOrEqualInt64:
+    return "QuickGreaterThanOrEqualInt64";
+  case OpCode::QuickAddFloat32:
+    return "QuickAddFloat32";
+  case OpCode::QuickSubtractFloat32:
+    return "QuickSubtractFloat32";
+  case OpCode::QuickMultiplyFloat32:
+    return "QuickMultiplyFloat32";
+  case OpCode::QuickDivideFloat32:
+    return "QuickDivideFloat32";
+  case OpCode::QuickEqualFloat32:
+    return "QuickEqualFloat32";
+  case OpCode::QuickNotEqualFloat32:
+    return "QuickNotEqualFloat32";
+  case OpCode::QuickLessThanFloat32:
+    return "QuickLessThanFloat32";
+  case OpCode::QuickLessThanOrEqualFloat32:
+    return "QuickLessThanOrEqualFloat32";
+  case OpCode::QuickGreaterThanFloat32:
+    return "QuickGreaterThanFloat32";
+  case OpCode::QuickGreaterThanOrEqualFloat32:
+    return "QuickGreaterThanOrEqualFloat32";
+  case OpCode::QuickAddFloat64:
+    return "QuickAddFloat64";
+  case OpCode::QuickSubtractFloat64:
+    return "QuickSubtractFloat64";
+  case OpCode::QuickMultiplyFloat64:
+    return "QuickMultiplyFloat64";
+  case OpCode::QuickDivideFloat64:
+    return "QuickDivideFloat64";
+  case OpCode::QuickEqualFloat64:
+    return "QuickEqualFloat64";
+  case OpCode::QuickNotEqualFloat64:
+    return "QuickNotEqualFloat64";
+  case OpCode::QuickLessThanFloat64:
+    return "QuickLessThanFloat64";
+  case OpCode::QuickLessThanOrEqualFloat64:
+    return "QuickLessThanOrEqualFloat64";
+  case OpCode::QuickGreaterThanFloat64:
+    return "QuickGreaterThanFloat64";
+  case OpCode::QuickGreaterThanOrEqualFloat64:
+    return "QuickGreaterThanOrEqualFloat64";
+  case OpCode::IncrementLocalInt32:
+    return "IncrementLocalInt32";
+  case OpCode::JumpIfNotLessLocalInt32:
+    return "JumpIfNotLessLocalInt32";
+  case OpCode::JumpIfNotLessConstantInt32:
+    return "JumpIfNotLessConstantInt32";
+  case OpCode::LoadLocalLoadLocal:
+    return "LoadLocalLoadLocal";
+  case OpCode::LoadLocalPushConstant:
+    return "LoadLocalPushConstant";
+  case OpCode::StoreLocalJump:
+    return "StoreLocalJump";
+  default:
+    return "Unknown";
+  }
+}
+
+namespace {
+
+constexpr int OperatorCount = static_cast<int>(OpCode::GreaterThanOrEqual) -
+                              static_cast<int>(OpCode::Add) + 1;
+
+int NumericIndex(TypeCode typeCode) {
+  switch (typeCode) {
+  case TypeCode::Int32:
+    return 0;
+  case TypeCode::Int64:
+    return 1;
+  case TypeCode::Float32:
+    return 2;
+  case TypeCode::Float64:
+    return 3;
+  default:
+    return -1;
+  }
+}
+
+OpCode Specialize(OpCode generic, TypeCode typeCode, OpCode first) {
+  int index = NumericIndex(typeCode);
+  if (generic < OpCode::Add || generic > OpCode::GreaterThanOrEqual ||
+      index < 0) {
+    return generic;
+  }
+  return static_cast<OpCode>(static_cast<int>(first) + index * OperatorCount +
+                             static_cast<int>(generic) -
+                             static_cast<int>(OpCode::Add));
+}
+
+}; /* namespace */
+
+OpCode SpecializedOpCode(OpCode generic, TypeCode typeCode) {
+  return Specialize(generic, typeCode, OpCode::AddInt32);
+}
+
+OpCode QuickenedOpCode(OpCode generic, TypeCode typeCode) {
+  return Specialize(generic, typeCode, OpCode::QuickAddInt32);
+}
+
+OpCode GenericOpCode(OpCode typed) {
+  return static_cast<OpCode>(
+      static_cast<int>(OpCode::Add) +
+      (static_cast<int>(typed) - static_cast<int>(OpCode::AddInt32)) %
+          OperatorCount);
+}
+
+const std::vector<Superinstruction> &Superinstructions() {
+  static const std::vector<Superinstruction> superinstructions = {
+      {OpCode::IncrementLocalInt32,
+       {OpCode::LoadLocal, OpCode::PushConstant,
+        OpCode::AddInt32, OpCode::StoreLocal}},
+      {OpCode::JumpIfNotLessLocalInt32,
+       {OpCode::LoadLocal, OpCode::LoadLocal,
+        OpCode::LessThanInt32, OpCode::JumpIfFalse}},
+      {OpCode::JumpIfNotLessConstantInt32,
+       {OpCode::LoadLocal, OpCode::PushConstant,
+        OpCode::LessThanInt32, OpCode::JumpIfFalse}},
+      {OpCode::LoadLocalLoadLocal,
+       {OpCode::LoadLocal, OpCode::LoadLocal}},
+      {OpCode::LoadLocalPushConstant,
+       {OpCode::LoadLocal, OpCode::PushConstant}},
+      {OpCode::StoreLocalJump,
+       {OpCode::StoreLocal, OpCode::Jump}}};
+  return superinstructions;
+}
+
+std::vector<DecodedInstruction> Decode(const BytecodeFunction &function) {
+  std::vector<DecodedInstruction> instructions;
+  const uint8_t *start = function.code.data();
+  const uint8_t *ip = start;
+  while (ip < start + function.code.size()) {
+    DecodedInstruction instruction{static_cast<OpCode>(*ip),
+                                   static_cast<size_t>(ip - start), 0};
+    ip++;
+    switch (instruction.opCode) {
+    case OpCode::PushConstant:
+    case OpCode::PushString:
+    case OpCode::PushDefault:
+    case OpCode::LoadLocal:
+    case OpCode::StoreLocal:
+    case OpCode::LoadGlobal:
+    case OpCode::StoreGlobal:
+    case OpCode::PushFunction:
+    case OpCode::Call:
+    case OpCode::CallIndirect:
+    case OpCode::TailCall: {
+      instruction.operand = ReadOperand(ip);
+      break;
+    }
+    case OpCode::Jump:
+    case OpCode::JumpIfFalse: {
+      int32_t offset = ReadOffset(ip);
+      instruction.operand = static_cast<uint32_t>((ip - start) + offset);
+      break;
+    }
+    default: {
+      break;
+    }
+    }
+    instructions.push_back(instruction);
+  }
+  return instructions;
+}
+
+/* One instruction per line: its offset, name and operands. Jumps show their
+ * target offset. */
+std::string Disassemble(const BytecodeFunction &function) {
+  std::ostringstream stream;
+  const uint8_t *start = function.code.data();
+  const uint8_t *ip = start;
+  const uint8_t *end = start + function.code.size();
+  while (ip < end) {
+    stream << (ip - start) << ": ";
+    OpCode opCode = static_cast<OpCode>(*ip++);
+    stream << OpCodeName(opCode);
+    switch (opCode) {
+    case OpCode::PushConstant: {
+      uint32_t index = ReadOperand(ip);
+      stream << " " << index << " ("
+             << function.constants.at(index).ToString() << ")";
+      break;
+    }
+    case OpCode::PushString:
+    case OpCode::PushDefault:
+    case OpCode::LoadLocal:
+    case OpCode::StoreLocal:
+    case OpCode::LoadGlobal:
+    case OpCode::StoreGlobal:
+    case OpCode::PushFunction:
+    case OpCode::Call:
+    case OpCode::CallIndirect:
+    case OpCode::TailCall: {
+      stream << " " << ReadOperand(ip);
+      break;
+    }
+    case OpCode::Jump:
+    case OpCode::JumpIfFalse: {
+      int32_t offset = ReadOffset(ip);
+      stream << " " << (ip - start) + offset;
+      break;
+    }
+    default: {
+      break;
+    }
+    }
+    stream << "\n";
+  }
+  return stream.str();
+}
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
@@ -0,0 +1,376 @@
+#include "Interpreter/BytecodeCompiler.hpp"
+
+#include <algorithm>
+#include "Utility/UTF32Functions.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+using Visitors::LeftSpine;
+using Visitors::LocationKind;
+using Visitors::NameInfo;
+
+namespace {
+
+bool IsEmpty(const Type *type) {
+  return type->GetTypeCode() == TypeCode::Empty;
+}
+
+OpCode BinaryOpCode(const BinaryExpression *node) {
+  switch (node->NodeType()) {
+  case ExpressionType::Add:
+    return OpCode::Add;
+  case ExpressionType::Subtract:
+    return OpCode::Subtract;
+  case ExpressionType::Multiply:
+    return OpCode::Multiply;
+  case ExpressionType::Divide:
+    return OpCode::Divide;
+  case ExpressionType::Equal:
+    return OpCode::Equal;
+  case ExpressionType::NotEqual:
+    return OpCode::NotEqual;
+  case ExpressionType::LessThan:
+    return OpCode::LessThan;
+  case ExpressionType::LessThanOrEqual:
+    return OpCode::LessThanOrEqual;
+  case ExpressionType::GreaterThan:
+    return OpCode::GreaterThan;
+  case ExpressionType::GreaterThanOrEqual:
+    return OpCode::GreaterThanOrEqual;
+  default:
+    throw TreeException(__FILE__, __LINE__,
+                        "The operator is not supported by the interpreter.",
+                        node, nullptr);
+  }
+}
+
+}; /* namespace */
+
+BytecodeCompiler::BytecodeCompiler(Driver::CompilerDatabase *database)
+    : database{database}, module(), lambdas(), stringNumbers(),
+      function{nullptr}, bodyTypes{nullptr}, slots{nullptr}, stackDepth{0} {}
+
+BytecodeModule BytecodeCompiler::Compile() {
+  const Driver::FunctionIndex &index = database->Functions();
+  module.functions.resize(index.size());
+  lambdas.resize(index.size());
+  for (const auto &item : index) {
+    const std::u32string &name = item.first;
+    const Driver::FunctionAst &ast = database->AstOfFunction(name);
+    std::string diagnostic = database->DiagnosticOfFunction(name);
+    if (!diagnostic.empty()) {
+      throw Utility::Exception(__FILE__, __LINE__, diagnostic, nullptr);
+    }
+    int number = item.second.number;
+    BytecodeFunction &compiled = module.functions.at(number);
+    compiled.name = name;
+    compiled.parameterCount =
+        static_cast<int>(ast.function->Parameters().size());
+    for (const auto &parameter : ast.function->Parameters()) {
+      compiled.parameterTypes.push_back(parameter->GetType()->GetTypeCode());
+    }
+    compiled.returnType = ast.function->ReturnType()->GetTypeCode();
+    lambdas.at(number) = ast.function;
+    module.functionNumbers[name] = number;
+  }
+  for (const auto &item : index) {
+    CompileFunction(item.first, item.second.number);
+  }
+  return std::move(module);
+}
+
+void BytecodeCompiler::VisitBinary(const BinaryExpression *node) {
+  if (node->NodeType() == ExpressionType::Assign) {
+    Assign(node);
+  } else {
+    auto spine = LeftSpine(node);
+    Visit(spine.back()->Left());
+    for (auto it = spine.rbegin(); it != spine.rend(); it++) {
+      Visit((*it)->Right());
+      Emit(SpecializedOpCode(BinaryOpCode(*it),
+                             TypeOf((*it)->Right())->GetTypeCode()),
+           -1);
+    }
+  }
+}
+
+void BytecodeCompiler::VisitConstant(const ConstantExpression *node) {
+  if (node->GetTypeCode() == TypeCode::String) {
+    const std::u32string &text =
+        *std::any_cast<std::u32string>(&node->Value());
+    auto it = stringNumbers.find(text);
+    if (it == stringNumbers.end()) {
+      it = stringNumbers
+               .insert({text, static_cast<int>(module.strings.size())})
+               .first;
+      module.strings.push_back(ConstantValue(node));
+    }
+    Emit(OpCode::PushString, it->second, 1);
+  } else {
+    Emit(OpCode::PushConstant, Locate(node).number, 1);
+  }
+}
+
+void BytecodeCompiler::VisitParameter(const ParameterExpression *node) {
+  const NameInfo &nameInfo = Locate(node);
+  if (IsEmpty(TypeOf(node))) {
+    return;
+  } else if (nameInfo.kind == LocationKind::FunctionVariable) {
+    Emit(OpCode::LoadLocal, nameInfo.number, 1);
+  } else if (nameInfo.kind == LocationKind::Global) {
+    Emit(OpCode::LoadGlobal, nameInfo.number, 1);
+  } else {
+    Emit(OpCode::PushFunction, nameInfo.number, 1);
+  }
+}
+
+void BytecodeCompiler::VisitBlock(const BlockExpression *node) {
+  const auto &expressions = node->Expressions();
+  for (size_t i = 0; i < expressions.size(); i++) {
+    Visit(expressions[i]);
+    if (i + 1 < expressions.size() && !IsEmpty(TypeOf(expressions[i]))) {
+      Emit(OpCode::Pop, -1);
+    }
+  }
+}
+
+void BytecodeCompiler::VisitConditional(const ConditionalExpression *node) {
+  const Type *type = TypeOf(node);
+  Visit(node->Test());
+  size_t ifFalse = EmitJump(OpCode::JumpIfFalse, -1);
+  Visit(node->IfTrue());
+  Coerce(node, TypeOf(node->IfTrue()), type);
+  size_t end = EmitJump(OpCode::Jump, 0);
+  PatchJump(ifFalse);
+  if (!IsEmpty(type)) {
+    stackDepth--;
+  }
+  Visit(node->IfFalse());
+  Coerce(node, TypeOf(node->IfFalse()), type);
+  PatchJump(end);
+}
+
+void BytecodeCompiler::VisitUnary(const UnaryExpression *node) {
+  if (node->NodeType() == ExpressionType::Not) {
+    Visit(node->Operand());
+    Emit(OpCode::Not, 0);
+  } else {
+    throw TreeException(__FILE__, __LINE__,
+                        "The operator is not supported by the interpreter.",
+                        node, nullptr);
+  }
+}
+
+/* A function called by name is bound here; any other callee is a value,
+ * evaluated first. The arguments follow in order and become the first
+ * slots of the callee's frame. */
+void BytecodeCompiler::VisitCall(const CallExpression *node) {
+  const Expression *callee = node->Function();
+  bool direct = callee->NodeType() == ExpressionType::Parameter &&
+                Locate(callee).kind == LocationKind::Function;
+  if (!direct) {
+    Visit(callee);
+  }
+  auto type = static_cast<const CallableType *>(TypeOf(callee));
+  int argumentCount = static_cast<int>(node->Arguments().size());
+  for (int i = 0; i < argumentCount; i++) {
+    const Expression *argument = node->Arguments()[i];
+    Visit(argument);
+    Coerce(argument, TypeOf(argument), type->Arguments().at(i));
+  }
+  if (direct && tailCalls.count(node)) {
+    Emit(OpCode::TailCall, Locate(callee).number, 1 - argumentCount);
+  } else if (direct) {
+    Emit(OpCode::Call, Locate(callee).number, 1 - argumentCount);
+  } else {
+    Emit(OpCode::CallIndirect, argumentCount, -argumentCount);
+  }
+}
+
+void BytecodeCompiler::VisitLambda(const LambdaExpression *node) {
+  throw TreeException(__FILE__, __LINE__,
+                      "Nested functions are not supported by the interpreter.",
+                      node, nullptr);
+}
+
+/* The loop's value stays on the stack below the operands of each iteration
+ * and is replaced by every run of the body. */
+void BytecodeCompiler::VisitLoop(const LoopExpression *node) {
+  Visit(node->Initializer());
+  if (!IsEmpty(TypeOf(node->Initializer()))) {
+    Emit(OpCode::Pop, -1);
+  }
+  const Type *type = TypeOf(node->Body());
+  if (!IsEmpty(type)) {
+    Emit(OpCode::PushDefault, static_cast<uint32_t>(type->GetTypeCode()), 1);
+  }
+  size_t start = function->code.size();
+  Visit(node->Condition());
+  size_t end = EmitJump(OpCode::JumpIfFalse, -1);
+  if (!IsEmpty(type)) {
+    Emit(OpCode::Pop, -1);
+  }
+  Visit(node->Body());
+  EmitJumpBack(start);
+  PatchJump(end);
+}
+
+void BytecodeCompiler::VisitDefault(const DefaultExpression *node) {
+  const Type *type = TypeOf(node);
+  if (!IsEmpty(type)) {
+    Emit(OpCode::PushDefault, static_cast<uint32_t>(type->GetTypeCode()), 1);
+  }
+}
+
+void BytecodeCompiler::VisitVariableDeclaration(
+    const VariableDeclarationExpression *node) {
+  Visit(node->Initializer());
+  if (!IsEmpty(TypeOf(node->Initializer()))) {
+    Store(node, Locate(node));
+  }
+}
+
+void BytecodeCompiler::CompileFunction(const std::u32string &name,
+                                       int number) {
+  const LambdaExpression *lambda = lambdas.at(number);
+  function = &module.functions.at(number);
+  bodyTypes = &database->TypeOfBody(name);
+  slots = &database->SlotsOfFunction(name);
+  function->frameSize = slots->frame.frameSize;
+  for (const auto &constant : slots->frame.constants.Constants()) {
+    function->constants.push_back(ConstantValue(constant));
+  }
+  stackDepth = 0;
+  tailCalls.clear();
+  FindTailCalls(lambda->Body(), lambda->ReturnType());
+  Visit(lambda->Body());
+  Coerce(lambda, TypeOf(lambda->Body()), lambda->ReturnType());
+  if (IsEmpty(lambda->ReturnType())) {
+    Emit(OpCode::PushDefault, static_cast<uint32_t>(TypeCode::Empty), 1);
+  }
+  Emit(OpCode::Return, -1);
+}
+
+const Type *BytecodeCompiler::TypeOf(const Expression *node) const {
+  return bodyTypes->nodeTypes.at(node);
+}
+
+const NameInfo &BytecodeCompiler::Locate(const Expression *node) const {
+  return slots->nameInfoTable.at(node);
+}
+
+void BytecodeCompiler::Assign(const BinaryExpression *node) {
+  const Type *type = TypeOf(node->Left());
+  Visit(node->Right());
+  Coerce(node, TypeOf(node->Right()), type);
+  if (!IsEmpty(type)) {
+    Store(node, Locate(node->Left()));
+  }
+}
+
+/* Values carry their type code, so a value flowing into a union needs no
+ * boxing; only a missing Empty value has to be materialized. */
+void BytecodeCompiler::Coerce(const Expression *node, const Type *from,
+                              const Type *to) {
+  if (TypeFactory::AreTypesEqual(from, to)) {
+    return;
+  } else if (to->GetTypeCode() == TypeCode::Union) {
+    if (IsEmpty(from)) {
+      Emit(OpCode::PushDefault, static_cast<uint32_t>(TypeCode::Empty), 1);
+    }
+  } else {
+    throw TreeException(__FILE__, __LINE__, "type mismatch error.", node,
+                        nullptr);
+  }
+}
+
+/* Whether Coerce() emits no code. */
+bool BytecodeCompiler::CoercesFreely(const Type *from, const Type *to) const {
+  return TypeFactory::AreTypesEqual(from, to) ||
+         (to->GetTypeCode() == TypeCode::Union && !IsEmpty(from));
+}
+
+/* Collects the calls whose value becomes the function's result with no
+ * code after them: the last expression of a block and the branches of a
+ * conditional, in tail position themselves, where no coercion intervenes.
+ * 'type' is what the value of 'node' is coerced to. */
+void BytecodeCompiler::FindTailCalls(const Expression *node,
+                                     const Type *type) {
+  if (!CoercesFreely(TypeOf(node), type)) {
+    return;
+  }
+  switch (node->NodeType()) {
+  case ExpressionType::Block: {
+    const auto &expressions =
+        static_cast<const BlockExpression *>(node)->Expressions();
+    if (!expressions.empty()) {
+      FindTailCalls(expressions.back(), type);
+    }
+    break;
+  }
+  case ExpressionType::Conditional: {
+    auto conditional = static_cast<const ConditionalExpression *>(node);
+    FindTailCalls(conditional->IfTrue(), TypeOf(node));
+    FindTailCalls(conditional->IfFalse(), TypeOf(node));
+    break;
+  }
+  case ExpressionType::Call: {
+    if (!IsEmpty(TypeOf(node))) {
+      tailCalls.insert(static_cast<const CallExpression *>(node));
+    }
+    break;
+  }
+  default: {
+    break;
+  }
+  }
+}
+
+void BytecodeCompiler::Store(const Expression *node,
+                             const NameInfo &nameInfo) {
+  if (nameInfo.kind == LocationKind::FunctionVariable) {
+    Emit(OpCode::StoreLocal, nameInfo.number, -1);
+  } else if (nameInfo.kind == LocationKind::Global) {
+    Emit(OpCode::StoreGlobal, nameInfo.number, -1);
+  } else {
+    throw TreeException(__FILE__, __LINE__,
+                        "Only variables can be assigned by the interpreter.",
+                        node, nullptr);
+  }
+}
+
+void BytecodeCompiler::Emit(OpCode opCode, int stackEffect) {
+  function->code.push_back(static_cast<uint8_t>(opCode));
+  stackDepth += stackEffect;
+  function->maxStack = std::max(function->maxStack, stackDepth);
+}
+
+void BytecodeCompiler::Emit(OpCode opCode, uint32_t operand,
+                            int stackEffect) {
+  Emit(opCode, stackEffect);
+  WriteOperand(function->code, operand);
+}
+
+size_t BytecodeCompiler::EmitJump(OpCode opCode, int stackEffect) {
+  Emit(opCode, stackEffect);
+  size_t jump = function->code.size();
+  function->code.insert(function->code.end(), sizeof(int32_t), 0);
+  return jump;
+}
+
+void BytecodeCompiler::PatchJump(size_t jump) {
+  int32_t offset = static_cast<int32_t>(function->code.size() -
+                                        (jump + sizeof(int32_t)));
+  std::memcpy(function->code.data() + jump, &offset, sizeof(offset));
+}
+
+void BytecodeCompiler::EmitJumpBack(size_t target) {
+  size_t jump = EmitJump(OpCode::Jump, 0);
+  int32_t offset = static_cast<int32_t>(target) -
+                   static_cast<int32_t>(jump + sizeof(int32_t));
+  std::memcpy(function->code.data() + jump, &offset, sizeof(offset));
+}
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
@@ -0,0 +1,611 @@
+#include "Interpreter/ClosureInterpreter.hpp"
+
+#include <type_traits>
+#include "Interpreter/Arithmetic.hpp"
+#include "Utility/UTF32Functions.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+using Visitors::LeftSpine;
+using Visitors::LocationKind;
+using Visitors::NameInfo;
+
+namespace {
+
+template <typename T> class TypeTag {
+public:
+  using type = T;
+};
+
+/* Calls 'function' with the tag of the C++ type representing 'type'. This
+ * is the only place compiled code is chosen by type. */
+template <typename TFunction>
+auto Dispatch(const Expression *node, const Type *type, TFunction function)
+    -> decltype(function(TypeTag<void>())) {
+  switch (type->GetTypeCode()) {
+  case TypeCode::Int32:
+    return function(TypeTag<int32_t>());
+  case TypeCode::Int64:
+    return function(TypeTag<int64_t>());
+  case TypeCode::Float32:
+    return function(TypeTag<float>());
+  case TypeCode::Float64:
+    return function(TypeTag<double>());
+  case TypeCode::Boolean:
+    return function(TypeTag<bool>());
+  case TypeCode::Char:
+    return function(TypeTag<char32_t>());
+  case TypeCode::String:
+    return function(TypeTag<String>());
+  case TypeCode::Empty:
+    return function(TypeTag<void>());
+  case TypeCode::Union:
+    return function(TypeTag<Value>());
+  default:
+    throw TreeException(__FILE__, __LINE__,
+                        "The type is not supported by the interpreter.", node,
+                        nullptr);
+  }
+}
+
+template <typename T> T &As(Value &value);
+template <> int32_t &As<int32_t>(Value &value) { return value.int32; }
+template <> int64_t &As<int64_t>(Value &value) { return value.int64; }
+template <> float &As<float>(Value &value) { return value.float32; }
+template <> double &As<double>(Value &value) { return value.float64; }
+template <> bool &As<bool>(Value &value) { return value.boolean; }
+template <> char32_t &As<char32_t>(Value &value) { return value.character; }
+template <> String &As<String>(Value &value) { return value.string; }
+template <> Value &As<Value>(Value &value) { return value; }
+
+template <typename T> T DefaultValue() { return T(); }
+template <> String DefaultValue<String>() {
+  static const String empty = std::make_shared<const std::u32string>();
+  return empty;
+}
+
+template <typename T> Closure<T> Get(const Code &code) {
+  return std::any_cast<Closure<T>>(code.closure);
+}
+
+template <typename T>
+Closure<Value> Boxed(const Closure<T> &closure, TypeCode typeCode) {
+  if constexpr (std::is_void_v<T>) {
+    return [closure](Value *frame) {
+      closure(frame);
+      return Value();
+    };
+  } else if constexpr (std::is_same_v<T, Value>) {
+    return closure;
+  } else {
+    return [closure, typeCode](Value *frame) {
+      Value value;
+      value.type = typeCode;
+      As<T>(value) = closure(frame);
+      return value;
+    };
+  }
+}
+
+Closure<void> Discard(const Expression *node, const Code &code) {
+  return Dispatch(node, code.type, [&code](auto tag) -> Closure<void> {
+    using T = typename decltype(tag)::type;
+    if constexpr (std::is_void_v<T>) {
+      return Get<void>(code);
+    } else {
+      Closure<T> closure = Get<T>(code);
+      return [closure](Value *frame) { closure(frame); };
+    }
+  });
+}
+
+template <typename T> T Divide(T a, T b, const Expression *node) {
+  if constexpr (std::is_integral_v<T>) {
+    if (b == 0) {
+      throw TreeException(__FILE__, __LINE__, "division by zero.", node,
+                          nullptr);
+    }
+  }
+  return Interpreter::Divide(a, b);
+}
+
+template <typename T> const T &Raw(const T &value) { return value; }
+const std::u32string &Raw(const String &value) { return *value; }
+
+template <typename T>
+constexpr bool IsNumber =
+    std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+    std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template <typename T>
+constexpr bool IsOrdered =
+    IsNumber<T> || std::is_same_v<T, char32_t> || std::is_same_v<T, String>;
+
+/* Evaluates the left operand first. */
+template <typename TResult, typename TOperand, typename TOperation>
+Closure<TResult> Binary(Closure<TOperand> left, Closure<TOperand> right,
+                        TOperation operation) {
+  return [left, right, operation](Value *frame) -> TResult {
+    TOperand a = left(frame);
+    return operation(a, right(frame));
+  };
+}
+
+template <typename T>
+Code CompileOperator(const BinaryExpression *node, ExpressionType operation,
+                     const Type *type, const Code &left, const Code &right) {
+  if constexpr (std::is_void_v<T> || std::is_same_v<T, Value>) {
+    throw TreeException(__FILE__, __LINE__,
+                        "The operator is not supported by the interpreter.",
+                        node, nullptr);
+  } else {
+    Closure<T> a = Get<T>(left);
+    Closure<T> b = Get<T>(right);
+    switch (operation) {
+    case ExpressionType::Add: {
+      if constexpr (IsNumber<T> || std::is_same_v<T, String>) {
+        return Code(type, Binary<T>(a, b, [](T x, T y) { return Add(x, y); }));
+      }
+      break;
+    }
+    case ExpressionType::Subtract: {
+      if constexpr (IsNumber<T>) {
+        return Code(type,
+                    Binary<T>(a, b, [](T x, T y) { return Subtract(x, y); }));
+      }
+      break;
+    }
+    case ExpressionType::Multiply: {
+      if constexpr (IsNumber<T>) {
+        return Code(type,
+                    Binary<T>(a, b, [](T x, T y) { return Multiply(x, y); }));
+      }
+      break;
+    }
+    case ExpressionType::Divide: {
+      if constexpr (IsNumber<T>) {
+        return Code(type, Binary<T>(a, b, [node](T x, T y) {
+                      return Divide(x, y, node);
+                    }));
+      }
+      break;
+    }
+    case ExpressionType::LessThan: {
+      if constexpr (IsOrdered<T>) {
+        return Code(type, Binary<bool>(a, b, [](const T &x, const T &y) {
+                      return Raw(x) < Raw(y);
+                    }));
+      }
+      break;
+    }
+    case ExpressionType::LessThanOrEqual: {
+      if constexpr (IsOrdered<T>) {
+        return Code(type, Binary<bool>(a, b, [](const T &x, const T &y) {
+                      return Raw(x) <= Raw(y);
+                    }));
+      }
+      break;
+    }
+    case ExpressionType::GreaterThan: {
+      if constexpr (IsOrdered<T>) {
+        return Code(type, Binary<bool>(a, b, [](const T &x, const T &y) {
+                      return Raw(x) > Raw(y);
+                    }));
+      }
+      break;
+    }
+    case ExpressionType::GreaterThanOrEqual: {
+      if constexpr (IsOrdered<T>) {
+        return Code(type, Binary<bool>(a, b, [](const T &x, const T &y) {
+                      return Raw(x) >= Raw(y);
+                    }));
+      }
+      break;
+    }
+    case ExpressionType::Equal: {
+      return Code(type, Binary<bool>(a, b, [](const T &x, const T &y) {
+                    return Raw(x) == Raw(y);
+                  }));
+    }
+    case ExpressionType::NotEqual: {
+      return Code(type, Binary<bool>(a, b, [](const T &x, const T &y) {
+                    return Raw(x) != Raw(y);
+                  }));
+    }
+    default: {
+      break;
+    }
+    }
+    throw TreeException(__FILE__, __LINE__,
+                        "The operator is not supported by the interpreter.",
+                        node, nullptr);
+  }
+}
+
+template <typename T> Code Constant(const Type *type, T value) {
+  return Code(type, Closure<T>([value](Value *) { return value; }));
+}
+
+}; /* namespace */
+
+ClosureInterpreter::ClosureInterpreter(Driver::CompilerDatabase *database,
+                                       size_t stackSize, size_t maxCallDepth)
+    : database{database}, bodyTypes{nullptr}, slots{nullptr},
+      stack(new Value[stackSize]), stackEnd{stack.get() + stackSize},
+      stackTop{stack.get()}, callDepth{0}, maxCallDepth{maxCallDepth} {
+  const Driver::FunctionIndex &index = database->Functions();
+  functions.resize(index.size());
+  for (const auto &item : index) {
+    const std::u32string &name = item.first;
+    const Driver::FunctionAst &ast = database->AstOfFunction(name);
+    const Driver::FunctionSlots &frame = database->SlotsOfFunction(name);
+    std::string diagnostic = database->DiagnosticOfFunction(name);
+    if (!diagnostic.empty()) {
+      throw Utility::Exception(__FILE__, __LINE__, diagnostic, nullptr);
+    }
+    auto function = std::make_unique<CompiledFunction>();
+    function->lambda = ast.function;
+    function->frameSize = frame.frame.frameSize;
+    function->returnType = ast.function->ReturnType();
+    function->body =
+        Dispatch(ast.function, function->returnType, [](auto tag) {
+          using T = typename decltype(tag)::type;
+          return std::any(Closure<T>());
+        });
+    functionsByName[name] = function.get();
+    functions.at(item.second.number) = std::move(function);
+  }
+  for (const auto &function : functions) {
+    CompileFunction(function.get());
+  }
+}
+
+Value ClosureInterpreter::Call(const std::u32string &name,
+                               const std::vector<Value> &arguments) {
+  auto it = functionsByName.find(name);
+  if (it == functionsByName.end()) {
+    throw Utility::Exception(__FILE__, __LINE__,
+                             Utility::UTF32ToUTF8(U"'" + name +
+                                                  U"' not defined."),
+                             nullptr);
+  }
+  CompiledFunction *function = it->second;
+  const auto &parameters = function->lambda->Parameters();
+  if (parameters.size() != arguments.size()) {
+    throw Utility::Exception(__FILE__, __LINE__,
+                             "argument size mismatch error.", nullptr);
+  }
+  /* A run that threw left its frames behind. */
+  Value *frame = stack.get();
+  callDepth = 0;
+  if (stackEnd - frame < function->frameSize) {
+    throw Utility::Exception(__FILE__, __LINE__, "stack overflow.", nullptr);
+  }
+  stackTop = frame + function->frameSize;
+  for (size_t i = 0; i < arguments.size(); i++) {
+    if (arguments[i].type != parameters[i]->GetType()->GetTypeCode()) {
+      throw Utility::Exception(__FILE__, __LINE__,
+                               "argument " + std::to_string(i) +
+                                   " type mismatch error.",
+                               nullptr);
+    }
+    frame[i] = arguments[i];
+  }
+  return function->entry(frame);
+}
+
+Code ClosureInterpreter::VisitBinary(const BinaryExpression *node) {
+  if (node->NodeType() == ExpressionType::Assign) {
+    return Assign(node);
+  } else {
+    auto spine = LeftSpine(node);
+    Code left = Visit(spine.back()->Left());
+    for (auto it = spine.rbegin(); it != spine.rend(); it++) {
+      Code right = Visit((*it)->Right());
+      left = Operator(*it, (*it)->NodeType(), left, right);
+    }
+    return left;
+  }
+}
+
+Code ClosureInterpreter::VisitConstant(const ConstantExpression *node) {
+  const Type *type = TypeOf(node);
+  Value value = ConstantValue(node);
+  return Dispatch(node, type, [type, &value](auto tag) {
+    using T = typename decltype(tag)::type;
+    if constexpr (std::is_void_v<T>) {
+      return Code(type, Closure<void>([](Value *) {}));
+    } else {
+      return Constant(type, As<T>(value));
+    }
+  });
+}
+
+Code ClosureInterpreter::VisitParameter(const ParameterExpression *node) {
+  const NameInfo &nameInfo = Locate(node);
+  if (nameInfo.kind != LocationKind::FunctionVariable) {
+    throw TreeException(__FILE__, __LINE__,
+                        "Functions can only be called by the interpreter.",
+                        node, nullptr);
+  }
+  int slot = nameInfo.number;
+  const Type *type = TypeOf(node);
+  return Dispatch(node, type, [type, slot](auto tag) {
+    using T = typename decltype(tag)::type;
+    if constexpr (std::is_void_v<T>) {
+      return Code(type, Closure<void>([](Value *) {}));
+    } else {
+      return Code(type, Closure<T>([slot](Value *frame) -> T {
+                    return As<T>(frame[slot]);
+                  }));
+    }
+  });
+}
+
+Code ClosureInterpreter::VisitBlock(const BlockExpression *node) {
+  const Type *type = TypeOf(node);
+  if (node->Expressions().empty()) {
+    return Code(type, Closure<void>([](Value *) {}));
+  }
+  std::vector<Closure<void>> effects;
+  for (size_t i = 0; i + 1 < node->Expressions().size(); i++) {
+    const Expression *expression = node->Expressions()[i];
+    effects.push_back(Discard(expression, Visit(expression)));
+  }
+  Code last = Visit(node->Expressions().back());
+  if (effects.empty()) {
+    return last;
+  }
+  return Dispatch(node, last.type, [&effects, &last](auto tag) {
+    using T = typename decltype(tag)::type;
+    Closure<T> result = Get<T>(last);
+    return Code(last.type, Closure<T>([effects, result](Value *frame) -> T {
+                  for (const auto &effect : effects) {
+                    effect(frame);
+                  }
+                  return result(frame);
+                }));
+  });
+}
+
+Code ClosureInterpreter::VisitConditional(const ConditionalExpression *node) {
+  const Type *type = TypeOf(node);
+  Closure<bool> test = Get<bool>(Visit(node->Test()));
+  Code ifTrue = Coerce(node, Visit(node->IfTrue()), type);
+  Code ifFalse = Coerce(node, Visit(node->IfFalse()), type);
+  return Dispatch(node, type, [&](auto tag) {
+    using T = typename decltype(tag)::type;
+    Closure<T> a = Get<T>(ifTrue);
+    Closure<T> b = Get<T>(ifFalse);
+    return Code(type, Closure<T>([test, a, b](Value *frame) -> T {
+                  if (test(frame)) {
+                    return a(frame);
+                  } else {
+                    return b(frame);
+                  }
+                }));
+  });
+}
+
+Code ClosureInterpreter::VisitUnary(const UnaryExpression *node) {
+  if (node->NodeType() == ExpressionType::Not) {
+    Closure<bool> operand = Get<bool>(Visit(node->Operand()));
+    return Code(TypeOf(node), Closure<bool>([operand](Value *frame) {
+                  return !operand(frame);
+                }));
+  } else {
+    throw TreeException(__FILE__, __LINE__,
+                        "The operator is not supported by the interpreter.",
+                        node, nullptr);
+  }
+}
+
+/* Arguments are written straight into the callee's frame, whose first
+ * slots are its parameters. The frame is claimed before they are evaluated,
+ * so calls among them get frames above it. */
+Code ClosureInterpreter::VisitCall(const CallExpression *node) {
+  if (node->Function()->NodeType() != ExpressionType::Parameter ||
+      Locate(node->Function()).kind != LocationKind::Function) {
+    throw TreeException(__FILE__, __LINE__,
+                        "Only functions can be called by the interpreter.",
+                        node, nullptr);
+  }
+  CompiledFunction *function =
+      functions.at(Locate(node->Function()).number).get();
+  std::vector<std::function<void(Value *, Value *)>> arguments;
+  for (size_t i = 0; i < node->Arguments().size(); i++) {
+    const Expression *argument = node->Arguments()[i];
+    Code code = Coerce(argument, Visit(argument),
+                       function->lambda->Parameters().at(i)->GetType());
+    int slot = static_cast<int>(i);
+    arguments.push_back(Dispatch(
+        argument, code.type,
+        [&code, slot](auto tag) -> std::function<void(Value *, Value *)> {
+          using T = typename decltype(tag)::type;
+          Closure<T> closure = Get<T>(code);
+          if constexpr (std::is_void_v<T>) {
+            return [closure](Value *caller, Value *) { closure(caller); };
+          } else {
+            return [closure, slot](Value *caller, Value *callee) {
+              As<T>(callee[slot]) = closure(caller);
+            };
+          }
+        }));
+  }
+  const Type *type = TypeOf(node);
+  return Dispatch(node, function->returnType, [&](auto tag) {
+    using T = typename decltype(tag)::type;
+    const Closure<T> *body = std::any_cast<Closure<T>>(&function->body);
+    int frameSize = function->frameSize;
+    return Code(type, Closure<T>([this, body, frameSize,
+                                  arguments](Value *frame) -> T {
+                  Value *callee = stackTop;
+                  if (callDepth == maxCallDepth ||
+                      stackEnd - callee < frameSize) {
+                    throw Utility::Exception(__FILE__, __LINE__,
+                                             "stack overflow.", nullptr);
+                  }
+                  stackTop = callee + frameSize;
+                  callDepth++;
+                  for (const auto &argument : arguments) {
+                    argument(frame, callee);
+                  }
+                  if constexpr (std::is_void_v<T>) {
+                    (*body)(callee);
+                    stackTop = callee;
+                    callDepth--;
+                  } else {
+                    T result = (*body)(callee);
+                    stackTop = callee;
+                    callDepth--;
+                    return result;
+                  }
+                }));
+  });
+}
+
+Code ClosureInterpreter::VisitLambda(const LambdaExpression *node) {
+  throw TreeException(__FILE__, __LINE__,
+                      "Nested functions are not supported by the interpreter.",
+                      node, nullptr);
+}
+
+/* A loop evaluates to its last iteration's body, or the default value of
+ * the body's type if the body never ran. */
+Code ClosureInterpreter::VisitLoop(const LoopExpression *node) {
+  const Type *type = TypeOf(node);
+  Closure<void> initializer =
+      Discard(node->Initializer(), Visit(node->Initializer()));
+  Closure<bool> condition = Get<bool>(Visit(node->Condition()));
+  Code body = Visit(node->Body());
+  return Dispatch(node, body.type, [&](auto tag) {
+    using T = typename decltype(tag)::type;
+    Closure<T> closure = Get<T>(body);
+    return Code(type, Closure<T>([initializer, condition,
+                                  closure](Value *frame) -> T {
+                  initializer(frame);
+                  if constexpr (std::is_void_v<T>) {
+                    while (condition(frame)) {
+                      closure(frame);
+                    }
+                  } else {
+                    T result = DefaultValue<T>();
+                    while (condition(frame)) {
+                      result = closure(frame);
+                    }
+                    return result;
+                  }
+                }));
+  });
+}
+
+Code ClosureInterpreter::VisitDefault(const DefaultExpression *node) {
+  const Type *type = TypeOf(node);
+  return Dispatch(node, type, [type](auto tag) {
+    using T = typename decltype(tag)::type;
+    if constexpr (std::is_void_v<T>) {
+      return Code(type, Closure<void>([](Value *) {}));
+    } else {
+      return Code(type, Closure<T>([](Value *) { return DefaultValue<T>(); }));
+    }
+  });
+}
+
+Code ClosureInterpreter::VisitVariableDeclaration(
+    const VariableDeclarationExpression *node) {
+  int slot = Locate(node).number;
+  Code initializer = Visit(node->Initializer());
+  return Code(TypeOf(node),
+              Dispatch(node, initializer.type,
+                       [&initializer, slot](auto tag) -> Closure<void> {
+                         using T = typename decltype(tag)::type;
+                         Closure<T> closure = Get<T>(initializer);
+                         if constexpr (std::is_void_v<T>) {
+                           return closure;
+                         } else {
+                           return [closure, slot](Value *frame) {
+                             As<T>(frame[slot]) = closure(frame);
+                           };
+                         }
+                       }));
+}
+
+void ClosureInterpreter::CompileFunction(CompiledFunction *function) {
+  const LambdaExpression *lambda = function->lambda;
+  bodyTypes = &database->TypeOfBody(lambda->Name());
+  slots = &database->SlotsOfFunction(lambda->Name());
+  Code body = Coerce(lambda, Visit(lambda->Body()), function->returnType);
+  Dispatch(lambda, function->returnType, [function, &body](auto tag) {
+    using T = typename decltype(tag)::type;
+    Closure<T> closure = Get<T>(body);
+    *std::any_cast<Closure<T>>(&function->body) = closure;
+    function->entry =
+        Boxed<T>(closure, function->returnType->GetTypeCode());
+    return 0;
+  });
+}
+
+const Type *ClosureInterpreter::TypeOf(const Expression *node) const {
+  return bodyTypes->nodeTypes.at(node);
+}
+
+const NameInfo &ClosureInterpreter::Locate(const Expression *node) const {
+  return slots->nameInfoTable.at(node);
+}
+
+Code ClosureInterpreter::Assign(const BinaryExpression *node) {
+  const NameInfo &nameInfo = Locate(node->Left());
+  if (nameInfo.kind != LocationKind::FunctionVariable) {
+    throw TreeException(__FILE__, __LINE__,
+                        "Only variables can be assigned by the interpreter.",
+                        node, nullptr);
+  }
+  int slot = nameInfo.number;
+  Code value = Coerce(node, Visit(node->Right()), TypeOf(node->Left()));
+  return Code(TypeOf(node),
+              Dispatch(node, value.type,
+                       [&value, slot](auto tag) -> Closure<void> {
+                         using T = typename decltype(tag)::type;
+                         Closure<T> closure = Get<T>(value);
+                         if constexpr (std::is_void_v<T>) {
+                           return closure;
+                         } else {
+                           return [closure, slot](Value *frame) {
+                             As<T>(frame[slot]) = closure(frame);
+                           };
+                         }
+                       }));
+}
+
+Code ClosureInterpreter::Operator(const BinaryExpression *node,
+                                  ExpressionType operation, Code left,
+                                  Code right) {
+  const Type *type = TypeOf(node);
+  return Dispatch(node, left.type, [&](auto tag) {
+    using T = typename decltype(tag)::type;
+    return CompileOperator<T>(node, operation, type, left, right);
+  });
+}
+
+/* A value flowing into a union is boxed with its tag; a value of another
+ * union is boxed already. The type checker also lets a callable flow into a
+ * different but assignable callable type, but this interpreter has no
+ * function values, so that is reported as a mismatch. */
+Code ClosureInterpreter::Coerce(const Expression *node, Code code,
+                                const Type *type) {
+  if (TypeFactory::AreTypesEqual(code.type, type)) {
+    return Code(type, std::move(code.closure));
+  } else if (type->GetTypeCode() == TypeCode::Union) {
+    return Dispatch(node, code.type, [&code, type](auto tag) {
+      using T = typename decltype(tag)::type;
+      return Code(type, Boxed<T>(Get<T>(code), code.type->GetTypeCode()));
+    });
+  } else {
+    throw TreeException(__FILE__, __LINE__, "type mismatch error.", node,
+                        nullptr);
+  }
+}
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
@@ -0,0 +1,1052 @@
+#include "Interpreter/JitMachine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <initializer_list>
+#include "Interpreter/Arithmetic.hpp"
+#include "Utility/Exception.hpp"
+#include "Utility/UTF32Functions.hpp"
+
+#if CYGNI_JIT
+#include <sys/mman.h>
+#endif
+
+namespace Cygni {
+namespace Interpreter {
+
+namespace {
+
+constexpr int32_t ValueSize = 32;
+constexpr int32_t PayloadOffset = 8;
+
+/* The layout the templates assume. */
+bool HasExpectedLayout() {
+  Value value;
+  const char *start = reinterpret_cast<const char *>(&value);
+  return sizeof(Value) == ValueSize &&
+         reinterpret_cast<const char *>(&value.type) == start &&
+         reinterpret_cast<const char *>(&value.int64) - start ==
+             PayloadOffset &&
+         reinterpret_cast<const char *>(&value.int32) - start == PayloadOffset;
+}
+
+bool IsScalar(TypeCode typeCode) {
+  switch (typeCode) {
+  case TypeCode::Boolean:
+  case TypeCode::Char:
+  case TypeCode::Empty:
+  case TypeCode::Float32:
+  case TypeCode::Float64:
+  case TypeCode::Int32:
+  case TypeCode::Int64:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool IsTyped(OpCode opCode) {
+  return opCode >= OpCode::AddInt32 &&
+         opCode <= OpCode::GreaterThanOrEqualFloat64;
+}
+
+bool IsGeneric(OpCode opCode) {
+  return opCode >= OpCode::Add && opCode <= OpCode::GreaterThanOrEqual;
+}
+
+/* Whether a function can be compiled apart from its callees. */
+bool CanCompile(const BytecodeFunction &function,
+                const std::vector<DecodedInstruction> &instructions) {
+  for (TypeCode typeCode : function.parameterTypes) {
+    if (!IsScalar(typeCode)) {
+      return false;
+    }
+  }
+  if (!IsScalar(function.returnType)) {
+    return false;
+  }
+  for (const Value &constant : function.constants) {
+    if (!IsScalar(constant.type)) {
+      return false;
+    }
+  }
+  for (const DecodedInstruction &instruction : instructions) {
+    switch (instruction.opCode) {
+    case OpCode::PushDefault: {
+      if (!IsScalar(static_cast<TypeCode>(instruction.operand))) {
+        return false;
+      }
+      break;
+    }
+    case OpCode::PushConstant:
+    case OpCode::LoadLocal:
+    case OpCode::StoreLocal:
+    case OpCode::Pop:
+    case OpCode::Not:
+    case OpCode::Jump:
+    case OpCode::JumpIfFalse:
+    case OpCode::Call:
+    case OpCode::TailCall:
+    case OpCode::Return: {
+      break;
+    }
+    default: {
+      if (!IsGeneric(instruction.opCode) && !IsTyped(instruction.opCode)) {
+        return false;
+      }
+      break;
+    }
+    }
+  }
+  return true;
+}
+
+/* The runtime functions compiled code calls. They return its status. */
+int StackOverflow(JitContext *context) noexcept {
+  context->error = "stack overflow.";
+  return 1;
+}
+
+int DivisionByZero(JitContext *context) noexcept {
+  context->error = "division by zero.";
+  return 1;
+}
+
+/* Applies an operator to the two values at 'operands', leaving the result
+ * in the first. */
+int Operate(JitContext *context, Value *operands, uint32_t opCode) noexcept {
+  OpCode generic = static_cast<OpCode>(opCode);
+  if (IsTyped(generic)) {
+    generic = GenericOpCode(generic);
+  }
+  Value &a = operands[0];
+  const Value &b = operands[1];
+  try {
+    switch (generic) {
+    case OpCode::Add:
+      Arithmetic(a, a, b, AddOperation());
+      break;
+    case OpCode::Subtract:
+      Arithmetic(a, a, b, SubtractOperation());
+      break;
+    case OpCode::Multiply:
+      Arithmetic(a, a, b, MultiplyOperation());
+      break;
+    case OpCode::Divide:
+      Arithmetic(a, a, b, DivideOperation());
+      break;
+    case OpCode::Equal:
+      Compare(a, a, b, std::equal_to<>());
+      break;
+    case OpCode::NotEqual:
+      Compare(a, a, b, std::not_equal_to<>());
+      break;
+    case OpCode::LessThan:
+      Compare(a, a, b, std::less<>());
+      break;
+    case OpCode::LessThanOrEqual:
+      Compare(a, a, b, std::less_equal<>());
+      break;
+    case OpCode::GreaterThan:
+      Compare(a, a, b, std::greater<>());
+      break;
+    default:
+      Compare(a, a, b, std::greater_equal<>());
+      break;
+    }
+  } catch (const Utility::Exception &exception) {
+    context->error = exception.Message();
+    return 1;
+  }
+  return 0;
+}
+
+enum class Register : uint8_t {
+  Rax,
+  Rcx,
+  Rdx,
+  Rbx,
+  Rsp,
+  Rbp,
+  Rsi,
+  Rdi,
+  R8,
+  R9,
+  R10,
+  R11,
+  R12,
+  R13,
+  R14,
+  R15
+};
+
+/* Appends x86-64 machine code. */
+class Assembler {
+public:
+  std::vector<uint8_t> bytes;
+
+  size_t Position() const { return bytes.size(); }
+
+  void Emit(std::initializer_list<uint8_t> code) {
+    bytes.insert(bytes.end(), code);
+  }
+
+  void Emit32(int32_t value) {
+    for (int i = 0; i < 4; i++) {
+      bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+  }
+
+  void Emit64(uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+      bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+  }
+
+  /* An instruction whose operand is [base + displacement]. 'reg' is the
+   * register operand or the opcode extension. */
+  void Memory(bool wide, std::initializer_list<uint8_t> opCode, int reg,
+              Register base, int32_t displacement) {
+    int b = static_cast<int>(base);
+    uint8_t rex = static_cast<uint8_t>(0x40 | (wide ? 0x08 : 0) |
+                                       ((reg >> 3) << 2) | (b >> 3));
+    if (rex != 0x40) {
+      Emit({rex});
+    }
+    Emit(opCode);
+    Emit({static_cast<uint8_t>(0x80 | ((reg & 7) << 3) | (b & 7))});
+    if ((b & 7) == static_cast<int>(Register::Rsp)) {
+      Emit({0x24});
+    }
+    Emit32(displacement);
+  }
+
+  void MoveImmediate(Register reg, uint64_t value) {
+    int r = static_cast<int>(reg);
+    Emit({static_cast<uint8_t>(0x48 | (r >> 3)),
+          static_cast<uint8_t>(0xB8 | (r & 7))});
+    Emit64(value);
+  }
+
+  /* A jump or call with a 32-bit displacement, which is patched later;
+   * returns where the displacement is. */
+  size_t Branch(std::initializer_list<uint8_t> opCode) {
+    Emit(opCode);
+    size_t at = Position();
+    Emit32(0);
+    return at;
+  }
+
+  void Patch(size_t at, size_t target) {
+    int32_t displacement = static_cast<int32_t>(target - (at + 4));
+    std::memcpy(&bytes[at], &displacement, sizeof(displacement));
+  }
+};
+
+/* The registers of compiled code: rbx holds the base of the frame, r13 the
+ * context and r14 the constants. The operand stack needs no register: its
+ * depth at every instruction is known, so operands are addressed from the
+ * base. */
+constexpr Register Base = Register::Rbx;
+constexpr Register Context = Register::R13;
+constexpr Register Constants = Register::R14;
+
+class Fixup {
+public:
+  size_t at;
+  int function;
+  bool tail;
+};
+
+/* Translates a unit of functions into one block of code. A function starts
+ * with its prologue; tail calls enter after it. Each loop header has an
+ * entry of its own after the function, which sets up the registers as the
+ * prologue does and jumps there. Calls within the unit are relative;
+ * functions compiled before are called at their address. */
+class Translator {
+public:
+  const BytecodeModule *module;
+  const std::vector<uint8_t *> &compiledStarts;
+  const std::vector<uint8_t *> &compiledTailEntries;
+  Assembler assembler;
+  std::vector<size_t> starts;
+  std::vector<size_t> tailEntries;
+  std::vector<std::vector<std::pair<uint32_t, size_t>>> loopEntries;
+  std::vector<Fixup> calls;
+  int32_t stackEndOffset;
+  int32_t callDepthOffset;
+  int32_t maxCallDepthOffset;
+
+  Translator(const BytecodeModule *module, const JitContext &context,
+             const std::vector<uint8_t *> &compiledStarts,
+             const std::vector<uint8_t *> &compiledTailEntries)
+      : module{module}, compiledStarts{compiledStarts},
+        compiledTailEntries{compiledTailEntries}, assembler(),
+        starts(module->functions.size()),
+        tailEntries(module->functions.size()),
+        loopEntries(module->functions.size()), calls(),
+        stackEndOffset{Offset(context, &context.stackEnd)},
+        callDepthOffset{Offset(context, &context.callDepth)},
+        maxCallDepthOffset{Offset(context, &context.maxCallDepth)},
+        function{nullptr}, depth{0}, exits(), overflows(), divisions() {}
+
+  static int32_t Offset(const JitContext &context, const void *field) {
+    return static_cast<int32_t>(reinterpret_cast<const char *>(field) -
+                                reinterpret_cast<const char *>(&context));
+  }
+
+  void Translate(int number,
+                 const std::vector<DecodedInstruction> &instructions) {
+    function = &module->functions[number];
+    depth = 0;
+    exits.clear();
+    overflows.clear();
+    divisions.clear();
+
+    starts[number] = assembler.Position();
+    Prologue();
+    tailEntries[number] = assembler.Position();
+    LoadConstants();
+
+    /* The depth at each offset, set by the first jump to it or by falling
+     * through. Code after a jump, return or tail call is reached only by
+     * jumps, and jumps that are never reached themselves set no depth. */
+    std::vector<int> depths(function->code.size() + 1, -1);
+    std::vector<size_t> labels(function->code.size() + 1);
+    std::vector<std::pair<size_t, size_t>> jumps;
+    std::vector<uint32_t> headers;
+    bool reachable = true;
+    for (const DecodedInstruction &instruction : instructions) {
+      if (depths[instruction.offset] >= 0) {
+        depth = depths[instruction.offset];
+        reachable = true;
+      }
+      labels[instruction.offset] = assembler.Position();
+      uint32_t operand = instruction.operand;
+      switch (instruction.opCode) {
+      case OpCode::PushConstant: {
+        Copy(Base, Slot(depth), Constants,
+             static_cast<int32_t>(operand) * ValueSize);
+        depth++;
+        break;
+      }
+      case OpCode::PushDefault: {
+        assembler.Memory(false, {0xC7}, 0, Base, Slot(depth));
+        assembler.Emit32(static_cast<int32_t>(operand));
+        assembler.Memory(true, {0xC7}, 0, Base, Slot(depth) + PayloadOffset);
+        assembler.Emit32(0);
+        depth++;
+        break;
+      }
+      case OpCode::LoadLocal: {
+        Copy(Base, Slot(depth), Base,
+             static_cast<int32_t>(operand) * ValueSize);
+        depth++;
+        break;
+      }
+      case OpCode::StoreLocal: {
+        depth--;
+        Copy(Base, static_cast<int32_t>(operand) * ValueSize, Base,
+             Slot(depth));
+        break;
+      }
+      case OpCode::Pop: {
+        depth--;
+        break;
+      }
+      case OpCode::Not: {
+        /* xor byte [payload], 1 */
+        assembler.Memory(false, {0x80}, 6, Base,
+                         Slot(depth - 1) + PayloadOffset);
+        assembler.Emit({0x01});
+        break;
+      }
+      case OpCode::Jump: {
+        jumps.emplace_back(assembler.Branch({0xE9}), operand);
+        if (operand <= instruction.offset &&
+            std::find(headers.begin(), headers.end(), operand) ==
+                headers.end()) {
+          headers.push_back(operand);
+        }
+        if (reachable && depths[operand] < 0) {
+          depths[operand] = depth;
+        }
+        reachable = false;
+        break;
+      }
+      case OpCode::JumpIfFalse: {
+        depth--;
+        /* cmp byte [payload], 0; je */
+        assembler.Memory(false, {0x80}, 7, Base, Slot(depth) + PayloadOffset);
+        assembler.Emit({0x00});
+        jumps.emplace_back(assembler.Branch({0x0F, 0x84}), operand);
+        if (reachable && depths[operand] < 0) {
+          depths[operand] = depth;
+        }
+        break;
+      }
+      case OpCode::Call: {
+        TranslateCall(static_cast<int>(operand));
+        break;
+      }
+      case OpCode::TailCall: {
+        TranslateTailCall(static_cast<int>(operand));
+        reachable = false;
+        break;
+      }
+      case OpCode::Return: {
+        Copy(Base, 0, Base, Slot(depth - 1));
+        assembler.Emit({0x31, 0xC0}); /* xor eax, eax */
+        exits.push_back(assembler.Branch({0xE9}));
+        reachable = false;
+        break;
+      }
+      default: {
+        TranslateOperator(instruction.opCode);
+        depth--;
+        break;
+      }
+      }
+    }
+    labels[function->code.size()] = assembler.Position();
+    for (const auto &jump : jumps) {
+      assembler.Patch(jump.first, labels[jump.second]);
+    }
+
+    for (size_t at : overflows) {
+      assembler.Patch(at, assembler.Position());
+    }
+    CallRuntime(reinterpret_cast<void *>(&StackOverflow));
+    exits.push_back(assembler.Branch({0xE9}));
+    for (size_t at : divisions) {
+      assembler.Patch(at, assembler.Position());
+    }
+    CallRuntime(reinterpret_cast<void *>(&DivisionByZero));
+    for (size_t at : exits) {
+      assembler.Patch(at, assembler.Position());
+    }
+    /* pop r14, r13, rbx; ret */
+    assembler.Emit({0x41, 0x5E, 0x41, 0x5D, 0x5B, 0xC3});
+
+    /* The operands live in the frame, where the machine left them. */
+    for (uint32_t header : headers) {
+      loopEntries[number].emplace_back(header, assembler.Position());
+      Prologue();
+      LoadConstants();
+      assembler.Patch(assembler.Branch({0xE9}), labels[header]);
+    }
+  }
+
+  void PatchCalls() {
+    for (const Fixup &fixup : calls) {
+      assembler.Patch(fixup.at, fixup.tail ? tailEntries[fixup.function]
+                                           : starts[fixup.function]);
+    }
+  }
+
+private:
+  const BytecodeFunction *function;
+  int depth;
+  std::vector<size_t> exits;
+  std::vector<size_t> overflows;
+  std::vector<size_t> divisions;
+
+  /* The offset from the base of the operand 'index' slots above the
+   * locals. */
+  void Prologue() {
+    /* push rbx, r13, r14: with the return address, rsp stays 16-byte
+     * aligned at calls. */
+    assembler.Emit({0x53, 0x41, 0x55, 0x41, 0x56});
+    assembler.Emit({0x48, 0x89, 0xFB}); /* mov rbx, rdi */
+    assembler.Emit({0x49, 0x89, 0xF5}); /* mov r13, rsi */
+  }
+
+  void LoadConstants() {
+    assembler.MoveImmediate(
+        Constants, reinterpret_cast<uint64_t>(function->constants.data()));
+  }
+
+  int32_t Slot(int index) const {
+    return (function->frameSize + index) * ValueSize;
+  }
+
+  void Lea(Register target, Register base, int32_t displacement) {
+    assembler.Memory(true, {0x8D}, static_cast<int>(target), base,
+                     displacement);
+  }
+
+  /* Copies the tag and payload of a value through rax. */
+  void Copy(Register target, int32_t targetOffset, Register source,
+            int32_t sourceOffset) {
+    int rax = static_cast<int>(Register::Rax);
+    assembler.Memory(false, {0x8B}, rax, source, sourceOffset);
+    assembler.Memory(false, {0x89}, rax, target, targetOffset);
+    assembler.Memory(true, {0x8B}, rax, source, sourceOffset + PayloadOffset);
+    assembler.Memory(true, {0x89}, rax, target, targetOffset + PayloadOffset);
+  }
+
+  /* Calls a runtime function with the context as its first argument. */
+  void CallRuntime(void *runtimeFunction) {
+    assembler.Emit({0x4C, 0x89, 0xEF}); /* mov rdi, r13 */
+    assembler.MoveImmediate(Register::Rax,
+                            reinterpret_cast<uint64_t>(runtimeFunction));
+    assembler.Emit({0xFF, 0xD0}); /* call rax */
+  }
+
+  /* test eax, eax; jnz to the epilogue, which returns the status. */
+  void ExitOnError() {
+    assembler.Emit({0x85, 0xC0});
+    exits.push_back(assembler.Branch({0x0F, 0x85}));
+  }
+
+  /* Jumps to the overflow path unless 'required' bytes from the base
+   * fit on the stack. */
+  void CheckStack(int32_t required) {
+    Lea(Register::Rax, Base, required);
+    assembler.Memory(true, {0x3B}, 0, Context, stackEndOffset);
+    overflows.push_back(assembler.Branch({0x0F, 0x87})); /* ja */
+  }
+
+  void TranslateCall(int number) {
+    const BytecodeFunction &callee = module->functions[number];
+    int32_t calleeBase = Slot(depth - callee.parameterCount);
+    CheckStack(calleeBase + (callee.frameSize + callee.maxStack) * ValueSize);
+    assembler.Memory(false, {0x8B}, 0, Context, callDepthOffset);
+    assembler.Memory(false, {0x3B}, 0, Context, maxCallDepthOffset);
+    overflows.push_back(assembler.Branch({0x0F, 0x83})); /* jae */
+    assembler.Memory(false, {0xFF}, 0, Context, callDepthOffset);
+    Lea(Register::Rdi, Base, calleeBase);
+    assembler.Emit({0x4C, 0x89, 0xEE}); /* mov rsi, r13 */
+    if (const uint8_t *start = compiledStarts[number]) {
+      assembler.MoveImmediate(Register::Rax,
+                              reinterpret_cast<uint64_t>(start));
+      assembler.Emit({0xFF, 0xD0}); /* call rax */
+    } else {
+      calls.push_back(Fixup{assembler.Branch({0xE8}), number, false});
+    }
+    assembler.Memory(false, {0xFF}, 1, Context, callDepthOffset);
+    ExitOnError();
+    depth += 1 - callee.parameterCount;
+  }
+
+  /* The arguments replace the frame, which the callee then reuses. */
+  void TranslateTailCall(int number) {
+    const BytecodeFunction &callee = module->functions[number];
+    CheckStack((callee.frameSize + callee.maxStack) * ValueSize);
+    for (int i = 0; i < callee.parameterCount; i++) {
+      Copy(Base, i * ValueSize, Base,
+           Slot(depth - callee.parameterCount + i));
+    }
+    if (const uint8_t *entry = compiledTailEntries[number]) {
+      assembler.MoveImmediate(Register::Rax,
+                              reinterpret_cast<uint64_t>(entry));
+      assembler.Emit({0xFF, 0xE0}); /* jmp rax */
+    } else {
+      calls.push_back(Fixup{assembler.Branch({0xE9}), number, true});
+    }
+  }
+
+  void TranslateOperator(OpCode opCode) {
+    if (opCode >= OpCode::AddInt32 &&
+        opCode <= OpCode::GreaterThanOrEqualInt64) {
+      TranslateInteger(GenericOpCode(opCode), opCode >= OpCode::AddInt64);
+    } else if (opCode >= OpCode::AddFloat32 &&
+               opCode <= OpCode::GreaterThanOrEqualFloat64) {
+      TranslateFloat(GenericOpCode(opCode), opCode >= OpCode::AddFloat64);
+    } else {
+      /* lea rsi, [left]; mov edx, opCode */
+      Lea(Register::Rsi, Base, Slot(depth - 2));
+      assembler.Emit({0xBA});
+      assembler.Emit32(static_cast<int32_t>(opCode));
+      CallRuntime(reinterpret_cast<void *>(&Operate));
+      ExitOnError();
+    }
+  }
+
+  /* Writes the boolean in al over the left operand. */
+  void StoreBoolean() {
+    int32_t left = Slot(depth - 2);
+    assembler.Emit({0x0F, 0xB6, 0xC0}); /* movzx eax, al */
+    assembler.Memory(true, {0x89}, 0, Base, left + PayloadOffset);
+    assembler.Memory(false, {0xC7}, 0, Base, left);
+    assembler.Emit32(static_cast<int32_t>(TypeCode::Boolean));
+  }
+
+  /* Results are computed in rax and stored as the whole payload: a copy
+   * reads the payload with one load, which a narrower store could not
+   * forward to. 32-bit operations clear the upper half. */
+  void TranslateInteger(OpCode generic, bool wide) {
+    int rax = static_cast<int>(Register::Rax);
+    int rcx = static_cast<int>(Register::Rcx);
+    int32_t left = Slot(depth - 2) + PayloadOffset;
+    int32_t right = Slot(depth - 1) + PayloadOffset;
+    switch (generic) {
+    case OpCode::Add: {
+      assembler.Memory(wide, {0x8B}, rax, Base, left);
+      assembler.Memory(wide, {0x03}, rax, Base, right);
+      assembler.Memory(true, {0x89}, rax, Base, left);
+      break;
+    }
+    case OpCode::Subtract: {
+      assembler.Memory(wide, {0x8B}, rax, Base, left);
+      assembler.Memory(wide, {0x2B}, rax, Base, right);
+      assembler.Memory(true, {0x89}, rax, Base, left);
+      break;
+    }
+    case OpCode::Multiply: {
+      assembler.Memory(wide, {0x8B}, rax, Base, left);
+      assembler.Memory(wide, {0x0F, 0xAF}, rax, Base, right);
+      assembler.Memory(true, {0x89}, rax, Base, left);
+      break;
+    }
+    case OpCode::Divide: {
+      /* Dividing by -1 negates, since idiv traps on the overflow. */
+      assembler.Memory(wide, {0x8B}, rcx, Base, right);
+      assembler.Memory(wide, {0x8B}, rax, Base, left);
+      if (wide) {
+        assembler.Emit({0x48, 0x85, 0xC9}); /* test rcx, rcx */
+      } else {
+        assembler.Emit({0x85, 0xC9});
+      }
+      divisions.push_back(assembler.Branch({0x0F, 0x84}));
+      if (wide) {
+        assembler.Emit({0x48, 0x83, 0xF9, 0xFF}); /* cmp rcx, -1 */
+      } else {
+        assembler.Emit({0x83, 0xF9, 0xFF});
+      }
+      size_t divide = assembler.Branch({0x0F, 0x85});
+      if (wide) {
+        assembler.Emit({0x48, 0xF7, 0xD8}); /* neg rax */
+      } else {
+        assembler.Emit({0xF7, 0xD8});
+      }
+      size_t done = assembler.Branch({0xE9});
+      assembler.Patch(divide, assembler.Position());
+      if (wide) {
+        assembler.Emit({0x48, 0x99, 0x48, 0xF7, 0xF9}); /* cqo; idiv rcx */
+      } else {
+        assembler.Emit({0x99, 0xF7, 0xF9});
+      }
+      assembler.Patch(done, assembler.Position());
+      assembler.Memory(true, {0x89}, rax, Base, left);
+      break;
+    }
+    default: {
+      assembler.Memory(wide, {0x8B}, rax, Base, right);
+      assembler.Memory(wide, {0x39}, rax, Base, left);
+      assembler.Emit({0x0F, Condition(generic), 0xC0}); /* setcc al */
+      StoreBoolean();
+      break;
+    }
+    }
+  }
+
+  /* SSE scalar operations on xmm0. The base needs no REX prefix, so the
+   * mandatory prefix can lead the opcode. */
+  void TranslateFloat(OpCode generic, bool wide) {
+    uint8_t prefix = wide ? 0xF2 : 0xF3;
+    int32_t left = Slot(depth - 2) + PayloadOffset;
+    int32_t right = Slot(depth - 1) + PayloadOffset;
+    uint8_t operation;
+    switch (generic) {
+    case OpCode::Add:
+      operation = 0x58;
+      break;
+    case OpCode::Subtract:
+      operation = 0x5C;
+      break;
+    case OpCode::Multiply:
+      operation = 0x59;
+      break;
+    case OpCode::Divide:
+      operation = 0x5E;
+      break;
+    default: {
+      /* ucomis sets CF and ZF like an unsigned comparison, and PF when
+       * either operand is NaN, so 'less' compares the other way round. */
+      bool swap = generic == OpCode::LessThan ||
+                  generic == OpCode::LessThanOrEqual;
+      assembler.Memory(false, {prefix, 0x0F, 0x10}, 0, Base,
+                       swap ? right : left);
+      if (wide) {
+        assembler.Memory(false, {0x66, 0x0F, 0x2E}, 0, Base,
+                         swap ? left : right);
+      } else {
+        assembler.Memory(false, {0x0F, 0x2E}, 0, Base, swap ? left : right);
+      }
+      switch (generic) {
+      case OpCode::Equal:
+        /* sete al; setnp cl; and al, cl */
+        assembler.Emit({0x0F, 0x94, 0xC0, 0x0F, 0x9B, 0xC1, 0x20, 0xC8});
+        break;
+      case OpCode::NotEqual:
+        /* setne al; setp cl; or al, cl */
+        assembler.Emit({0x0F, 0x95, 0xC0, 0x0F, 0x9A, 0xC1, 0x08, 0xC8});
+        break;
+      case OpCode::LessThan:
+      case OpCode::GreaterThan:
+        assembler.Emit({0x0F, 0x97, 0xC0}); /* seta al */
+        break;
+      default:
+        assembler.Emit({0x0F, 0x93, 0xC0}); /* setae al */
+        break;
+      }
+      StoreBoolean();
+      return;
+    }
+    }
+    assembler.Memory(false, {prefix, 0x0F, 0x10}, 0, Base, left);
+    assembler.Memory(false, {prefix, 0x0F, operation}, 0, Base, right);
+    /* movq stores the whole payload; a scalar load cleared the rest. */
+    assembler.Memory(false, {0x66, 0x0F, 0xD6}, 0, Base, left);
+  }
+
+  static uint8_t Condition(OpCode comparison) {
+    switch (comparison) {
+    case OpCode::Equal:
+      return 0x94;
+    case OpCode::NotEqual:
+      return 0x95;
+    case OpCode::LessThan:
+      return 0x9C;
+    case OpCode::LessThanOrEqual:
+      return 0x9E;
+    case OpCode::GreaterThan:
+      return 0x9F;
+    default:
+      return 0x9D;
+    }
+  }
+};
+
+}; /* namespace */
+
+JitMachine::JitMachine(const BytecodeModule *module, size_t stackSize,
+                       size_t maxCallDepth)
+    : module{module}, machine(module, stackSize, maxCallDepth),
+      stack(new Value[stackSize]), context(), compilable(), decoded(),
+      starts(module->functions.size()),
+      tailEntries(module->functions.size()),
+      loopEntries(module->functions.size()), blocks(),
+      entries(module->functions.size()), codeSize{0}, tiered{false},
+      synchronous{false}, mutex(), wake(), idle(), queue(), requested(),
+      compiling{false}, stopping{false}, log(), logStream{nullptr},
+      compiler() {
+  context.stackEnd = stack.get() + stackSize;
+  context.maxCallDepth = static_cast<int32_t>(maxCallDepth);
+  Analyze();
+  std::vector<int> all;
+  for (size_t i = 0; i < compilable.size(); i++) {
+    if (compilable[i]) {
+      all.push_back(static_cast<int>(i));
+    }
+  }
+  CompileUnit(all);
+}
+
+JitMachine::JitMachine(const BytecodeModule *module,
+                       TierThresholds thresholds, size_t stackSize,
+                       size_t maxCallDepth)
+    : module{module}, machine(module, stackSize, maxCallDepth), stack(),
+      context(), compilable(), decoded(), starts(module->functions.size()),
+      tailEntries(module->functions.size()),
+      loopEntries(module->functions.size()), blocks(),
+      entries(module->functions.size()), codeSize{0}, tiered{true},
+      synchronous{false}, mutex(), wake(), idle(), queue(),
+      requested(module->functions.size()), compiling{false},
+      stopping{false}, log(), logStream{nullptr}, compiler() {
+  context.maxCallDepth = static_cast<int32_t>(maxCallDepth);
+  Analyze();
+  machine.UseTier(this, thresholds.invocations, thresholds.backEdges);
+  if (IsSupported()) {
+    compiler = std::thread(&JitMachine::CompileQueued, this);
+  }
+}
+
+JitMachine::~JitMachine() {
+  if (compiler.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    compiler.join();
+  }
+#if CYGNI_JIT
+  for (const auto &block : blocks) {
+    munmap(block.first, block.second);
+  }
+#endif
+}
+
+bool JitMachine::IsSupported() {
+#if CYGNI_JIT
+  return HasExpectedLayout();
+#else
+  return false;
+#endif
+}
+
+/* Decides once which functions can be compiled: those that can on their
+ * own, less those calling one that cannot, until none do. */
+void JitMachine::Analyze() {
+  size_t count = module->functions.size();
+  decoded.resize(count);
+  compilable.assign(count, false);
+  for (auto &entry : entries) {
+    entry.store(nullptr);
+  }
+  if (!IsSupported()) {
+    return;
+  }
+  for (size_t i = 0; i < count; i++) {
+    decoded[i] = Decode(module->functions[i]);
+    compilable[i] = CanCompile(module->functions[i], decoded[i]);
+  }
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t i = 0; i < count; i++) {
+      if (!compilable[i]) {
+        continue;
+      }
+      for (const DecodedInstruction &instruction : decoded[i]) {
+        if ((instruction.opCode == OpCode::Call ||
+             instruction.opCode == OpCode::TailCall) &&
+            !compilable.at(instruction.operand)) {
+          compilable[i] = false;
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+}
+
+/* Compiles 'roots' and every function they reach that has no code yet
+ * into one block. Only one thread compiles. */
+void JitMachine::CompileUnit(const std::vector<int> &roots) {
+  auto begin = std::chrono::steady_clock::now();
+  std::vector<bool> inUnit(module->functions.size());
+  std::vector<int> unit;
+  std::vector<int> pending(roots.rbegin(), roots.rend());
+  while (!pending.empty()) {
+    int number = pending.back();
+    pending.pop_back();
+    if (inUnit[number] || starts[number]) {
+      continue;
+    }
+    inUnit[number] = true;
+    unit.push_back(number);
+    for (const DecodedInstruction &instruction : decoded[number]) {
+      if (instruction.opCode == OpCode::Call ||
+          instruction.opCode == OpCode::TailCall) {
+        pending.push_back(static_cast<int>(instruction.operand));
+      }
+    }
+  }
+  if (unit.empty()) {
+    return;
+  }
+
+  Translator translator(module, context, starts, tailEntries);
+  for (int number : unit) {
+    translator.Translate(number, decoded[number]);
+  }
+  translator.PatchCalls();
+#if CYGNI_JIT
+  const std::vector<uint8_t> &bytes = translator.assembler.bytes;
+  void *memory = mmap(nullptr, bytes.size(), PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory != MAP_FAILED) {
+    std::memcpy(memory, bytes.data(), bytes.size());
+    if (mprotect(memory, bytes.size(), PROT_READ | PROT_EXEC) != 0) {
+      munmap(memory, bytes.size());
+      memory = MAP_FAILED;
+    }
+  }
+  if (memory == MAP_FAILED) {
+    if (tiered) {
+      Log(Utility::UTF32ToUTF8(module->functions[unit.front()].name) +
+          ": no executable memory, stays interpreted");
+    }
+    return;
+  }
+  uint8_t *block = static_cast<uint8_t *>(memory);
+  blocks.emplace_back(memory, bytes.size());
+  codeSize += bytes.size();
+  for (int number : unit) {
+    starts[number] = block + translator.starts[number];
+    tailEntries[number] = block + translator.tailEntries[number];
+    for (const auto &loop : translator.loopEntries[number]) {
+      loopEntries[number].emplace_back(
+          loop.first, reinterpret_cast<JitEntry>(block + loop.second));
+    }
+  }
+  for (int number : unit) {
+    entries[number].store(reinterpret_cast<JitEntry>(starts[number]),
+                          std::memory_order_release);
+  }
+  if (tiered) {
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - begin;
+    Log(Utility::UTF32ToUTF8(module->functions[unit.front()].name) +
+        ": compiled with " + std::to_string(unit.size()) +
+        (unit.size() == 1 ? " function" : " functions") + " into " +
+        std::to_string(bytes.size()) + " bytes in " +
+        std::to_string(elapsed.count()) + " ms");
+  }
+#endif
+}
+
+/* The background thread. */
+void JitMachine::CompileQueued() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+    if (stopping) {
+      return;
+    }
+    int number = queue.front();
+    queue.pop_front();
+    compiling = true;
+    lock.unlock();
+    if (!entries[number].load(std::memory_order_acquire)) {
+      CompileUnit({number});
+    }
+    lock.lock();
+    compiling = false;
+    idle.notify_all();
+  }
+}
+
+void JitMachine::WaitForCompilation() {
+  std::unique_lock<std::mutex> lock(mutex);
+  idle.wait(lock, [this]() { return queue.empty() && !compiling; });
+}
+
+std::vector<std::string> JitMachine::TierLog() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return log;
+}
+
+void JitMachine::LogTiering(std::ostream *stream) {
+  std::lock_guard<std::mutex> lock(mutex);
+  logStream = stream;
+}
+
+void JitMachine::Log(const std::string &message) {
+  std::lock_guard<std::mutex> lock(mutex);
+  log.push_back(message);
+  if (logStream) {
+    *logStream << message << std::endl;
+  }
+}
+
+bool JitMachine::Hot(int function, uint32_t invocations,
+                     uint32_t backEdges) {
+  std::string decision =
+      Utility::UTF32ToUTF8(module->functions[function].name) +
+      ": hot after " + std::to_string(invocations) + " calls and " +
+      std::to_string(backEdges) + " loop iterations, ";
+  if (!compilable[function]) {
+    Log(decision + "cannot be compiled, stays interpreted");
+    return false;
+  }
+  if (entries[function].load(std::memory_order_acquire)) {
+    Log(decision + "already compiled with a caller");
+    return true;
+  }
+  bool queued = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!requested[function]) {
+      requested[function] = true;
+      queue.push_back(function);
+      queued = true;
+    }
+  }
+  if (queued) {
+    Log(decision + "queued for compilation");
+    wake.notify_one();
+  }
+  if (synchronous && compiler.joinable()) {
+    WaitForCompilation();
+  }
+  return true;
+}
+
+bool JitMachine::IsReady(int function) {
+  return entries[function].load(std::memory_order_acquire) != nullptr;
+}
+
+void JitMachine::Run(int function, Value *base, Value *stackEnd,
+                     size_t callDepth) {
+  context.stackEnd = stackEnd;
+  context.callDepth = static_cast<int32_t>(callDepth);
+  JitEntry entry = entries[function].load(std::memory_order_acquire);
+  if (entry(base, &context) != 0) {
+    throw Utility::Exception(__FILE__, __LINE__, context.error, nullptr);
+  }
+}
+
+bool JitMachine::Enter(int function, uint32_t offset, Value *base,
+                       Value *stackEnd, size_t callDepth) {
+  if (!entries[function].load(std::memory_order_acquire)) {
+    return false;
+  }
+  for (const auto &loop : loopEntries[function]) {
+    if (loop.first == offset) {
+      Log(Utility::UTF32ToUTF8(module->functions[function].name) +
+          ": replaced on the stack at the loop at " + std::to_string(offset));
+      context.stackEnd = stackEnd;
+      context.callDepth = static_cast<int32_t>(callDepth);
+      if (loop.second(base, &context) != 0) {
+        throw Utility::Exception(__FILE__, __LINE__, context.error, nullptr);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+bool JitMachine::IsCompiled(const std::u32string &name) const {
+  auto it = module->functionNumbers.find(name);
+  return it != module->functionNumbers.end() && entries[it->second].load();
+}
+
+Value JitMachine::Call(const std::u32string &name,
+                       const std::vector<Value> &arguments) {
+  auto it = module->functionNumbers.find(name);
+  if (tiered || it == module->functionNumbers.end() ||
+      !entries[it->second].load()) {
+    return machine.Call(name, arguments);
+  }
+  const BytecodeFunction &function = module->functions[it->second];
+  if (function.parameterTypes.size() != arguments.size()) {
+    throw Utility::Exception(__FILE__, __LINE__,
+                             "argument size mismatch error.", nullptr);
+  }
+  Value *base = stack.get();
+  if (context.stackEnd - base < function.frameSize + function.maxStack) {
+    throw Utility::Exception(__FILE__, __LINE__, "stack overflow.", nullptr);
+  }
+  for (size_t i = 0; i < arguments.size(); i++) {
+    if (arguments[i].type != function.parameterTypes[i]) {
+      throw Utility::Exception(__FILE__, __LINE__,
+                               "argument " + std::to_string(i) +
+                                   " type mismatch error.",
+                               nullptr);
+    }
+    base[i] = arguments[i];
+  }
+  context.callDepth = 0;
+  if (entries[it->second].load()(base, &context) != 0) {
+    throw Utility::Exception(__FILE__, __LINE__, context.error, nullptr);
+  }
+  return base[0];
+}
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
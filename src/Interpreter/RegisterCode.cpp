@@ -0,0 +1,135 @@
+#include "Interpreter/RegisterCode.hpp"
+
+#include <sstream>
+
+namespace Cygni {
+namespace Interpreter {
+
+const char *RegisterOpCodeName(RegisterOpCode opCode) {
+  switch (opCode) {
+  case RegisterOpCode::Move:
+    return "Move";
+  case RegisterOpCode::LoadConstant:
+    return "LoadConstant";
+  case RegisterOpCode::LoadString:
+    return "LoadString";
+  case RegisterOpCode::LoadDefault:
+    return "LoadDefault";
+  case RegisterOpCode::LoadGlobal:
+    return "LoadGlobal";
+  case RegisterOpCode::StoreGlobal:
+    return "StoreGlobal";
+  case RegisterOpCode::Add:
+    return "Add";
+  case RegisterOpCode::Subtract:
+    return "Subtract";
+  case RegisterOpCode::Multiply:
+    return "Multiply";
+  case RegisterOpCode::Divide:
+    return "Divide";
+  case RegisterOpCode::Equal:
+    return "Equal";
+  case RegisterOpCode::NotEqual:
+    return "NotEqual";
+  case RegisterOpCode::LessThan:
+    return "LessThan";
+  case RegisterOpCode::LessThanOrEqual:
+    return "LessThanOrEqual";
+  case RegisterOpCode::GreaterThan:
+    return "GreaterThan";
+  case RegisterOpCode::GreaterThanOrEqual:
+    return "GreaterThanOrEqual";
+  case RegisterOpCode::AddConstant:
+    return "AddConstant";
+  case RegisterOpCode::SubtractConstant:
+    return "SubtractConstant";
+  case RegisterOpCode::MultiplyConstant:
+    return "MultiplyConstant";
+  case RegisterOpCode::DivideConstant:
+    return "DivideConstant";
+  case RegisterOpCode::EqualConstant:
+    return "EqualConstant";
+  case RegisterOpCode::NotEqualConstant:
+    return "NotEqualConstant";
+  case RegisterOpCode::LessThanConstant:
+    return "LessThanConstant";
+  case RegisterOpCode::LessThanOrEqualConstant:
+    return "LessThanOrEqualConstant";
+  case RegisterOpCode::GreaterThanConstant:
+    return "GreaterThanConstant";
+  case RegisterOpCode::GreaterThanOrEqualConstant:
+    return "GreaterThanOrEqualConstant";
+  case RegisterOpCode::Not:
+    return "Not";
+  case RegisterOpCode::Jump:
+    return "Jump";
+  case RegisterOpCode::JumpIfFalse:
+    return "JumpIfFalse";
+  case RegisterOpCode::Call:
+    return "Call";
+  case RegisterOpCode::Return:
+    return "Return";
+  default:
+    return "Unknown";
+  }
+}
+
+/* One instruction per line: its index, name and operands. Registers are
+ * written 'r', constants 'k'. */
+std::string Disassemble(const RegisterFunction &function) {
+  std::ostringstream stream;
+  for (size_t i = 0; i < function.code.size(); i++) {
+    const RegisterInstruction &instruction = function.code[i];
+    stream << i << ": " << RegisterOpCodeName(instruction.opCode);
+    switch (instruction.opCode) {
+    case RegisterOpCode::Move:
+    case RegisterOpCode::Not: {
+      stream << " r" << instruction.a << " r" << instruction.b;
+      break;
+    }
+    case RegisterOpCode::LoadConstant: {
+      stream << " r" << instruction.a << " k" << instruction.b << " ("
+             << function.constants.at(instruction.b).ToString() << ")";
+      break;
+    }
+    case RegisterOpCode::LoadString:
+    case RegisterOpCode::LoadDefault:
+    case RegisterOpCode::LoadGlobal:
+    case RegisterOpCode::Call: {
+      stream << " r" << instruction.a << " " << instruction.b;
+      break;
+    }
+    case RegisterOpCode::StoreGlobal: {
+      stream << " " << instruction.a << " r" << instruction.b;
+      break;
+    }
+    case RegisterOpCode::Jump: {
+      stream << " " << instruction.Target();
+      break;
+    }
+    case RegisterOpCode::JumpIfFalse: {
+      stream << " r" << instruction.a << " " << instruction.Target();
+      break;
+    }
+    case RegisterOpCode::Return: {
+      stream << " r" << instruction.a;
+      break;
+    }
+    default: {
+      stream << " r" << instruction.a << " r" << instruction.b;
+      if (instruction.opCode >= RegisterOpCode::AddConstant) {
+        stream << " k" << instruction.c << " ("
+               << function.constants.at(instruction.c).ToString() << ")";
+      } else {
+        stream << " r" << instruction.c;
+      }
+      break;
+    }
+    }
+    stream << "\n";
+  }
+  return stream.str();
+}
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
@@ -0,0 +1,461 @@
+#include "Interpreter/RegisterCompiler.hpp"
+
+#include <algorithm>
+#include "Utility/UTF32Functions.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+using Visitors::LeftSpine;
+using Visitors::LocationKind;
+using Visitors::NameInfo;
+
+namespace {
+
+bool IsEmpty(const Type *type) {
+  return type->GetTypeCode() == TypeCode::Empty;
+}
+
+RegisterOpCode BinaryOpCode(const BinaryExpression *node) {
+  switch (node->NodeType()) {
+  case ExpressionType::Add:
+    return RegisterOpCode::Add;
+  case ExpressionType::Subtract:
+    return RegisterOpCode::Subtract;
+  case ExpressionType::Multiply:
+    return RegisterOpCode::Multiply;
+  case ExpressionType::Divide:
+    return RegisterOpCode::Divide;
+  case ExpressionType::Equal:
+    return RegisterOpCode::Equal;
+  case ExpressionType::NotEqual:
+    return RegisterOpCode::NotEqual;
+  case ExpressionType::LessThan:
+    return RegisterOpCode::LessThan;
+  case ExpressionType::LessThanOrEqual:
+    return RegisterOpCode::LessThanOrEqual;
+  case ExpressionType::GreaterThan:
+    return RegisterOpCode::GreaterThan;
+  case ExpressionType::GreaterThanOrEqual:
+    return RegisterOpCode::GreaterThanOrEqual;
+  default:
+    throw TreeException(__FILE__, __LINE__,
+                        "The operator is not supported by the interpreter.",
+                        node, nullptr);
+  }
+}
+
+RegisterOpCode ConstantForm(RegisterOpCode opCode) {
+  return static_cast<RegisterOpCode>(
+      static_cast<int>(opCode) - static_cast<int>(RegisterOpCode::Add) +
+      static_cast<int>(RegisterOpCode::AddConstant));
+}
+
+/* Whether evaluating 'node' can change a variable. A variable read as the
+ * left operand of a binary expression is used in place only if the right
+ * operand cannot; this also covers a block's variable whose register the
+ * right operand's own variables would reuse. Every other use of a value
+ * takes it right away. */
+bool IsPure(const Expression *node) {
+  switch (node->NodeType()) {
+  case ExpressionType::Constant:
+  case ExpressionType::Parameter:
+  case ExpressionType::Default:
+    return true;
+  case ExpressionType::Not:
+    return IsPure(static_cast<const UnaryExpression *>(node)->Operand());
+  case ExpressionType::Call: {
+    const auto &arguments =
+        static_cast<const CallExpression *>(node)->Arguments();
+    return std::all_of(arguments.begin(), arguments.end(), IsPure);
+  }
+  case ExpressionType::Assign:
+    return false;
+  default: {
+    if (const auto binary = dynamic_cast<const BinaryExpression *>(node)) {
+      auto spine = LeftSpine(binary);
+      return IsPure(spine.back()->Left()) &&
+             std::all_of(spine.begin(), spine.end(),
+                         [](const BinaryExpression *operation) {
+                           return operation->NodeType() !=
+                                      ExpressionType::Assign &&
+                                  IsPure(operation->Right());
+                         });
+    }
+    return false;
+  }
+  }
+}
+
+}; /* namespace */
+
+RegisterCompiler::RegisterCompiler(Driver::CompilerDatabase *database)
+    : database{database}, module(), lambdas(), stringNumbers(),
+      function{nullptr}, bodyTypes{nullptr}, slots{nullptr}, temporaryTop{0} {
+}
+
+RegisterModule RegisterCompiler::Compile() {
+  const Driver::FunctionIndex &index = database->Functions();
+  module.functions.resize(index.size());
+  lambdas.resize(index.size());
+  for (const auto &item : index) {
+    const std::u32string &name = item.first;
+    const Driver::FunctionAst &ast = database->AstOfFunction(name);
+    std::string diagnostic = database->DiagnosticOfFunction(name);
+    if (!diagnostic.empty()) {
+      throw Utility::Exception(__FILE__, __LINE__, diagnostic, nullptr);
+    }
+    int number = item.second.number;
+    RegisterFunction &compiled = module.functions.at(number);
+    compiled.name = name;
+    compiled.parameterCount =
+        static_cast<int>(ast.function->Parameters().size());
+    for (const auto &parameter : ast.function->Parameters()) {
+      compiled.parameterTypes.push_back(parameter->GetType()->GetTypeCode());
+    }
+    compiled.returnType = ast.function->ReturnType()->GetTypeCode();
+    lambdas.at(number) = ast.function;
+    module.functionNumbers[name] = number;
+  }
+  for (const auto &item : index) {
+    CompileFunction(item.first, item.second.number);
+  }
+  return std::move(module);
+}
+
+int RegisterCompiler::VisitBinary(const BinaryExpression *node, int target) {
+  if (node->NodeType() == ExpressionType::Assign) {
+    return Assign(node);
+  }
+  int mark = temporaryTop;
+  auto spine = LeftSpine(node);
+  int left = Compile(spine.back()->Left(), AnyRegister);
+  for (auto it = spine.rbegin(); it != spine.rend(); it++) {
+    const BinaryExpression *operation = *it;
+    const Expression *right = operation->Right();
+    RegisterOpCode opCode = BinaryOpCode(operation);
+    int operand;
+    if (right->NodeType() == ExpressionType::Constant &&
+        static_cast<const ConstantExpression *>(right)->GetTypeCode() !=
+            TypeCode::String) {
+      opCode = ConstantForm(opCode);
+      operand = Locate(right).number;
+    } else {
+      if (IsVariable(left) && !IsPure(right)) {
+        int copy = Allocate();
+        Emit(RegisterOpCode::Move, copy, left, 0);
+        left = copy;
+      }
+      operand = Compile(right, AnyRegister);
+    }
+    int destination;
+    if (operation == node && target != AnyRegister) {
+      destination = target;
+    } else if (left >= mark && !IsVariable(left)) {
+      destination = left;
+    } else {
+      temporaryTop = mark;
+      destination = Allocate();
+    }
+    Emit(opCode, destination, left, operand);
+    Release(mark, destination);
+    left = destination;
+  }
+  return left;
+}
+
+int RegisterCompiler::VisitConstant(const ConstantExpression *node,
+                                    int target) {
+  int destination = Destination(target);
+  if (node->GetTypeCode() == TypeCode::String) {
+    Emit(RegisterOpCode::LoadString, destination, StringNumber(node), 0);
+  } else {
+    Emit(RegisterOpCode::LoadConstant, destination, Locate(node).number, 0);
+  }
+  return destination;
+}
+
+int RegisterCompiler::VisitParameter(const ParameterExpression *node,
+                                     int target) {
+  const NameInfo &nameInfo = Locate(node);
+  if (IsEmpty(TypeOf(node))) {
+    return NoRegister;
+  } else if (nameInfo.kind == LocationKind::FunctionVariable) {
+    return nameInfo.number;
+  } else if (nameInfo.kind == LocationKind::Global) {
+    int destination = Destination(target);
+    Emit(RegisterOpCode::LoadGlobal, destination, nameInfo.number, 0);
+    return destination;
+  } else {
+    throw TreeException(__FILE__, __LINE__,
+                        "Functions can only be called by the interpreter.",
+                        node, nullptr);
+  }
+}
+
+int RegisterCompiler::VisitBlock(const BlockExpression *node, int target) {
+  int mark = temporaryTop;
+  const auto &expressions = node->Expressions();
+  int result = NoRegister;
+  for (size_t i = 0; i < expressions.size(); i++) {
+    temporaryTop = mark;
+    if (i + 1 < expressions.size()) {
+      Compile(expressions[i], AnyRegister);
+    } else {
+      result = Compile(expressions[i], target);
+    }
+  }
+  Release(mark, result);
+  return result;
+}
+
+int RegisterCompiler::VisitConditional(const ConditionalExpression *node,
+                                       int target) {
+  const Type *type = TypeOf(node);
+  int mark = temporaryTop;
+  int result = NoRegister;
+  if (!IsEmpty(type)) {
+    result = IsVariable(target) ? Allocate() : Destination(target);
+  }
+  int top = temporaryTop;
+  int test = Compile(node->Test(), AnyRegister);
+  size_t ifFalse = function->code.size();
+  Emit(RegisterOpCode::JumpIfFalse, test, 0, 0);
+  temporaryTop = top;
+  Compile(node->IfTrue(), IsEmpty(type) ? AnyRegister : result, type);
+  size_t end = function->code.size();
+  Emit(RegisterOpCode::Jump, 0, 0, 0);
+  function->code.at(ifFalse).SetTarget(function->code.size());
+  temporaryTop = top;
+  Compile(node->IfFalse(), IsEmpty(type) ? AnyRegister : result, type);
+  function->code.at(end).SetTarget(function->code.size());
+  Release(mark, result);
+  return result;
+}
+
+int RegisterCompiler::VisitUnary(const UnaryExpression *node, int target) {
+  if (node->NodeType() != ExpressionType::Not) {
+    throw TreeException(__FILE__, __LINE__,
+                        "The operator is not supported by the interpreter.",
+                        node, nullptr);
+  }
+  int mark = temporaryTop;
+  int operand = Compile(node->Operand(), AnyRegister);
+  int destination = target;
+  if (destination == AnyRegister) {
+    temporaryTop = mark;
+    destination = Allocate();
+  }
+  Emit(RegisterOpCode::Not, destination, operand, 0);
+  Release(mark, destination);
+  return destination;
+}
+
+/* The arguments are evaluated into consecutive temporaries, which become
+ * the first registers of the callee. */
+int RegisterCompiler::VisitCall(const CallExpression *node, int target) {
+  if (node->Function()->NodeType() != ExpressionType::Parameter ||
+      Locate(node->Function()).kind != LocationKind::Function) {
+    throw TreeException(__FILE__, __LINE__,
+                        "Only functions can be called by the interpreter.",
+                        node, nullptr);
+  }
+  int number = Locate(node->Function()).number;
+  const LambdaExpression *callee = lambdas.at(number);
+  int mark = temporaryTop;
+  int base = temporaryTop;
+  for (size_t i = 0; i < node->Arguments().size(); i++) {
+    int argument = Allocate();
+    Compile(node->Arguments()[i], argument,
+            callee->Parameters().at(i)->GetType());
+    temporaryTop = argument + 1;
+  }
+  temporaryTop = base;
+  Allocate();
+  Emit(RegisterOpCode::Call, base, number, 0);
+  Release(mark, base);
+  return base;
+}
+
+int RegisterCompiler::VisitLambda(const LambdaExpression *node, int target) {
+  throw TreeException(__FILE__, __LINE__,
+                      "Nested functions are not supported by the interpreter.",
+                      node, nullptr);
+}
+
+/* The loop's value is kept in its own register, which may not be a
+ * variable the loop still reads. */
+int RegisterCompiler::VisitLoop(const LoopExpression *node, int target) {
+  int mark = temporaryTop;
+  Compile(node->Initializer(), AnyRegister);
+  temporaryTop = mark;
+  const Type *type = TypeOf(node->Body());
+  int result = NoRegister;
+  if (!IsEmpty(type)) {
+    result = IsVariable(target) ? Allocate() : Destination(target);
+    Emit(RegisterOpCode::LoadDefault, result,
+         static_cast<int>(type->GetTypeCode()), 0);
+  }
+  int top = temporaryTop;
+  size_t start = function->code.size();
+  int condition = Compile(node->Condition(), AnyRegister);
+  size_t end = function->code.size();
+  Emit(RegisterOpCode::JumpIfFalse, condition, 0, 0);
+  temporaryTop = top;
+  Compile(node->Body(), IsEmpty(type) ? AnyRegister : result);
+  temporaryTop = top;
+  Emit(RegisterOpCode::Jump, 0, 0, 0);
+  function->code.back().SetTarget(start);
+  function->code.at(end).SetTarget(function->code.size());
+  Release(mark, result);
+  return result;
+}
+
+int RegisterCompiler::VisitDefault(const DefaultExpression *node,
+                                   int target) {
+  const Type *type = TypeOf(node);
+  if (IsEmpty(type)) {
+    return NoRegister;
+  }
+  int destination = Destination(target);
+  Emit(RegisterOpCode::LoadDefault, destination,
+       static_cast<int>(type->GetTypeCode()), 0);
+  return destination;
+}
+
+int RegisterCompiler::VisitVariableDeclaration(
+    const VariableDeclarationExpression *node, int target) {
+  if (IsEmpty(TypeOf(node->Initializer()))) {
+    Compile(node->Initializer(), AnyRegister);
+  } else {
+    Compile(node->Initializer(), Locate(node).number);
+  }
+  return NoRegister;
+}
+
+void RegisterCompiler::CompileFunction(const std::u32string &name,
+                                       int number) {
+  const LambdaExpression *lambda = lambdas.at(number);
+  function = &module.functions.at(number);
+  bodyTypes = &database->TypeOfBody(name);
+  slots = &database->SlotsOfFunction(name);
+  function->frameSize = slots->frame.frameSize;
+  function->registerCount = function->frameSize;
+  for (const auto &constant : slots->frame.constants.Constants()) {
+    function->constants.push_back(ConstantValue(constant));
+  }
+  temporaryTop = function->frameSize;
+  int result = Compile(lambda->Body(), AnyRegister, lambda->ReturnType());
+  if (result == NoRegister) {
+    result = Allocate();
+    Emit(RegisterOpCode::LoadDefault, result,
+         static_cast<int>(TypeCode::Empty), 0);
+  }
+  Emit(RegisterOpCode::Return, result, 0, 0);
+}
+
+/* Leaves the value in 'target' unless any register will do. */
+int RegisterCompiler::Compile(const Expression *node, int target) {
+  int result = Visit(node, target);
+  if (target != AnyRegister && result != NoRegister && result != target) {
+    Emit(RegisterOpCode::Move, target, result, 0);
+    return target;
+  }
+  return result;
+}
+
+/* The type checker only lets a value flow into a different type when the
+ * target is a union containing it. Values carry their type code, so only a
+ * missing Empty value has to be materialized. */
+int RegisterCompiler::Compile(const Expression *node, int target,
+                              const Type *type) {
+  const Type *from = TypeOf(node);
+  if (TypeFactory::AreTypesEqual(from, type)) {
+    return Compile(node, target);
+  } else if (type->GetTypeCode() != TypeCode::Union) {
+    throw TreeException(__FILE__, __LINE__, "type mismatch error.", node,
+                        nullptr);
+  } else if (IsEmpty(from)) {
+    Compile(node, AnyRegister);
+    int destination = Destination(target);
+    Emit(RegisterOpCode::LoadDefault, destination,
+         static_cast<int>(TypeCode::Empty), 0);
+    return destination;
+  } else {
+    return Compile(node, target);
+  }
+}
+
+const Type *RegisterCompiler::TypeOf(const Expression *node) const {
+  return bodyTypes->nodeTypes.at(node);
+}
+
+const NameInfo &RegisterCompiler::Locate(const Expression *node) const {
+  return slots->nameInfoTable.at(node);
+}
+
+int RegisterCompiler::Assign(const BinaryExpression *node) {
+  const Type *type = TypeOf(node->Left());
+  const NameInfo &nameInfo = Locate(node->Left());
+  if (IsEmpty(type)) {
+    Compile(node->Right(), AnyRegister);
+  } else if (nameInfo.kind == LocationKind::FunctionVariable) {
+    Compile(node->Right(), nameInfo.number, type);
+  } else if (nameInfo.kind == LocationKind::Global) {
+    int value = Compile(node->Right(), AnyRegister, type);
+    Emit(RegisterOpCode::StoreGlobal, nameInfo.number, value, 0);
+  } else {
+    throw TreeException(__FILE__, __LINE__,
+                        "Only variables can be assigned by the interpreter.",
+                        node, nullptr);
+  }
+  return NoRegister;
+}
+
+int RegisterCompiler::StringNumber(const ConstantExpression *node) {
+  const std::u32string &text =
+      *std::any_cast<std::u32string>(&node->Value());
+  auto it = stringNumbers.find(text);
+  if (it == stringNumbers.end()) {
+    it = stringNumbers
+             .insert({text, static_cast<int>(module.strings.size())})
+             .first;
+    module.strings.push_back(ConstantValue(node));
+  }
+  return it->second;
+}
+
+bool RegisterCompiler::IsVariable(int reg) const {
+  return reg != NoRegister && reg < function->frameSize;
+}
+
+int RegisterCompiler::Allocate() {
+  int reg = temporaryTop++;
+  function->registerCount = std::max(function->registerCount, temporaryTop);
+  return reg;
+}
+
+int RegisterCompiler::Destination(int target) {
+  return target == AnyRegister ? Allocate() : target;
+}
+
+/* Frees the temporaries above 'mark' except the one holding 'result'. */
+void RegisterCompiler::Release(int mark, int result) {
+  temporaryTop = result >= mark ? result + 1 : mark;
+}
+
+void RegisterCompiler::Emit(RegisterOpCode opCode, int a, int b, int c) {
+  for (int operand : {a, b, c}) {
+    if (operand < 0 || operand > UINT16_MAX) {
+      throw Utility::Exception(__FILE__, __LINE__,
+                               "The function is too large for registers.",
+                               nullptr);
+    }
+  }
+  function->code.emplace_back(opCode, static_cast<uint16_t>(a),
+                              static_cast<uint16_t>(b),
+                              static_cast<uint16_t>(c));
+}
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
@@ -0,0 +1,222 @@
+#include "Interpreter/RegisterMachine.hpp"
+
+#include "Interpreter/Arithmetic.hpp"
+#include "Utility/Exception.hpp"
+#include "Utility/UTF32Functions.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+RegisterMachine::RegisterMachine(const RegisterModule *module,
+                                 size_t stackSize, size_t maxCallDepth)
+    : module{module}, stack(new Value[stackSize]),
+      stackEnd{stack.get() + stackSize}, globals(module->globals), frames(),
+      maxCallDepth{maxCallDepth}, counting{false}, instructionCount{0} {
+  frames.reserve(maxCallDepth);
+}
+
+Value RegisterMachine::Call(const std::u32string &name,
+                            const std::vector<Value> &arguments) {
+  auto it = module->functionNumbers.find(name);
+  if (it == module->functionNumbers.end()) {
+    throw Utility::Exception(__FILE__, __LINE__,
+                             Utility::UTF32ToUTF8(U"'" + name +
+                                                  U"' not defined."),
+                             nullptr);
+  }
+  const RegisterFunction *function = &module->functions.at(it->second);
+  if (function->parameterTypes.size() != arguments.size()) {
+    throw Utility::Exception(__FILE__, __LINE__,
+                             "argument size mismatch error.", nullptr);
+  }
+  Value *base = stack.get();
+  if (stackEnd - base < function->registerCount) {
+    throw Utility::Exception(__FILE__, __LINE__, "stack overflow.", nullptr);
+  }
+  for (size_t i = 0; i < arguments.size(); i++) {
+    if (arguments[i].type != function->parameterTypes[i]) {
+      throw Utility::Exception(__FILE__, __LINE__,
+                               "argument " + std::to_string(i) +
+                                   " type mismatch error.",
+                               nullptr);
+    }
+    base[i] = arguments[i];
+  }
+  frames.clear();
+  if (counting) {
+    return Run<true>(function, base);
+  } else {
+    return Run<false>(function, base);
+  }
+}
+
+template <bool Counting>
+Value RegisterMachine::Run(const RegisterFunction *function, Value *base) {
+  const RegisterInstruction *code = function->code.data();
+  const RegisterInstruction *ip = code;
+  const Value *constants = function->constants.data();
+  for (;;) {
+    if constexpr (Counting) {
+      instructionCount++;
+    }
+    const RegisterInstruction &i = *ip++;
+    switch (i.opCode) {
+    case RegisterOpCode::Move: {
+      base[i.a] = base[i.b];
+      break;
+    }
+    case RegisterOpCode::LoadConstant: {
+      base[i.a] = constants[i.b];
+      break;
+    }
+    case RegisterOpCode::LoadString: {
+      base[i.a] = module->strings[i.b];
+      break;
+    }
+    case RegisterOpCode::LoadDefault: {
+      base[i.a] = Value::Default(static_cast<TypeCode>(i.b));
+      break;
+    }
+    case RegisterOpCode::LoadGlobal: {
+      base[i.a] = globals[i.b];
+      break;
+    }
+    case RegisterOpCode::StoreGlobal: {
+      globals[i.a] = base[i.b];
+      break;
+    }
+    case RegisterOpCode::Add: {
+      Arithmetic(base[i.a], base[i.b], base[i.c], AddOperation());
+      break;
+    }
+    case RegisterOpCode::Subtract: {
+      Arithmetic(base[i.a], base[i.b], base[i.c], SubtractOperation());
+      break;
+    }
+    case RegisterOpCode::Multiply: {
+      Arithmetic(base[i.a], base[i.b], base[i.c], MultiplyOperation());
+      break;
+    }
+    case RegisterOpCode::Divide: {
+      Arithmetic(base[i.a], base[i.b], base[i.c], DivideOperation());
+      break;
+    }
+    case RegisterOpCode::Equal: {
+      Compare(base[i.a], base[i.b], base[i.c], std::equal_to<>());
+      break;
+    }
+    case RegisterOpCode::NotEqual: {
+      Compare(base[i.a], base[i.b], base[i.c], std::not_equal_to<>());
+      break;
+    }
+    case RegisterOpCode::LessThan: {
+      Compare(base[i.a], base[i.b], base[i.c], std::less<>());
+      break;
+    }
+    case RegisterOpCode::LessThanOrEqual: {
+      Compare(base[i.a], base[i.b], base[i.c], std::less_equal<>());
+      break;
+    }
+    case RegisterOpCode::GreaterThan: {
+      Compare(base[i.a], base[i.b], base[i.c], std::greater<>());
+      break;
+    }
+    case RegisterOpCode::GreaterThanOrEqual: {
+      Compare(base[i.a], base[i.b], base[i.c], std::greater_equal<>());
+      break;
+    }
+    case RegisterOpCode::AddConstant: {
+      Arithmetic(base[i.a], base[i.b], constants[i.c], AddOperation());
+      break;
+    }
+    case RegisterOpCode::SubtractConstant: {
+      Arithmetic(base[i.a], base[i.b], constants[i.c], SubtractOperation());
+      break;
+    }
+    case RegisterOpCode::MultiplyConstant: {
+      Arithmetic(base[i.a], base[i.b], constants[i.c], MultiplyOperation());
+      break;
+    }
+    case RegisterOpCode::DivideConstant: {
+      Arithmetic(base[i.a], base[i.b], constants[i.c], DivideOperation());
+      break;
+    }
+    case RegisterOpCode::EqualConstant: {
+      Compare(base[i.a], base[i.b], constants[i.c], std::equal_to<>());
+      break;
+    }
+    case RegisterOpCode::NotEqualConstant: {
+      Compare(base[i.a], base[i.b], constants[i.c], std::not_equal_to<>());
+      break;
+    }
+    case RegisterOpCode::LessThanConstant: {
+      Compare(base[i.a], base[i.b], constants[i.c], std::less<>());
+      break;
+    }
+    case RegisterOpCode::LessThanOrEqualConstant: {
+      Compare(base[i.a], base[i.b], constants[i.c], std::less_equal<>());
+      break;
+    }
+    case RegisterOpCode::GreaterThanConstant: {
+      Compare(base[i.a], base[i.b], constants[i.c], std::greater<>());
+      break;
+    }
+    case RegisterOpCode::GreaterThanOrEqualConstant: {
+      Compare(base[i.a], base[i.b], constants[i.c], std::greater_equal<>());
+      break;
+    }
+    case RegisterOpCode::Not: {
+      base[i.a].type = TypeCode::Boolean;
+      base[i.a].boolean = !base[i.b].boolean;
+      break;
+    }
+    case RegisterOpCode::Jump: {
+      ip = code + i.Target();
+      break;
+    }
+    case RegisterOpCode::JumpIfFalse: {
+      if (!base[i.a].boolean) {
+        ip = code + i.Target();
+      }
+      break;
+    }
+    case RegisterOpCode::Call: {
+      const RegisterFunction *callee = &module->functions[i.b];
+      Value *calleeBase = base + i.a;
+      if (frames.size() == maxCallDepth ||
+          stackEnd - calleeBase < callee->registerCount) {
+        throw Utility::Exception(__FILE__, __LINE__, "stack overflow.",
+                                 nullptr);
+      }
+      frames.push_back(RegisterFrame{function, ip, base});
+      function = callee;
+      constants = callee->constants.data();
+      code = callee->code.data();
+      ip = code;
+      base = calleeBase;
+      break;
+    }
+    case RegisterOpCode::Return: {
+      if (frames.empty()) {
+        return std::move(base[i.a]);
+      }
+      *base = std::move(base[i.a]);
+      const RegisterFrame &frame = frames.back();
+      function = frame.function;
+      constants = function->constants.data();
+      code = function->code.data();
+      ip = frame.returnAddress;
+      base = frame.base;
+      frames.pop_back();
+      break;
+    }
+    default: {
+      throw Utility::Exception(__FILE__, __LINE__, "invalid instruction.",
+                               nullptr);
+    }
+    }
+  }
+}
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
@@ -0,0 +1,48 @@
+#include "Interpreter/SequenceProfile.hpp"
+
+#include <algorithm>
+
+namespace Cygni {
+namespace Interpreter {
+
+std::vector<OpCodeSequence> SequenceProfile::Top(int length, size_t n) const {
+  std::vector<OpCodeSequence> sequences;
+  for (const auto &pair : counts) {
+    if (static_cast<int>(pair.first >> 32) == length) {
+      OpCodeSequence sequence;
+      for (int i = length - 1; i >= 0; i--) {
+        sequence.opCodes.push_back(
+            static_cast<OpCode>((pair.first >> (8 * i)) & 0xFF));
+      }
+      sequence.count = pair.second;
+      sequences.push_back(sequence);
+    }
+  }
+  std::sort(sequences.begin(), sequences.end(),
+            [](const OpCodeSequence &x, const OpCodeSequence &y) {
+              return x.count > y.count ||
+                     (x.count == y.count && x.opCodes < y.opCodes);
+            });
+  if (sequences.size() > n) {
+    sequences.resize(n);
+  }
+  return sequences;
+}
+
+std::string SequenceProfile::ToString(size_t n) const {
+  std::string text;
+  for (int length = 2; length <= MaxLength; length++) {
+    for (const auto &sequence : Top(length, n)) {
+      text += std::to_string(sequence.count) + ":";
+      for (OpCode opCode : sequence.opCodes) {
+        text += " ";
+        text += OpCodeName(opCode);
+      }
+      text += "\n";
+    }
+  }
+  return text;
+}
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
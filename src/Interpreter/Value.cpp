@@ -0,0 +1,144 @@
+#include "Interpreter/Value.hpp"
+
+#include <sstream>
+#include "Expressions/Literal.hpp"
+#include "Expressions/TreeException.hpp"
+#include "Utility/UTF32Functions.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+Value Value::Int32(int32_t value) {
+  Value result;
+  result.type = TypeCode::Int32;
+  result.int32 = value;
+  return result;
+}
+
+Value Value::Int64(int64_t value) {
+  Value result;
+  result.type = TypeCode::Int64;
+  result.int64 = value;
+  return result;
+}
+
+Value Value::Float32(float value) {
+  Value result;
+  result.type = TypeCode::Float32;
+  result.float32 = value;
+  return result;
+}
+
+Value Value::Float64(double value) {
+  Value result;
+  result.type = TypeCode::Float64;
+  result.float64 = value;
+  return result;
+}
+
+Value Value::Boolean(bool value) {
+  Value result;
+  result.type = TypeCode::Boolean;
+  result.boolean = value;
+  return result;
+}
+
+Value Value::Char(char32_t value) {
+  Value result;
+  result.type = TypeCode::Char;
+  result.character = value;
+  return result;
+}
+
+Value Value::Text(const std::u32string &value) {
+  Value result;
+  result.type = TypeCode::String;
+  result.string = std::make_shared<const std::u32string>(value);
+  return result;
+}
+
+Value Value::Function(int32_t number) {
+  Value result;
+  result.type = TypeCode::Callable;
+  result.function = number;
+  return result;
+}
+
+Value Value::Default(TypeCode typeCode) {
+  static const String empty = std::make_shared<const std::u32string>();
+  Value result;
+  result.type = typeCode;
+  if (typeCode == TypeCode::String) {
+    result.string = empty;
+  }
+  return result;
+}
+
+Value ConstantValue(const Expressions::ConstantExpression *node) {
+  Expressions::Literal literal(node);
+  switch (literal.typeCode) {
+  case TypeCode::Int32:
+    return Value::Int32(literal.int32);
+  case TypeCode::Int64:
+    return Value::Int64(literal.int64);
+  case TypeCode::Float32:
+    return Value::Float32(literal.float32);
+  case TypeCode::Float64:
+    return Value::Float64(literal.float64);
+  case TypeCode::Boolean:
+    return Value::Boolean(literal.boolean);
+  case TypeCode::Char:
+    return Value::Char(literal.character);
+  case TypeCode::String:
+    return Value::Text(literal.text);
+  default:
+    throw Expressions::TreeException(
+        __FILE__, __LINE__,
+        "The constant is not supported by the interpreter.", node, nullptr);
+  }
+}
+
+std::string Value::ToString() const {
+  std::ostringstream stream;
+  switch (type) {
+  case TypeCode::Int32: {
+    stream << int32;
+    break;
+  }
+  case TypeCode::Int64: {
+    stream << int64;
+    break;
+  }
+  case TypeCode::Float32: {
+    stream << float32;
+    break;
+  }
+  case TypeCode::Float64: {
+    stream << float64;
+    break;
+  }
+  case TypeCode::Boolean: {
+    stream << (boolean ? "true" : "false");
+    break;
+  }
+  case TypeCode::Char: {
+    stream << Utility::UTF32ToUTF8(std::u32string(1, character));
+    break;
+  }
+  case TypeCode::String: {
+    stream << Utility::UTF32ToUTF8(*string);
+    break;
+  }
+  case TypeCode::Callable: {
+    stream << "function " << function;
+    break;
+  }
+  default: {
+    break;
+  }
+  }
+  return stream.str();
+}
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
@@ -0,0 +1,837 @@
+#include "Interpreter/VirtualMachine.hpp"
+
+#include <algorithm>
+#include "Interpreter/Arithmetic.hpp"
+#include "Utility/Exception.hpp"
+#include "Utility/UTF32Functions.hpp"
+
+namespace Cygni {
+namespace Interpreter {
+
+namespace {
+
+/* Whether 'sequence' starts at instruction 'i' and nothing jumps into its
+ * middle. */
+bool Matches(const std::vector<DecodedInstruction> &instructions, size_t i,
+             const std::vector<OpCode> &sequence,
+             const std::vector<bool> &isTarget) {
+  if (i + sequence.size() > instructions.size()) {
+    return false;
+  }
+  for (size_t k = 0; k < sequence.size(); k++) {
+    if (instructions[i + k].opCode != sequence[k] ||
+        (k > 0 && isTarget[instructions[i + k].offset])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}; /* namespace */
+
+VirtualMachine::VirtualMachine(const BytecodeModule *module, size_t stackSize,
+                               size_t maxCallDepth)
+    : module{module}, stack(new Value[stackSize]),
+      stackEnd{stack.get() + stackSize}, globals(module->globals), frames(),
+      maxCallDepth{maxCallDepth}, threaded(), handlers{nullptr},
+      handlerOpCodes(), counting{false}, instructionCount{0}, quickenings{0},
+      deoptimizations{0}, cacheHits{0}, cacheMisses{0},
+      megamorphicTransitions{0}, profile{nullptr},
+      fusing(static_cast<size_t>(OpCode::OpCodeCount), true), tier{nullptr},
+      invocationThreshold{0}, backEdgeThreshold{0} {
+  frames.reserve(maxCallDepth);
+}
+
+Value VirtualMachine::Call(const std::u32string &name,
+                           const std::vector<Value> &arguments) {
+  auto it = module->functionNumbers.find(name);
+  if (it == module->functionNumbers.end()) {
+    throw Utility::Exception(__FILE__, __LINE__,
+                             Utility::UTF32ToUTF8(U"'" + name +
+                                                  U"' not defined."),
+                             nullptr);
+  }
+  const BytecodeFunction *function = &module->functions.at(it->second);
+  if (function->parameterTypes.size() != arguments.size()) {
+    throw Utility::Exception(__FILE__, __LINE__,
+                             "argument size mismatch error.", nullptr);
+  }
+  Value *base = stack.get();
+  if (stackEnd - base < function->frameSize + function->maxStack) {
+    throw Utility::Exception(__FILE__, __LINE__, "stack overflow.", nullptr);
+  }
+  for (size_t i = 0; i < arguments.size(); i++) {
+    if (function->parameterTypes[i] != TypeCode::Union &&
+        arguments[i].type != function->parameterTypes[i]) {
+      throw Utility::Exception(__FILE__, __LINE__,
+                               "argument " + std::to_string(i) +
+                                   " type mismatch error.",
+                               nullptr);
+    }
+    base[i] = arguments[i];
+  }
+  if (threaded.empty()) {
+    Thread();
+  }
+  frames.clear();
+  if (profile) {
+    profile->Break();
+  }
+  ThreadedFunction *entry = &threaded.at(it->second);
+  if (tier && Promote(entry, entry->invocations, invocationThreshold)) {
+    tier->Run(it->second, base, stackEnd, 0);
+    return std::move(base[0]);
+  }
+  if (counting) {
+    return Run<true>(entry, base);
+  } else {
+    return Run<false>(entry, base);
+  }
+}
+
+/* The two loops have their own handlers, so the code is threaded again. */
+void VirtualMachine::CountInstructions(bool enabled) {
+  if (enabled != counting) {
+    counting = enabled;
+    threaded.clear();
+  }
+}
+
+void VirtualMachine::Thread() {
+#if CYGNI_THREADED_DISPATCH
+  if (counting) {
+    Run<true>(nullptr, nullptr);
+  } else {
+    Run<false>(nullptr, nullptr);
+  }
+  for (int i = 0; i < static_cast<int>(OpCode::OpCodeCount); i++) {
+    handlerOpCodes[handlers[i]] = static_cast<OpCode>(i);
+  }
+#endif
+  threaded.resize(module->functions.size());
+  for (size_t i = 0; i < threaded.size(); i++) {
+    const BytecodeFunction &function = module->functions[i];
+    std::vector<DecodedInstruction> instructions = Decode(function);
+    std::vector<bool> isTarget(function.code.size() + 1);
+    size_t cacheCount = 0;
+    for (const DecodedInstruction &instruction : instructions) {
+      if (instruction.opCode == OpCode::Jump ||
+          instruction.opCode == OpCode::JumpIfFalse) {
+        isTarget[instruction.operand] = true;
+      } else if (instruction.opCode == OpCode::CallIndirect) {
+        cacheCount++;
+      }
+    }
+    threaded[i].caches.assign(cacheCount, InlineCache());
+    InlineCache *nextCache = threaded[i].caches.data();
+    std::vector<ThreadedCell> &code = threaded[i].code;
+    std::vector<size_t> cellOf(function.code.size() + 1);
+    std::vector<std::pair<size_t, size_t>> jumps;
+    threaded[i].function = &function;
+    size_t j = 0;
+    while (j < instructions.size()) {
+      OpCode opCode = instructions[j].opCode;
+      size_t length = 1;
+      for (const Superinstruction &superinstruction : Superinstructions()) {
+        if (fusing[static_cast<int>(superinstruction.opCode)] &&
+            Matches(instructions, j, superinstruction.sequence, isTarget)) {
+          opCode = superinstruction.opCode;
+          length = superinstruction.sequence.size();
+          break;
+        }
+      }
+      cellOf[instructions[j].offset] = code.size();
+      ThreadedCell cell;
+#if CYGNI_THREADED_DISPATCH
+      cell.handler = handlers[static_cast<int>(opCode)];
+#else
+      cell.opCode = opCode;
+#endif
+      code.push_back(cell);
+      for (size_t k = j; k < j + length; k++) {
+        const DecodedInstruction &instruction = instructions[k];
+        switch (instruction.opCode) {
+        case OpCode::PushConstant:
+        case OpCode::PushString:
+        case OpCode::PushDefault:
+        case OpCode::LoadLocal:
+        case OpCode::StoreLocal:
+        case OpCode::LoadGlobal:
+        case OpCode::StoreGlobal:
+        case OpCode::PushFunction: {
+          cell.operand = instruction.operand;
+          code.push_back(cell);
+          break;
+        }
+        case OpCode::Call:
+        case OpCode::TailCall: {
+          cell.function = &threaded.at(instruction.operand);
+          code.push_back(cell);
+          break;
+        }
+        case OpCode::CallIndirect: {
+          cell.operand = instruction.operand;
+          code.push_back(cell);
+          cell.cache = nextCache++;
+          code.push_back(cell);
+          break;
+        }
+        case OpCode::Jump:
+        case OpCode::JumpIfFalse: {
+          jumps.emplace_back(code.size(), instruction.operand);
+          code.push_back(cell);
+          break;
+        }
+        default: {
+          break;
+        }
+        }
+      }
+      j += length;
+    }
+    cellOf[function.code.size()] = code.size();
+    for (const auto &jump : jumps) {
+      ThreadedCell *target = code.data() + cellOf.at(jump.second);
+      code[jump.first].target = target;
+      std::pair<const ThreadedCell *, uint32_t> loop(
+          target, static_cast<uint32_t>(jump.second));
+      std::vector<std::pair<const ThreadedCell *, uint32_t>> &loops =
+          threaded[i].loops;
+      if (cellOf[jump.second] < jump.first &&
+          std::find(loops.begin(), loops.end(), loop) == loops.end()) {
+        loops.push_back(loop);
+      }
+    }
+  }
+}
+
+/* A cache miss: checks the function against the call site and remembers
+ * it while the site is not megamorphic. */
+ThreadedFunction *VirtualMachine::Resolve(InlineCache *cache, int32_t number,
+                                          uint32_t argumentCount) {
+  ThreadedFunction *function = &threaded.at(number);
+  if (function->function->parameterCount !=
+      static_cast<int>(argumentCount)) {
+    throw Utility::Exception(__FILE__, __LINE__,
+                             "argument size mismatch error.", nullptr);
+  }
+  cacheMisses++;
+  if (cache->size < InlineCache::Capacity) {
+    cache->entries[cache->size++] = InlineCache::Entry{number, function};
+  } else if (!cache->megamorphic) {
+    cache->megamorphic = true;
+    megamorphicTransitions++;
+  }
+  return function;
+}
+
+void VirtualMachine::UseTier(NativeTier *tier, uint32_t invocationThreshold,
+                             uint32_t backEdgeThreshold) {
+  this->tier = tier;
+  this->invocationThreshold = invocationThreshold;
+  this->backEdgeThreshold = backEdgeThreshold;
+  threaded.clear();
+}
+
+/* Counts a call or a loop iteration and returns whether native code runs
+ * the function now. */
+inline bool VirtualMachine::Promote(ThreadedFunction *function,
+                                    uint32_t &count, uint32_t threshold) {
+  switch (function->tier) {
+  case TierState::Native:
+    return true;
+  case TierState::Interpreted:
+    return false;
+  case TierState::Counting:
+    if (++count < threshold) {
+      return false;
+    }
+    Report(function);
+    if (function->tier != TierState::Queued) {
+      return false;
+    }
+    [[fallthrough]];
+  case TierState::Queued:
+    if (!tier->IsReady(static_cast<int>(function - threaded.data()))) {
+      return false;
+    }
+    function->tier = TierState::Native;
+    return true;
+  }
+  return false;
+}
+
+/* On-stack replacement: the running call continues in native code from
+ * the loop header it is about to jump back to. */
+bool VirtualMachine::Replace(ThreadedFunction *function,
+                             const ThreadedCell *header, Value *base) {
+  for (const auto &loop : function->loops) {
+    if (loop.first == header) {
+      return tier->Enter(static_cast<int>(function - threaded.data()),
+                         loop.second, base, stackEnd, frames.size());
+    }
+  }
+  return false;
+}
+
+void VirtualMachine::Report(ThreadedFunction *function) {
+  bool compilable =
+      tier->Hot(static_cast<int>(function - threaded.data()),
+                function->invocations, function->backEdges);
+  function->tier = compilable ? TierState::Queued : TierState::Interpreted;
+}
+
+void VirtualMachine::UseSuperinstruction(OpCode opCode, bool enabled) {
+  if (fusing[static_cast<int>(opCode)] != enabled) {
+    fusing[static_cast<int>(opCode)] = enabled;
+    threaded.clear();
+  }
+}
+
+OpCode VirtualMachine::OpCodeOf(const ThreadedCell *cell) const {
+#if CYGNI_THREADED_DISPATCH
+  return handlerOpCodes.at(cell->handler);
+#else
+  return cell->opCode;
+#endif
+}
+
+#define COUNT()                                                                \
+  if constexpr (Counting) {                                                    \
+    instructionCount++;                                                        \
+    if (profile) {                                                             \
+      profile->Record(OpCodeOf(pc));                                           \
+    }                                                                          \
+  }
+
+#if CYGNI_THREADED_DISPATCH
+#define DISPATCH() NEXT();
+#define CASE(name) Label##name:
+#define NEXT()                                                                 \
+  do {                                                                         \
+    COUNT()                                                                    \
+    goto *(pc++)->handler;                                                     \
+  } while (0)
+#define END_DISPATCH()
+#else
+#define DISPATCH()                                                             \
+  for (;;) {                                                                   \
+    COUNT()                                                                    \
+    switch ((pc++)->opCode) {
+#define CASE(name) case OpCode::name:
+#define NEXT() continue
+#define END_DISPATCH()                                                         \
+  default:                                                                     \
+    throw Utility::Exception(__FILE__, __LINE__, "invalid instruction.",       \
+                             nullptr);                                         \
+    }                                                                          \
+    }
+#endif
+
+/* Rewrites the instruction at 'cell' in place. */
+#if CYGNI_THREADED_DISPATCH
+#define REWRITE(cell, name) (cell)->handler = labels[static_cast<int>(name)]
+#else
+#define REWRITE(cell, name) (cell)->opCode = (name)
+#endif
+
+/* In a generic operator whose operands are sp[-1] and sp[0]. */
+#define QUICKEN(name)                                                          \
+  do {                                                                         \
+    if (sp[-1].type == sp[0].type) {                                           \
+      OpCode quickened = QuickenedOpCode(OpCode::name, sp[0].type);            \
+      if (quickened != OpCode::name) {                                         \
+        quickenings++;                                                         \
+        REWRITE(pc - 1, quickened);                                            \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
+
+/* In a quickened operator, before its operands are popped: on a mismatch
+ * the generic operator is written back and runs instead. */
+#define GUARD(name, Type)                                                      \
+  if (sp[-2].type != TypeCode::Type || sp[-1].type != TypeCode::Type) {       \
+    deoptimizations++;                                                         \
+    pc--;                                                                      \
+    REWRITE(pc, OpCode::name);                                                 \
+    NEXT();                                                                    \
+  }
+
+/* The specialized and the quickened handler of an operator on one numeric
+ * type. Neither writes the tag of an arithmetic result, which is already
+ * that of the left operand. */
+#define TYPED_ARITHMETIC(name, Type, member, Operation)                        \
+  CASE(name##Type) {                                                           \
+    sp--;                                                                      \
+    sp[-1].member = Operation()(sp[-1].member, sp[0].member);                  \
+    NEXT();                                                                    \
+  }                                                                            \
+  CASE(Quick##name##Type) {                                                    \
+    GUARD(name, Type)                                                          \
+    sp--;                                                                      \
+    sp[-1].member = Operation()(sp[-1].member, sp[0].member);                  \
+    NEXT();                                                                    \
+  }
+#define TYPED_COMPARISON(name, Type, member, Comparison)                       \
+  CASE(name##Type) {                                                           \
+    sp--;                                                                      \
+    bool value = Comparison()(sp[-1].member, sp[0].member);                    \
+    sp[-1].type = TypeCode::Boolean;                                           \
+    sp[-1].boolean = value;                                                    \
+    NEXT();                                                                    \
+  }                                                                            \
+  CASE(Quick##name##Type) {                                                    \
+    GUARD(name, Type)                                                          \
+    sp--;                                                                      \
+    bool value = Comparison()(sp[-1].member, sp[0].member);                    \
+    sp[-1].type = TypeCode::Boolean;                                           \
+    sp[-1].boolean = value;                                                    \
+    NEXT();                                                                    \
+  }
+
+/* The running function's state lives in locals so that the compiler can
+ * keep it in registers; it is only written back into a call frame on
+ * calls. Popped slots are not cleared: a string they still hold is released
+ * when the slot is overwritten. Called without a function, the threaded
+ * loop only publishes its handlers. */
+template <bool Counting>
+Value VirtualMachine::Run(ThreadedFunction *function, Value *base) {
+#if CYGNI_THREADED_DISPATCH
+  static const void *const labels[] = {
+      &&LabelPushConstant,
+      &&LabelPushString,
+      &&LabelPushDefault,
+      &&LabelPushFunction,
+      &&LabelLoadLocal,
+      &&LabelStoreLocal,
+      &&LabelLoadGlobal,
+      &&LabelStoreGlobal,
+      &&LabelPop,
+      &&LabelAdd,
+      &&LabelSubtract,
+      &&LabelMultiply,
+      &&LabelDivide,
+      &&LabelEqual,
+      &&LabelNotEqual,
+      &&LabelLessThan,
+      &&LabelLessThanOrEqual,
+      &&LabelGreaterThan,
+      &&LabelGreaterThanOrEqual,
+      &&LabelNot,
+      &&LabelJump,
+      &&LabelJumpIfFalse,
+      &&LabelCall,
+      &&LabelCallIndirect,
+      &&LabelTailCall,
+      &&LabelReturn,
+      &&LabelAddInt32,
+      &&LabelSubtractInt32,
+      &&LabelMultiplyInt32,
+      &&LabelDivideInt32,
+      &&LabelEqualInt32,
+      &&LabelNotEqualInt32,
+      &&LabelLessThanInt32,
+      &&LabelLessThanOrEqualInt32,
+      &&LabelGreaterThanInt32,
+      &&LabelGreaterThanOrEqualInt32,
+      &&LabelAddInt64,
+      &&LabelSubtractInt64,
+      &&LabelMultiplyInt64,
+      &&LabelDivideInt64,
+      &&LabelEqualInt64,
+      &&LabelNotEqualInt64,
+      &&LabelLessThanInt64,
+      &&LabelLessThanOrEqualInt64,
+      &&LabelGreaterThanInt64,
+      &&LabelGreaterThanOrEqualInt64,
+      &&LabelAddFloat32,
+      &&LabelSubtractFloat32,
+      &&LabelMultiplyFloat32,
+      &&LabelDivideFloat32,
+      &&LabelEqualFloat32,
+      &&LabelNotEqualFloat32,
+      &&LabelLessThanFloat32,
+      &&LabelLessThanOrEqualFloat32,
+      &&LabelGreaterThanFloat32,
+      &&LabelGreaterThanOrEqualFloat32,
+      &&LabelAddFloat64,
+      &&LabelSubtractFloat64,
+      &&LabelMultiplyFloat64,
+      &&LabelDivideFloat64,
+      &&LabelEqualFloat64,
+      &&LabelNotEqualFloat64,
+      &&LabelLessThanFloat64,
+      &&LabelLessThanOrEqualFloat64,
+      &&LabelGreaterThanFloat64,
+      &&LabelGreaterThanOrEqualFloat64,
+      &&LabelQuickAddInt32,
+      &&LabelQuickSubtractInt32,
+      &&LabelQuickMultiplyInt32,
+      &&LabelQuickDivideInt32,
+      &&LabelQuickEqualInt32,
+      &&LabelQuickNotEqualInt32,
+      &&LabelQuickLessThanInt32,
+      &&LabelQuickLessThanOrEqualInt32,
+      &&LabelQuickGreaterThanInt32,
+      &&LabelQuickGreaterThanOrEqualInt32,
+      &&LabelQuickAddInt64,
+      &&LabelQuickSubtractInt64,
+      &&LabelQuickMultiplyInt64,
+      &&LabelQuickDivideInt64,
+      &&LabelQuickEqualInt64,
+      &&LabelQuickNotEqualInt64,
+      &&LabelQuickLessThanInt64,
+      &&LabelQuickLessThanOrEqualInt64,
+      &&LabelQuickGreaterThanInt64,
+      &&LabelQuickGreaterThanOrEqualInt64,
+      &&LabelQuickAddFloat32,
+      &&LabelQuickSubtractFloat32,
+      &&LabelQuickMultiplyFloat32,
+      &&LabelQuickDivideFloat32,
+      &&LabelQuickEqualFloat32,
+      &&LabelQuickNotEqualFloat32,
+      &&LabelQuickLessThanFloat32,
+      &&LabelQuickLessThanOrEqualFloat32,
+      &&LabelQuickGreaterThanFloat32,
+      &&LabelQuickGreaterThanOrEqualFloat32,
+      &&LabelQuickAddFloat64,
+      &&LabelQuickSubtractFloat64,
+      &&LabelQuickMultiplyFloat64,
+      &&LabelQuickDivideFloat64,
+      &&LabelQuickEqualFloat64,
+      &&LabelQuickNotEqualFloat64,
+      &&LabelQuickLessThanFloat64,
+      &&LabelQuickLessThanOrEqualFloat64,
+      &&LabelQuickGreaterThanFloat64,
+      &&LabelQuickGreaterThanOrEqualFloat64,
+      &&LabelIncrementLocalInt32,
+      &&LabelJumpIfNotLessLocalInt32,
+      &&LabelJumpIfNotLessConstantInt32,
+      &&LabelLoadLocalLoadLocal,
+      &&LabelLoadLocalPushConstant,
+      &&LabelStoreLocalJump};
+  static_assert(sizeof(labels) / sizeof(labels[0]) ==
+                    static_cast<size_t>(OpCode::OpCodeCount),
+                "every opcode needs a handler");
+  if (!function) {
+    handlers = labels;
+    return Value();
+  }
+#endif
+  ThreadedCell *pc = function->code.data();
+  const Value *constants = function->function->constants.data();
+  Value *sp = base + function->function->frameSize;
+  ThreadedFunction *callee;
+  DISPATCH()
+  CASE(PushConstant) {
+    *sp++ = constants[(pc++)->operand];
+    NEXT();
+  }
+  CASE(PushString) {
+    *sp++ = module->strings[(pc++)->operand];
+    NEXT();
+  }
+  CASE(PushDefault) {
+    *sp++ = Value::Default(static_cast<TypeCode>((pc++)->operand));
+    NEXT();
+  }
+  CASE(PushFunction) {
+    *sp++ = Value::Function(static_cast<int32_t>((pc++)->operand));
+    NEXT();
+  }
+  CASE(LoadLocal) {
+    *sp++ = base[(pc++)->operand];
+    NEXT();
+  }
+  CASE(StoreLocal) {
+    base[(pc++)->operand] = std::move(*--sp);
+    NEXT();
+  }
+  CASE(LoadGlobal) {
+    *sp++ = globals[(pc++)->operand];
+    NEXT();
+  }
+  CASE(StoreGlobal) {
+    globals[(pc++)->operand] = std::move(*--sp);
+    NEXT();
+  }
+  CASE(Pop) {
+    sp--;
+    NEXT();
+  }
+  CASE(Add) {
+    sp--;
+    QUICKEN(Add);
+    Arithmetic(sp[-1], sp[-1], sp[0], AddOperation());
+    NEXT();
+  }
+  CASE(Subtract) {
+    sp--;
+    QUICKEN(Subtract);
+    Arithmetic(sp[-1], sp[-1], sp[0], SubtractOperation());
+    NEXT();
+  }
+  CASE(Multiply) {
+    sp--;
+    QUICKEN(Multiply);
+    Arithmetic(sp[-1], sp[-1], sp[0], MultiplyOperation());
+    NEXT();
+  }
+  CASE(Divide) {
+    sp--;
+    QUICKEN(Divide);
+    Arithmetic(sp[-1], sp[-1], sp[0], DivideOperation());
+    NEXT();
+  }
+  CASE(Equal) {
+    sp--;
+    QUICKEN(Equal);
+    Compare(sp[-1], sp[-1], sp[0], std::equal_to<>());
+    NEXT();
+  }
+  CASE(NotEqual) {
+    sp--;
+    QUICKEN(NotEqual);
+    Compare(sp[-1], sp[-1], sp[0], std::not_equal_to<>());
+    NEXT();
+  }
+  CASE(LessThan) {
+    sp--;
+    QUICKEN(LessThan);
+    Compare(sp[-1], sp[-1], sp[0], std::less<>());
+    NEXT();
+  }
+  CASE(LessThanOrEqual) {
+    sp--;
+    QUICKEN(LessThanOrEqual);
+    Compare(sp[-1], sp[-1], sp[0], std::less_equal<>());
+    NEXT();
+  }
+  CASE(GreaterThan) {
+    sp--;
+    QUICKEN(GreaterThan);
+    Compare(sp[-1], sp[-1], sp[0], std::greater<>());
+    NEXT();
+  }
+  CASE(GreaterThanOrEqual) {
+    sp--;
+    QUICKEN(GreaterThanOrEqual);
+    Compare(sp[-1], sp[-1], sp[0], std::greater_equal<>());
+    NEXT();
+  }
+  TYPED_ARITHMETIC(Add, Int32, int32, AddOperation)
+  TYPED_ARITHMETIC(Subtract, Int32, int32, SubtractOperation)
+  TYPED_ARITHMETIC(Multiply, Int32, int32, MultiplyOperation)
+  TYPED_ARITHMETIC(Divide, Int32, int32, DivideOperation)
+  TYPED_COMPARISON(Equal, Int32, int32, std::equal_to<>)
+  TYPED_COMPARISON(NotEqual, Int32, int32, std::not_equal_to<>)
+  TYPED_COMPARISON(LessThan, Int32, int32, std::less<>)
+  TYPED_COMPARISON(LessThanOrEqual, Int32, int32, std::less_equal<>)
+  TYPED_COMPARISON(GreaterThan, Int32, int32, std::greater<>)
+  TYPED_COMPARISON(GreaterThanOrEqual, Int32, int32, std::greater_equal<>)
+  TYPED_ARITHMETIC(Add, Int64, int64, AddOperation)
+  TYPED_ARITHMETIC(Subtract, Int64, int64, SubtractOperation)
+  TYPED_ARITHMETIC(Multiply, Int64, int64, MultiplyOperation)
+  TYPED_ARITHMETIC(Divide, Int64, int64, DivideOperation)
+  TYPED_COMPARISON(Equal, Int64, int64, std::equal_to<>)
+  TYPED_COMPARISON(NotEqual, Int64, int64, std::not_equal_to<>)
+  TYPED_COMPARISON(LessThan, Int64, int64, std::less<>)
+  TYPED_COMPARISON(LessThanOrEqual, Int64, int64, std::less_equal<>)
+  TYPED_COMPARISON(GreaterThan, Int64, int64, std::greater<>)
+  TYPED_COMPARISON(GreaterThanOrEqual, Int64, int64, std::greater_equal<>)
+  TYPED_ARITHMETIC(Add, Float32, float32, AddOperation)
+  TYPED_ARITHMETIC(Subtract, Float32, float32, SubtractOperation)
+  TYPED_ARITHMETIC(Multiply, Float32, float32, MultiplyOperation)
+  TYPED_ARITHMETIC(Divide, Float32, float32, DivideOperation)
+  TYPED_COMPARISON(Equal, Float32, float32, std::equal_to<>)
+  TYPED_COMPARISON(NotEqual, Float32, float32, std::not_equal_to<>)
+  TYPED_COMPARISON(LessThan, Float32, float32, std::less<>)
+  TYPED_COMPARISON(LessThanOrEqual, Float32, float32, std::less_equal<>)
+  TYPED_COMPARISON(GreaterThan, Float32, float32, std::greater<>)
+  TYPED_COMPARISON(GreaterThanOrEqual, Float32, float32, std::greater_equal<>)
+  TYPED_ARITHMETIC(Add, Float64, float64, AddOperation)
+  TYPED_ARITHMETIC(Subtract, Float64, float64, SubtractOperation)
+  TYPED_ARITHMETIC(Multiply, Float64, float64, MultiplyOperation)
+  TYPED_ARITHMETIC(Divide, Float64, float64, DivideOperation)
+  TYPED_COMPARISON(Equal, Float64, float64, std::equal_to<>)
+  TYPED_COMPARISON(NotEqual, Float64, float64, std::not_equal_to<>)
+  TYPED_COMPARISON(LessThan, Float64, float64, std::less<>)
+  TYPED_COMPARISON(LessThanOrEqual, Float64, float64, std::less_equal<>)
+  TYPED_COMPARISON(GreaterThan, Float64, float64, std::greater<>)
+  TYPED_COMPARISON(GreaterThanOrEqual, Float64, float64, std::greater_equal<>)
+  CASE(Not) {
+    sp[-1].boolean = !sp[-1].boolean;
+    NEXT();
+  }
+  CASE(Jump) {
+    if (tier && pc->target < pc &&
+        Promote(function, function->backEdges, backEdgeThreshold) &&
+        Replace(function, pc->target, base)) {
+      sp = base + 1;
+      goto Leave;
+    }
+    pc = pc->target;
+    NEXT();
+  }
+  CASE(JumpIfFalse) {
+    ThreadedCell *target = (pc++)->target;
+    if (!(--sp)->boolean) {
+      pc = target;
+    }
+    NEXT();
+  }
+  CASE(Call) {
+    callee = (pc++)->function;
+  Invoke:
+    const BytecodeFunction *code = callee->function;
+    Value *calleeBase = sp - code->parameterCount;
+    if (frames.size() == maxCallDepth ||
+        stackEnd - calleeBase < code->frameSize + code->maxStack) {
+      throw Utility::Exception(__FILE__, __LINE__, "stack overflow.",
+                               nullptr);
+    }
+    if (tier && Promote(callee, callee->invocations, invocationThreshold)) {
+      tier->Run(static_cast<int>(callee - threaded.data()), calleeBase,
+                stackEnd, frames.size() + 1);
+      sp = calleeBase + 1;
+      NEXT();
+    }
+    frames.push_back(CallFrame{function, pc, base});
+    function = callee;
+    constants = code->constants.data();
+    pc = callee->code.data();
+    base = calleeBase;
+    sp = base + code->frameSize;
+    NEXT();
+  }
+  /* The function value below the arguments is dropped before the call, so
+   * that the frame starts at the arguments as for a direct call. */
+  CASE(CallIndirect) {
+    uint32_t argumentCount = pc[0].operand;
+    InlineCache *cache = pc[1].cache;
+    pc += 2;
+    Value *arguments = sp - argumentCount;
+    int32_t number = arguments[-1].function;
+    callee = nullptr;
+    for (int i = 0; i < cache->size; i++) {
+      if (cache->entries[i].number == number) {
+        callee = cache->entries[i].function;
+        break;
+      }
+    }
+    if (callee) {
+      cacheHits++;
+    } else {
+      callee = Resolve(cache, number, argumentCount);
+    }
+    for (Value *slot = arguments; slot != sp; slot++) {
+      slot[-1] = std::move(*slot);
+    }
+    sp--;
+    goto Invoke;
+  }
+  /* The arguments replace the caller's frame, which the callee then
+   * returns from; they lie above it, so moving them up front is safe. */
+  CASE(TailCall) {
+    callee = pc->function;
+    const BytecodeFunction *code = callee->function;
+    if (stackEnd - base < code->frameSize + code->maxStack) {
+      throw Utility::Exception(__FILE__, __LINE__, "stack overflow.",
+                               nullptr);
+    }
+    Value *arguments = sp - code->parameterCount;
+    for (int i = 0; i < code->parameterCount; i++) {
+      base[i] = std::move(arguments[i]);
+    }
+    if (tier && Promote(callee, callee->invocations, invocationThreshold)) {
+      tier->Run(static_cast<int>(callee - threaded.data()), base, stackEnd,
+                frames.size());
+      sp = base + 1;
+      goto Leave;
+    }
+    function = callee;
+    constants = code->constants.data();
+    pc = callee->code.data();
+    sp = base + code->frameSize;
+    NEXT();
+  }
+  CASE(Return) {
+  Leave:
+    if (frames.empty()) {
+      return std::move(sp[-1]);
+    }
+    *base = std::move(sp[-1]);
+    sp = base + 1;
+    const CallFrame &frame = frames.back();
+    function = frame.function;
+    constants = function->function->constants.data();
+    pc = frame.returnAddress;
+    base = frame.base;
+    frames.pop_back();
+    NEXT();
+  }
+  CASE(IncrementLocalInt32) {
+    Value &local = base[pc[2].operand];
+    local.int32 =
+        Add(base[pc[0].operand].int32, constants[pc[1].operand].int32);
+    local.type = TypeCode::Int32;
+    pc += 3;
+    NEXT();
+  }
+  CASE(JumpIfNotLessLocalInt32) {
+    if (base[pc[0].operand].int32 < base[pc[1].operand].int32) {
+      pc += 3;
+    } else {
+      pc = pc[2].target;
+    }
+    NEXT();
+  }
+  CASE(JumpIfNotLessConstantInt32) {
+    if (base[pc[0].operand].int32 < constants[pc[1].operand].int32) {
+      pc += 3;
+    } else {
+      pc = pc[2].target;
+    }
+    NEXT();
+  }
+  CASE(LoadLocalLoadLocal) {
+    sp[0] = base[pc[0].operand];
+    sp[1] = base[pc[1].operand];
+    sp += 2;
+    pc += 2;
+    NEXT();
+  }
+  CASE(LoadLocalPushConstant) {
+    sp[0] = base[pc[0].operand];
+    sp[1] = constants[pc[1].operand];
+    sp += 2;
+    pc += 2;
+    NEXT();
+  }
+  CASE(StoreLocalJump) {
+    base[pc[0].operand] = std::move(*--sp);
+    if (tier && pc[1].target < pc &&
+        Promote(function, function->backEdges, backEdgeThreshold) &&
+        Replace(function, pc[1].target, base)) {
+      sp = base + 1;
+      goto Leave;
+    }
+    pc = pc[1].target;
+    NEXT();
+  }
+  END_DISPATCH()
+}
+
+#undef COUNT
+#undef DISPATCH
+#undef CASE
+#undef NEXT
+#undef END_DISPATCH
+#undef REWRITE
+#undef QUICKEN
+#undef GUARD
+#undef TYPED_ARITHMETIC
+#undef TYPED_COMPARISON
+
+}; /* namespace Interpreter */
+}; /* namespace Cygni */
@@ -255,13 +255,13 @@ ExpPtr Parser::ParseFactor() {
   } else if (Look().tag == TokenTag::True) {
     const Token &start = Look();
     Advance();
-    return expressionFactory.Create<ConstantExpression>(Pos(start), U"true",
-                                                        TypeCode::Boolean);
+    return expressionFactory.Create<ConstantExpression>(
+        Pos(start), std::u32string(U"true"), TypeCode::Boolean);
   } else if (Look().tag == TokenTag::False) {
     const Token &start = Look();
     Advance();
-    return expressionFactory.Create<ConstantExpression>(Pos(start), U"false",
-                                                        TypeCode::Boolean);
+    return expressionFactory.Create<ConstantExpression>(
+        Pos(start), std::u32string(U"false"), TypeCode::Boolean);
   } else if (Look().tag == TokenTag::Identifier) {
     std::u32string name = Look().text;
     const Token &start = Look();
@@ -310,7 +310,7 @@ ExpPtr Parser::IfStatement() {
     }
   } else {
     auto empty = expressionFactory.Create<DefaultExpression>(
-        Pos(Look()), TypeFactory::CreateBasicType(TypeCode::Unknown));
+        Pos(Look()), TypeFactory::CreateBasicType(TypeCode::Empty));
     return expressionFactory.Create<ConditionalExpression>(
         Pos(start), condition, ifTrue, empty);
   }
@@ -321,7 +321,7 @@ ExpPtr Parser::WhileStatement() {
   Match(TokenTag::While);
   Match(TokenTag::LeftParenthesis);
   auto empty = expressionFactory.Create<DefaultExpression>(
-      Pos(start), TypeFactory::CreateBasicType(TypeCode::Unknown));
+      Pos(start), TypeFactory::CreateBasicType(TypeCode::Empty));
   auto condition = ParseOr();
   Match(TokenTag::RightParenthesis);
   auto body = ParseBlock();
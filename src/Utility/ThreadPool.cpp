@@ -0,0 +1,61 @@
+#include "Utility/ThreadPool.hpp"
+
+namespace Cygni {
+namespace Utility {
+
+ThreadPool::ThreadPool(int threadCount) : running{0}, stopping{false} {
+  for (int i = 0; i < threadCount; i++) {
+    workers.emplace_back(&ThreadPool::Work, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  taskReady.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push(std::move(task));
+  }
+  taskReady.notify_one();
+}
+
+void ThreadPool::Wait() {
+  std::unique_lock<std::mutex> lock(mutex);
+  allDone.wait(lock, [this] { return tasks.empty() && running == 0; });
+}
+
+void ThreadPool::Work() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      taskReady.wait(lock, [this] { return stopping || !tasks.empty(); });
+      if (tasks.empty()) {
+        return;
+      }
+      task = std::move(tasks.front());
+      tasks.pop();
+      running++;
+    }
+    task();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      running--;
+      if (tasks.empty() && running == 0) {
+        allDone.notify_all();
+      }
+    }
+  }
+}
+
+}; /* namespace Utility */
+}; /* namespace Cygni */
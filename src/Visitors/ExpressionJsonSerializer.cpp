@@ -7,12 +7,17 @@ namespace Cygni {
 namespace Visitors {
 
 Json ExpressionJsonSerializer::VisitBinary(const BinaryExpression *node) {
-  Json json;
-  json["NodeType"] = magic_enum::enum_name<ExpressionType>(node->NodeType());
-  json["Left"] = Visit(node->Left());
-  json["Right"] = Visit(node->Right());
-  json["SourceRange"] = SourceRangeToJson(node->GetSourceRange());
-  return json;
+  auto spine = LeftSpine(node);
+  Json left = Visit(spine.back()->Left());
+  for (auto it = spine.rbegin(); it != spine.rend(); it++) {
+    Json json;
+    json["NodeType"] = magic_enum::enum_name<ExpressionType>((*it)->NodeType());
+    json["Left"] = std::move(left);
+    json["Right"] = Visit((*it)->Right());
+    json["SourceRange"] = SourceRangeToJson((*it)->GetSourceRange());
+    left = std::move(json);
+  }
+  return left;
 }
 
 Json ExpressionJsonSerializer::VisitConstant(const ConstantExpression *node) {
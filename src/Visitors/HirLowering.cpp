@@ -0,0 +1,129 @@
+#include "Visitors/HirLowering.hpp"
+
+namespace Cygni {
+namespace Visitors {
+
+using namespace HighLevelIR;
+
+HirLowering::HirLowering(
+    HirFactory &factory, TypeChecker &typeChecker,
+    const std::unordered_map<const Expression *, NameInfo> &nameInfoTable,
+    const BindingTable &bindings)
+    : factory{factory}, typeChecker{typeChecker},
+      nameInfoTable{nameInfoTable}, bindings{bindings} {}
+
+const HirNode *HirLowering::VisitBinary(const BinaryExpression *node) {
+  auto spine = LeftSpine(node);
+  const HirNode *left = Visit(spine.back()->Left());
+  for (auto it = spine.rbegin(); it != spine.rend(); it++) {
+    const HirNode *right = Visit((*it)->Right());
+    if ((*it)->NodeType() == ExpressionType::Assign) {
+      right = Convert(right, left->GetType());
+    }
+    left = factory.Create<HirBinary>((*it)->NodeType(),
+                                     typeChecker.GetType(*it), *it, left, right);
+  }
+  return left;
+}
+
+const HirNode *HirLowering::VisitConstant(const ConstantExpression *node) {
+  return factory.Create<HirConstant>(
+      typeChecker.GetType(node), node,
+      std::any_cast<std::u32string>(node->Value()));
+}
+
+const HirNode *HirLowering::VisitParameter(const ParameterExpression *node) {
+  const Binding &binding = bindings.at(node);
+  auto declaration = declarations.find(binding.declaration);
+  return factory.Create<HirVariable>(
+      typeChecker.GetType(node), node, node->Name(),
+      declaration != declarations.end() ? declaration->second : nullptr,
+      binding.depth, nameInfoTable.at(node));
+}
+
+const HirNode *HirLowering::VisitBlock(const BlockExpression *node) {
+  std::vector<const HirNode *> expressions;
+  expressions.reserve(node->Expressions().size());
+  for (const auto &expression : node->Expressions()) {
+    expressions.push_back(Visit(expression));
+  }
+  return factory.Create<HirBlock>(typeChecker.GetType(node), node,
+                                  expressions);
+}
+
+const HirNode *
+HirLowering::VisitConditional(const ConditionalExpression *node) {
+  const Type *type = typeChecker.GetType(node);
+  const HirNode *test = Visit(node->Test());
+  const HirNode *ifTrue = Convert(Visit(node->IfTrue()), type);
+  const HirNode *ifFalse = Convert(Visit(node->IfFalse()), type);
+  return factory.Create<HirConditional>(type, node, test, ifTrue, ifFalse);
+}
+
+const HirNode *HirLowering::VisitUnary(const UnaryExpression *node) {
+  return factory.Create<HirUnary>(node->NodeType(), typeChecker.GetType(node),
+                                  node, Visit(node->Operand()));
+}
+
+const HirNode *HirLowering::VisitCall(const CallExpression *node) {
+  const HirNode *function = Visit(node->Function());
+  auto callableType = static_cast<const CallableType *>(function->GetType());
+  std::vector<const HirNode *> arguments;
+  arguments.reserve(node->Arguments().size());
+  for (size_t i = 0; i < node->Arguments().size(); i++) {
+    arguments.push_back(Convert(Visit(node->Arguments().at(i)),
+                                callableType->Arguments().at(i)));
+  }
+  return factory.Create<HirCall>(typeChecker.GetType(node), node, function,
+                                 arguments);
+}
+
+const HirNode *HirLowering::VisitLambda(const LambdaExpression *node) {
+  std::vector<const HirVariable *> parameters;
+  parameters.reserve(node->Parameters().size());
+  for (const auto &parameter : node->Parameters()) {
+    auto variable = factory.Create<HirVariable>(
+        typeChecker.GetVariableType(parameter), parameter, parameter->Name(),
+        bindings.at(parameter).depth, nameInfoTable.at(parameter));
+    declarations.insert({parameter, variable});
+    parameters.push_back(variable);
+  }
+  const HirNode *body = Convert(Visit(node->Body()), node->ReturnType());
+  return factory.Create<HirLambda>(typeChecker.GetType(node), node,
+                                   node->Name(), parameters, body);
+}
+
+const HirNode *HirLowering::VisitLoop(const LoopExpression *node) {
+  const HirNode *initializer = Visit(node->Initializer());
+  const HirNode *condition = Visit(node->Condition());
+  const HirNode *body = Visit(node->Body());
+  return factory.Create<HirLoop>(typeChecker.GetType(node), node, initializer,
+                                 condition, body);
+}
+
+const HirNode *HirLowering::VisitDefault(const DefaultExpression *node) {
+  return factory.Create<HirDefault>(typeChecker.GetType(node), node);
+}
+
+const HirNode *HirLowering::VisitVariableDeclaration(
+    const VariableDeclarationExpression *node) {
+  const HirNode *initializer = Visit(node->Initializer());
+  auto declaration = factory.Create<HirVariableDeclaration>(
+      typeChecker.GetType(node), node, node->Name(),
+      typeChecker.GetVariableType(node), initializer,
+      bindings.at(node).depth, nameInfoTable.at(node));
+  declarations.insert({node, declaration});
+  return declaration;
+}
+
+const HirNode *HirLowering::Convert(const HirNode *node, const Type *type) {
+  if (relations.AreTypesEqual(node->GetType(), type)) {
+    return node;
+  } else {
+    return factory.Create<HirUnary>(ExpressionType::Convert, type,
+                                    node->Source(), node);
+  }
+}
+
+}; /* namespace Visitors */
+}; /* namespace Cygni */
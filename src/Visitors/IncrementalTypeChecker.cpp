@@ -0,0 +1,142 @@
+#include "Visitors/IncrementalTypeChecker.hpp"
+
+namespace Cygni {
+namespace Visitors {
+
+IncrementalTypeChecker::IncrementalTypeChecker()
+    : symbolsRemoved{false},
+      globalDeclarations{std::make_unique<Scope<const Expression *>>()},
+      globalTypes{std::make_unique<Scope<const Type *>>()} {}
+
+void IncrementalTypeChecker::SetFunction(const LambdaExpression *function) {
+  std::vector<const Type *> argumentTypes;
+  argumentTypes.reserve(function->Parameters().size());
+  for (const auto &parameter : function->Parameters()) {
+    argumentTypes.push_back(parameter->GetType());
+  }
+  SetSymbol(function->Name(), function,
+            types.CreateCallableType(argumentTypes, function->ReturnType()));
+  results[function->Name()].function = function;
+  dirty.insert(function->Name());
+}
+
+void IncrementalTypeChecker::SetGlobalVariable(
+    const ParameterExpression *variable) {
+  RemoveResult(variable->Name());
+  SetSymbol(variable->Name(), variable, variable->GetType());
+}
+
+void IncrementalTypeChecker::Remove(const std::u32string &name) {
+  if (symbols.erase(name)) {
+    RemoveResult(name);
+    symbolsRemoved = true;
+    MarkDependents(name);
+  }
+}
+
+int IncrementalTypeChecker::Check() {
+  if (symbolsRemoved) {
+    RebuildGlobalScopes();
+    symbolsRemoved = false;
+  }
+  int count = 0;
+  for (const auto &name : dirty) {
+    CheckFunction(name, results.at(name));
+    count++;
+  }
+  dirty.clear();
+  return count;
+}
+
+/* Types from one factory are interned, so a signature is unchanged exactly
+ * when its pointer is. Global scopes only hold depth 0 declarations, which
+ * 'Declare' overwrites in place. */
+void IncrementalTypeChecker::SetSymbol(const std::u32string &name,
+                                       const Expression *declaration,
+                                       const Type *signature) {
+  auto it = symbols.find(name);
+  if (it == symbols.end() || it->second.signature != signature) {
+    MarkDependents(name);
+  }
+  symbols[name] = Symbol{declaration, signature};
+  globalDeclarations->Declare(name, declaration);
+  globalTypes->Declare(name, signature);
+}
+
+void IncrementalTypeChecker::MarkDependents(const std::u32string &name) {
+  auto it = dependents.find(name);
+  if (it != dependents.end()) {
+    for (const auto &dependent : it->second) {
+      dirty.insert(dependent);
+    }
+  }
+}
+
+void IncrementalTypeChecker::RebuildGlobalScopes() {
+  globalDeclarations = std::make_unique<Scope<const Expression *>>();
+  globalTypes = std::make_unique<Scope<const Type *>>();
+  for (const auto &item : symbols) {
+    globalDeclarations->Declare(item.first, item.second.declaration);
+    globalTypes->Declare(item.first, item.second.signature);
+  }
+}
+
+void IncrementalTypeChecker::RemoveResult(const std::u32string &name) {
+  auto it = results.find(name);
+  if (it != results.end()) {
+    for (const auto &dependency : it->second.dependencies) {
+      dependents[dependency].erase(name);
+    }
+    results.erase(it);
+  }
+  dirty.erase(name);
+}
+
+void IncrementalTypeChecker::CheckFunction(const std::u32string &name,
+                                           FunctionCheckResult &result) {
+  for (const auto &dependency : result.dependencies) {
+    dependents[dependency].erase(name);
+  }
+  result.dependencies.clear();
+  result.nodeTypes.clear();
+  result.diagnostic.clear();
+
+  std::unordered_set<std::u32string> names;
+  try {
+    Scope<const Expression *> declarationScope(globalDeclarations.get());
+    NameResolver resolver;
+    try {
+      resolver.Visit(result.function, &declarationScope);
+    } catch (const TreeException &exception) {
+      /* An undefined name is a dependency too: defining it must re-check
+       * this body. */
+      if (exception.Tree() &&
+          exception.Tree()->NodeType() == ExpressionType::Parameter) {
+        names.insert(
+            static_cast<const ParameterExpression *>(exception.Tree())->Name());
+      }
+      throw;
+    }
+    for (const auto &item : resolver.Bindings()) {
+      if (item.second.slot == -1) {
+        names.insert(
+            static_cast<const ParameterExpression *>(item.first)->Name());
+      }
+    }
+
+    Scope<const Type *> typeScope(globalTypes.get());
+    TypeChecker typeChecker(&resolver.Bindings(), &types);
+    typeChecker.Visit(result.function, &typeScope);
+    result.nodeTypes = typeChecker.NodeTypes();
+  } catch (const std::exception &exception) {
+    result.diagnostic = exception.what();
+  }
+
+  for (const auto &dependency : names) {
+    dependents[dependency].insert(name);
+    result.dependencies.push_back(dependency);
+  }
+}
+
+}; /* namespace Visitors */
+}; /* namespace Cygni */
@@ -1,12 +1,19 @@
 #include "Visitors/NameLocator.hpp"
 
+#include <cstring>
+#include "Expressions/Literal.hpp"
+#include "Utility/UTF32Functions.hpp"
+
 namespace Cygni {
 namespace Visitors {
 
 void NameLocator::VisitBinary(const BinaryExpression *node,
                               Scope<NameInfo> *scope) {
-  Visit(node->Left(), scope);
-  Visit(node->Right(), scope);
+  auto spine = LeftSpine(node);
+  Visit(spine.back()->Left(), scope);
+  for (auto it = spine.rbegin(); it != spine.rend(); it++) {
+    Visit((*it)->Right(), scope);
+  }
 }
 void NameLocator::VisitUnary(const UnaryExpression *node,
                              Scope<NameInfo> *scope) {
@@ -14,23 +21,20 @@ void NameLocator::VisitUnary(const UnaryExpression *node,
 }
 void NameLocator::VisitConstant(const ConstantExpression *node,
                                 Scope<NameInfo> *scope) {
-  /* TODO: support duplicated constants. */
-  NameInfo nameInfo(LocationKind::FunctionConstant,
-                    scope->Get(U"$LOCATION_CONSTANT_COUNT").number);
-  nameInfoTable.insert({static_cast<const Expression *>(node), nameInfo});
-  scope->Get(U"$LOCATION_CONSTANT_COUNT").number++;
+  LocateConstant(node);
 }
 void NameLocator::VisitParameter(const ParameterExpression *node,
                                  Scope<NameInfo> *scope) {
-  NameInfo nameInfo = scope->Get(node->Name());
-  nameInfoTable.insert({static_cast<const Expression *>(node), nameInfo});
+  LocateParameter(node, scope);
 }
 void NameLocator::VisitBlock(const BlockExpression *node,
-                             Scope<NameInfo> *parent) {
-  Scope<NameInfo> scope(parent);
+                             Scope<NameInfo> *scope) {
+  NestedScope<NameInfo> nested(Names(scope));
+  EnterBlock();
   for (const auto &exp : node->Expressions()) {
-    Visit(exp, &scope);
+    Visit(exp, scope);
   }
+  LeaveBlock();
 }
 void NameLocator::VisitConditional(const ConditionalExpression *node,
                                    Scope<NameInfo> *scope) {
@@ -46,36 +50,179 @@ void NameLocator::VisitCall(const CallExpression *node,
   }
 }
 void NameLocator::VisitLambda(const LambdaExpression *node,
-                              Scope<NameInfo> *parent) {
-  Scope<NameInfo> scope(parent);
-  scope.Declare(U"$LOCAL_VARIABLE_COUNT",
-                NameInfo(LocationKind::FunctionVariableCount, 0));
-  scope.Declare(U"$LOCAL_CONSTANT_COUNT",
-                NameInfo(LocationKind::FunctionConstantCount, 0));
-  for (const auto &parameter : node->Parameters()) {
-    scope.Declare(parameter->Name(),
-                  NameInfo(LocationKind::FunctionVariable,
-                           scope.Get(U"$LOCAL_VARIABLE_COUNT").number));
-    scope.Get(U"$LOCAL_VARIABLE_COUNT").number++;
-  }
-  Visit(node->Body(), &scope);
+                              Scope<NameInfo> *scope) {
+  NestedScope<NameInfo> nested(Names(scope));
+  EnterFunction(node, Names(scope));
+  Visit(node->Body(), scope);
+  LeaveFunction(node);
 }
 void NameLocator::VisitLoop(const LoopExpression *node,
-                            Scope<NameInfo> *parent) {
-  Scope<NameInfo> scope(parent);
-  Visit(node->Initializer(), &scope);
-  Visit(node->Condition(), &scope);
-  Visit(node->Body(), &scope);
+                            Scope<NameInfo> *scope) {
+  NestedScope<NameInfo> nested(Names(scope));
+  EnterBlock();
+  Visit(node->Initializer(), scope);
+  Visit(node->Condition(), scope);
+  Visit(node->Body(), scope);
+  LeaveBlock();
 }
 void NameLocator::VisitDefault(const DefaultExpression *node,
                                Scope<NameInfo> *scope) {}
 void NameLocator::VisitVariableDeclaration(
     const VariableDeclarationExpression *node, Scope<NameInfo> *scope) {
-  scope->Declare(node->Name(),
-                 NameInfo(LocationKind::FunctionVariable,
-                          scope->Get(U"$LOCAL_VARIABLE_COUNT").number));
-  scope->Get(U"$LOCAL_VARIABLE_COUNT").number++;
+  DeclareVariable(node, Names(scope));
   Visit(node->Initializer(), scope);
 }
+
+void NameLocator::Enter(const Expression *node) {
+  switch (node->NodeType()) {
+  case ExpressionType::Constant: {
+    LocateConstant(static_cast<const ConstantExpression *>(node));
+    break;
+  }
+  case ExpressionType::Parameter: {
+    LocateParameter(static_cast<const ParameterExpression *>(node), nullptr);
+    break;
+  }
+  case ExpressionType::Lambda: {
+    EnterFunction(static_cast<const LambdaExpression *>(node), nullptr);
+    break;
+  }
+  case ExpressionType::VariableDeclaration: {
+    DeclareVariable(static_cast<const VariableDeclarationExpression *>(node),
+                    nullptr);
+    break;
+  }
+  case ExpressionType::Block:
+  case ExpressionType::Loop: {
+    EnterBlock();
+    break;
+  }
+  default: {
+    break;
+  }
+  }
+}
+void NameLocator::Leave(const Expression *node) {
+  switch (node->NodeType()) {
+  case ExpressionType::Lambda: {
+    LeaveFunction(static_cast<const LambdaExpression *>(node));
+    break;
+  }
+  case ExpressionType::Block:
+  case ExpressionType::Loop: {
+    LeaveBlock();
+    break;
+  }
+  default: {
+    break;
+  }
+  }
+}
+
+void NameLocator::LocateConstant(const ConstantExpression *node) {
+  if (node->GetTypeCode() != TypeCode::String) {
+    nameInfoTable.insert(
+        {static_cast<const Expression *>(node),
+         NameInfo(LocationKind::FunctionConstant,
+                  frames.back().constants.Add(node))});
+  }
+}
+void NameLocator::LocateParameter(const ParameterExpression *node,
+                                  Scope<NameInfo> *scope) {
+  auto declaration =
+      bindings ? nameInfoTable.find(bindings->at(node).declaration)
+               : nameInfoTable.end();
+  if (declaration != nameInfoTable.end()) {
+    NameInfo nameInfo = declaration->second;
+    nameInfoTable.insert({static_cast<const Expression *>(node), nameInfo});
+  } else if (scope) {
+    NameInfo nameInfo = scope->Get(node->Name());
+    nameInfoTable.insert({static_cast<const Expression *>(node), nameInfo});
+  } else {
+    throw TreeException(
+        __FILE__, __LINE__,
+        Utility::UTF32ToUTF8(U"'" + node->Name() + U"' cannot be located."),
+        node, nullptr);
+  }
+}
+void NameLocator::EnterFunction(const LambdaExpression *node,
+                                Scope<NameInfo> *scope) {
+  frames.emplace_back();
+  for (const auto &parameter : node->Parameters()) {
+    NameInfo nameInfo(LocationKind::FunctionVariable,
+                      frames.back().AllocateSlot());
+    if (scope) {
+      scope->Declare(parameter->Name(), nameInfo);
+    }
+    nameInfoTable.insert(
+        {static_cast<const Expression *>(parameter), nameInfo});
+  }
+}
+void NameLocator::LeaveFunction(const LambdaExpression *node) {
+  functionFrames[node] = std::move(frames.back());
+  frames.pop_back();
+}
+void NameLocator::DeclareVariable(const VariableDeclarationExpression *node,
+                                  Scope<NameInfo> *scope) {
+  NameInfo nameInfo(LocationKind::FunctionVariable,
+                    frames.back().AllocateSlot());
+  if (scope) {
+    scope->Declare(node->Name(), nameInfo);
+  }
+  nameInfoTable.insert({static_cast<const Expression *>(node), nameInfo});
+}
+void NameLocator::EnterBlock() {
+  slotMarks.push_back(frames.back().variableCount);
+}
+void NameLocator::LeaveBlock() {
+  frames.back().variableCount = slotMarks.back();
+  slotMarks.pop_back();
+}
+
+ConstantKey::ConstantKey(const ConstantExpression *node)
+    : typeCode{node->GetTypeCode()}, bits{0}, text() {
+  Literal literal(node);
+  switch (typeCode) {
+  case TypeCode::Int32: {
+    bits = static_cast<uint32_t>(literal.int32);
+    break;
+  }
+  case TypeCode::Int64: {
+    bits = static_cast<uint64_t>(literal.int64);
+    break;
+  }
+  case TypeCode::Float32: {
+    uint32_t valueBits;
+    std::memcpy(&valueBits, &literal.float32, sizeof(literal.float32));
+    bits = valueBits;
+    break;
+  }
+  case TypeCode::Float64: {
+    std::memcpy(&bits, &literal.float64, sizeof(literal.float64));
+    break;
+  }
+  case TypeCode::Boolean: {
+    bits = literal.boolean;
+    break;
+  }
+  case TypeCode::Char: {
+    bits = literal.character;
+    break;
+  }
+  default: {
+    text = literal.text;
+    break;
+  }
+  }
+}
+
+int ConstantPool::Add(const ConstantExpression *node) {
+  ConstantKey key(node);
+  auto result = indices.insert({key, Size()});
+  if (result.second) {
+    constants.push_back(node);
+  }
+  return result.first->second;
+}
 }; /* namespace Visitors */
 }; /* namespace Cygni */
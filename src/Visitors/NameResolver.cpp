@@ -0,0 +1,190 @@
+#include "Visitors/NameResolver.hpp"
+
+#include "Utility/UTF32Functions.hpp"
+
+namespace Cygni {
+namespace Visitors {
+
+NameResolver::NameResolver()
+    : slotCounters{0}, collecting{false}, passScope{&ownScope} {}
+
+NameResolver::NameResolver(Scope<const Expression *> *scope)
+    : slotCounters{0}, collecting{false}, passScope{scope} {}
+
+void NameResolver::VisitBinary(const BinaryExpression *node,
+                               Scope<const Expression *> *scope) {
+  auto spine = LeftSpine(node);
+  Visit(spine.back()->Left(), scope);
+  for (auto it = spine.rbegin(); it != spine.rend(); it++) {
+    Visit((*it)->Right(), scope);
+  }
+}
+
+void NameResolver::VisitUnary(const UnaryExpression *node,
+                              Scope<const Expression *> *scope) {
+  Visit(node->Operand(), scope);
+}
+
+void NameResolver::VisitConstant(const ConstantExpression *node,
+                                 Scope<const Expression *> *scope) {}
+
+void NameResolver::VisitParameter(const ParameterExpression *node,
+                                  Scope<const Expression *> *scope) {
+  Bind(node, scope);
+}
+
+void NameResolver::VisitBlock(const BlockExpression *node,
+                              Scope<const Expression *> *scope) {
+  NestedScope<const Expression *> nested(scope);
+  EnterBlock();
+  for (const auto &expression : node->Expressions()) {
+    Visit(expression, scope);
+  }
+  LeaveBlock();
+}
+
+void NameResolver::VisitConditional(const ConditionalExpression *node,
+                                    Scope<const Expression *> *scope) {
+  Visit(node->Test(), scope);
+  Visit(node->IfTrue(), scope);
+  Visit(node->IfFalse(), scope);
+}
+
+void NameResolver::VisitCall(const CallExpression *node,
+                             Scope<const Expression *> *scope) {
+  Visit(node->Function(), scope);
+  for (const auto &argument : node->Arguments()) {
+    Visit(argument, scope);
+  }
+}
+
+void NameResolver::VisitLambda(const LambdaExpression *node,
+                               Scope<const Expression *> *scope) {
+  NestedScope<const Expression *> nested(scope);
+  DeclareParameters(node, scope);
+  Visit(node->Body(), scope);
+  slotCounters.pop_back();
+}
+
+void NameResolver::VisitLoop(const LoopExpression *node,
+                             Scope<const Expression *> *scope) {
+  NestedScope<const Expression *> nested(scope);
+  EnterBlock();
+  Visit(node->Initializer(), scope);
+  Visit(node->Condition(), scope);
+  Visit(node->Body(), scope);
+  LeaveBlock();
+}
+
+void NameResolver::VisitDefault(const DefaultExpression *node,
+                                Scope<const Expression *> *scope) {}
+
+void NameResolver::VisitVariableDeclaration(
+    const VariableDeclarationExpression *node,
+    Scope<const Expression *> *scope) {
+  Allocate(node);
+  Visit(node->Initializer(), scope);
+  scope->Declare(node->Name(), node);
+}
+
+void NameResolver::Enter(const Expression *node) {
+  switch (node->NodeType()) {
+  case ExpressionType::Parameter: {
+    Bind(static_cast<const ParameterExpression *>(node), passScope);
+    break;
+  }
+  case ExpressionType::Block:
+  case ExpressionType::Loop: {
+    passScope->Enter();
+    EnterBlock();
+    break;
+  }
+  case ExpressionType::VariableDeclaration: {
+    Allocate(node);
+    break;
+  }
+  case ExpressionType::Lambda: {
+    passScope->Enter();
+    DeclareParameters(static_cast<const LambdaExpression *>(node), passScope);
+    break;
+  }
+  default: {
+    break;
+  }
+  }
+}
+
+void NameResolver::Leave(const Expression *node) {
+  switch (node->NodeType()) {
+  case ExpressionType::Block:
+  case ExpressionType::Loop: {
+    LeaveBlock();
+    passScope->Exit();
+    break;
+  }
+  case ExpressionType::Lambda: {
+    slotCounters.pop_back();
+    passScope->Exit();
+    break;
+  }
+  case ExpressionType::VariableDeclaration: {
+    auto declaration = static_cast<const VariableDeclarationExpression *>(node);
+    passScope->Declare(declaration->Name(), declaration);
+    break;
+  }
+  default: {
+    break;
+  }
+  }
+}
+
+void NameResolver::Bind(const ParameterExpression *node,
+                        Scope<const Expression *> *scope) {
+  if (scope->Exists(node->Name())) {
+    const Expression *declaration = scope->Get(node->Name());
+    auto it = bindings.find(declaration);
+    if (it != bindings.end()) {
+      bindings.insert({node, it->second});
+    } else {
+      bindings.insert({node, Binding(declaration, 0, -1)});
+    }
+  } else if (collecting) {
+    if (freeNameSet.insert(node->Name()).second) {
+      freeNames.push_back(node->Name());
+    }
+    bindings.insert({node, Binding(nullptr, 0, -1)});
+  } else {
+    throw TreeException(
+        __FILE__, __LINE__,
+        Utility::UTF32ToUTF8(U"'" + node->Name() + U"' not defined."), node,
+        nullptr);
+  }
+}
+
+void NameResolver::DeclareParameters(const LambdaExpression *node,
+                                     Scope<const Expression *> *scope) {
+  slotCounters.push_back(0);
+  for (const auto &parameter : node->Parameters()) {
+    Allocate(parameter);
+    scope->Declare(parameter->Name(), parameter);
+  }
+}
+
+/* A variable gets its slot before its initializer is visited, as in the
+ * NameLocator, but its name is declared only after it. */
+void NameResolver::Allocate(const Expression *node) {
+  int depth = static_cast<int>(slotCounters.size()) - 1;
+  int slot = slotCounters.back();
+  slotCounters.back()++;
+  bindings[node] = Binding(node, depth, slot);
+}
+
+void NameResolver::EnterBlock() { slotMarks.push_back(slotCounters.back()); }
+
+void NameResolver::LeaveBlock() {
+  slotCounters.back() = slotMarks.back();
+  slotMarks.pop_back();
+}
+
+}; /* namespace Visitors */
+}; /* namespace Cygni */
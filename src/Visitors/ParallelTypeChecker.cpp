@@ -0,0 +1,70 @@
+#include "Visitors/ParallelTypeChecker.hpp"
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include "Utility/ThreadPool.hpp"
+
+namespace Cygni {
+namespace Visitors {
+
+ParallelTypeChecker::ParallelTypeChecker(int threadCount)
+    : threadCount{threadCount} {}
+
+void ParallelTypeChecker::Check(
+    const std::vector<const LambdaExpression *> &functions) {
+  DeclareSignatures(functions);
+
+  std::vector<std::unique_ptr<NameResolver>> resolvers;
+  std::vector<std::unique_ptr<TypeChecker>> checkers;
+  for (int i = 0; i < threadCount; i++) {
+    resolvers.push_back(std::make_unique<NameResolver>());
+    checkers.push_back(
+        std::make_unique<TypeChecker>(&resolvers.back()->Bindings(), &types));
+  }
+  std::vector<std::exception_ptr> errors(functions.size());
+  std::atomic<std::size_t> next{0};
+
+  Utility::ThreadPool pool(threadCount);
+  for (int i = 0; i < threadCount; i++) {
+    NameResolver *resolver = resolvers.at(i).get();
+    TypeChecker *checker = checkers.at(i).get();
+    pool.Submit([this, resolver, checker, &functions, &errors, &next]() {
+      Scope<const Expression *> names(&globals);
+      Scope<const Type *> scope;
+      for (std::size_t k = next++; k < functions.size(); k = next++) {
+        try {
+          resolver->Visit(functions.at(k), &names);
+          checker->Visit(functions.at(k), &scope);
+        } catch (...) {
+          errors.at(k) = std::current_exception();
+        }
+      }
+    });
+  }
+  pool.Wait();
+
+  for (const auto &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+  std::size_t total = nodeTypes.size();
+  for (const auto &checker : checkers) {
+    total += checker->NodeTypes().size();
+  }
+  nodeTypes.reserve(total);
+  for (const auto &checker : checkers) {
+    nodeTypes.insert(checker->NodeTypes().begin(), checker->NodeTypes().end());
+  }
+}
+
+void ParallelTypeChecker::DeclareSignatures(
+    const std::vector<const LambdaExpression *> &functions) {
+  for (auto function : functions) {
+    globals.Declare(function->Name(), function);
+  }
+}
+
+}; /* namespace Visitors */
+}; /* namespace Cygni */
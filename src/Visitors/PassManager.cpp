@@ -0,0 +1,90 @@
+#include "Visitors/PassManager.hpp"
+
+namespace Cygni {
+namespace Visitors {
+
+void PassManager::Run(const Expression *node) {
+  stack.clear();
+  Schedule(node);
+  while (!stack.empty()) {
+    Frame &frame = stack.back();
+    if (frame.entered) {
+      const Expression *done = frame.node;
+      stack.pop_back();
+      Leave(done);
+    } else {
+      frame.entered = true;
+      const Expression *current = frame.node;
+      Enter(current);
+      Visit(current);
+    }
+  }
+}
+
+/* Children are scheduled in reverse so that they are walked left to right. */
+
+void PassManager::VisitBinary(const BinaryExpression *node) {
+  Schedule(node->Right());
+  Schedule(node->Left());
+}
+
+void PassManager::VisitUnary(const UnaryExpression *node) {
+  Schedule(node->Operand());
+}
+
+void PassManager::VisitConstant(const ConstantExpression *node) {}
+
+void PassManager::VisitParameter(const ParameterExpression *node) {}
+
+void PassManager::VisitBlock(const BlockExpression *node) {
+  const auto &expressions = node->Expressions();
+  for (auto it = expressions.rbegin(); it != expressions.rend(); it++) {
+    Schedule(*it);
+  }
+}
+
+void PassManager::VisitConditional(const ConditionalExpression *node) {
+  Schedule(node->IfFalse());
+  Schedule(node->IfTrue());
+  Schedule(node->Test());
+}
+
+void PassManager::VisitCall(const CallExpression *node) {
+  const auto &arguments = node->Arguments();
+  for (auto it = arguments.rbegin(); it != arguments.rend(); it++) {
+    Schedule(*it);
+  }
+  Schedule(node->Function());
+}
+
+void PassManager::VisitLambda(const LambdaExpression *node) {
+  Schedule(node->Body());
+}
+
+void PassManager::VisitLoop(const LoopExpression *node) {
+  Schedule(node->Body());
+  Schedule(node->Condition());
+  Schedule(node->Initializer());
+}
+
+void PassManager::VisitDefault(const DefaultExpression *node) {}
+
+void PassManager::VisitVariableDeclaration(
+    const VariableDeclarationExpression *node) {
+  Schedule(node->Initializer());
+}
+
+void PassManager::Enter(const Expression *node) {
+  for (auto pass : passes) {
+    pass->Enter(node);
+  }
+}
+
+void PassManager::Leave(const Expression *node) {
+  for (auto pass : passes) {
+    pass->Leave(node);
+  }
+}
+
+}; /* namespace Visitors */
+}; /* namespace Cygni */
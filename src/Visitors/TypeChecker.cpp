@@ -1,6 +1,7 @@
 #include "Visitors/TypeChecker.hpp"
 
 #include <spdlog/spdlog.h>
+#include "Expressions/Literal.hpp"
 #include "Utility/UTF32Functions.hpp"
 
 #include <iostream>
@@ -10,7 +11,19 @@ using std::endl;
 namespace Cygni {
 namespace Visitors {
 
-TypeChecker::TypeChecker() { spdlog::debug("Type checker initialized."); }
+TypeChecker::TypeChecker() : bindings{nullptr}, types{&ownTypes} {
+  spdlog::debug("Type checker initialized.");
+}
+
+TypeChecker::TypeChecker(const BindingTable *bindings)
+    : bindings{bindings}, types{&ownTypes} {
+  spdlog::debug("Type checker initialized with name bindings.");
+}
+
+TypeChecker::TypeChecker(const BindingTable *bindings, TypeFactory *types)
+    : bindings{bindings}, types{types} {
+  spdlog::debug("Type checker initialized with a shared type factory.");
+}
 
 const Type *TypeChecker::VisitBinary(const BinaryExpression *node,
                                      Scope<const Type *> *scope) {
@@ -19,113 +32,309 @@ const Type *TypeChecker::VisitBinary(const BinaryExpression *node,
     const Type *right = Visit(node->Right(), scope);
     if (node->Left()->NodeType() == ExpressionType::Parameter) {
       const Type *left = Visit(node->Left(), scope);
-
-      if (TypeFactory::AreTypesEqual(left, right)) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Empty));
-      } else {
-        throw TreeException(__FILE__, __LINE__, "type mismatch error.", node,
-                            nullptr);
-      }
+      return CheckBinary(node, left, right);
     } else {
       throw TreeException(__FILE__, __LINE__,
                           "type checking not supported error.", node, nullptr);
     }
   } else {
-    const Type *left = Visit(node->Left(), scope);
-    const Type *right = Visit(node->Right(), scope);
-    switch (node->NodeType()) {
-    case ExpressionType::Add:
-    case ExpressionType::Subtract:
-    case ExpressionType::Multiply:
-    case ExpressionType::Divide: {
-      if (left->GetTypeCode() == TypeCode::Int32 &&
-          right->GetTypeCode() == TypeCode::Int32) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Int32));
-      } else if (left->GetTypeCode() == TypeCode::Int64 &&
-                 right->GetTypeCode() == TypeCode::Int64) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Int64));
-      } else if (left->GetTypeCode() == TypeCode::Float32 &&
-                 right->GetTypeCode() == TypeCode::Float32) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Float32));
-      } else if (left->GetTypeCode() == TypeCode::Float64 &&
-                 right->GetTypeCode() == TypeCode::Float64) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Float64));
-      } else {
-        throw TreeException(__FILE__, __LINE__, "type mismatch error.", node,
-                            nullptr);
-      }
+    auto spine = LeftSpine(node);
+    const Type *left = Visit(spine.back()->Left(), scope);
+    for (auto it = spine.rbegin(); it != spine.rend(); it++) {
+      const Type *right = Visit((*it)->Right(), scope);
+      left = CheckBinary(*it, left, right);
     }
-    case ExpressionType::GreaterThan:
-    case ExpressionType::LessThan:
-    case ExpressionType::GreaterThanOrEqual:
-    case ExpressionType::LessThanOrEqual: {
-      if (left->GetTypeCode() == TypeCode::Int32 &&
-          right->GetTypeCode() == TypeCode::Int32) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
-      } else if (left->GetTypeCode() == TypeCode::Int64 &&
-                 right->GetTypeCode() == TypeCode::Int64) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
-      } else if (left->GetTypeCode() == TypeCode::Float32 &&
-                 right->GetTypeCode() == TypeCode::Float32) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
-      } else if (left->GetTypeCode() == TypeCode::Float64 &&
-                 right->GetTypeCode() == TypeCode::Float64) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
-      } else if (left->GetTypeCode() == TypeCode::Char &&
-                 right->GetTypeCode() == TypeCode::Char) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
-      } else if (left->GetTypeCode() == TypeCode::String &&
-                 right->GetTypeCode() == TypeCode::String) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
-      } else {
-        throw TreeException(__FILE__, __LINE__, "type mismatch error.", node,
-                            nullptr);
-      }
+    return left;
+  }
+}
+
+const Type *TypeChecker::VisitConstant(const ConstantExpression *node,
+                                       Scope<const Type *> *scope) {
+  return CheckConstant(node);
+}
+
+const Type *TypeChecker::VisitParameter(const ParameterExpression *node,
+                                        Scope<const Type *> *scope) {
+  return CheckParameter(node, scope);
+}
+
+const Type *TypeChecker::VisitBlock(const BlockExpression *node,
+                                    Scope<const Type *> *scope) {
+  NestedScope<const Type *> nested(Names(scope));
+  const Type *type = TypeFactory::CreateBasicType(TypeCode::Empty);
+  for (const auto &expression : node->Expressions()) {
+    type = Visit(expression, scope);
+  }
+  return Register(node, type);
+}
+
+const Type *TypeChecker::VisitConditional(const ConditionalExpression *node,
+                                          Scope<const Type *> *scope) {
+  const Type *test = Visit(node->Test(), scope);
+  const Type *ifTrue = Visit(node->IfTrue(), scope);
+  const Type *ifFalse = Visit(node->IfFalse(), scope);
+  return CheckConditional(node, test, ifTrue, ifFalse);
+}
+
+const Type *TypeChecker::VisitUnary(const UnaryExpression *node,
+                                    Scope<const Type *> *scope) {
+  return CheckUnary(node, Visit(node->Operand(), scope));
+}
+
+const Type *TypeChecker::VisitCall(const CallExpression *node,
+                                   Scope<const Type *> *scope) {
+  const Type *function = Visit(node->Function(), scope);
+  std::vector<const Type *> arguments;
+  arguments.reserve(node->Arguments().size());
+  for (const auto &argument : node->Arguments()) {
+    arguments.push_back(Visit(argument, scope));
+  }
+  return CheckCall(node, function, arguments);
+}
+
+const Type *TypeChecker::VisitLambda(const LambdaExpression *node,
+                                     Scope<const Type *> *scope) {
+  NestedScope<const Type *> nested(Names(scope));
+  DeclareParameters(node, Names(scope));
+  return CheckLambda(node, Visit(node->Body(), scope));
+}
+
+const Type *TypeChecker::VisitLoop(const LoopExpression *node,
+                                   Scope<const Type *> *scope) {
+  NestedScope<const Type *> nested(Names(scope));
+  Visit(node->Initializer(), scope);
+  const Type *condition = Visit(node->Condition(), scope);
+  const Type *body = Visit(node->Body(), scope);
+  return CheckLoop(node, condition, body);
+}
+
+const Type *TypeChecker::VisitDefault(const DefaultExpression *node,
+                                      Scope<const Type *> *scope) {
+  return Register(node, node->GetType());
+}
+
+const Type *
+TypeChecker::VisitVariableDeclaration(const VariableDeclarationExpression *node,
+                                      Scope<const Type *> *scope) {
+  const Type *initializer = Visit(node->Initializer(), scope);
+  return CheckVariableDeclaration(node, initializer, Names(scope));
+}
+
+void TypeChecker::Enter(const Expression *node) {
+  if (node->NodeType() == ExpressionType::Lambda) {
+    DeclareParameters(static_cast<const LambdaExpression *>(node), nullptr);
+  }
+}
+
+void TypeChecker::Leave(const Expression *node) {
+  typeStack.push_back(LeaveNode(node));
+}
+
+const Type *TypeChecker::LeaveNode(const Expression *node) {
+  switch (node->NodeType()) {
+  case ExpressionType::Add:
+  case ExpressionType::Subtract:
+  case ExpressionType::Multiply:
+  case ExpressionType::Divide:
+  case ExpressionType::Modulo:
+  case ExpressionType::GreaterThan:
+  case ExpressionType::LessThan:
+  case ExpressionType::GreaterThanOrEqual:
+  case ExpressionType::LessThanOrEqual:
+  case ExpressionType::Equal:
+  case ExpressionType::NotEqual:
+  case ExpressionType::And:
+  case ExpressionType::Or:
+  case ExpressionType::Assign: {
+    const Type *right = PopType();
+    const Type *left = PopType();
+    return CheckBinary(static_cast<const BinaryExpression *>(node), left,
+                       right);
+  }
+  case ExpressionType::Not:
+  case ExpressionType::Convert:
+  case ExpressionType::Halt: {
+    return CheckUnary(static_cast<const UnaryExpression *>(node), PopType());
+  }
+  case ExpressionType::Constant: {
+    return CheckConstant(static_cast<const ConstantExpression *>(node));
+  }
+  case ExpressionType::Parameter: {
+    return CheckParameter(static_cast<const ParameterExpression *>(node),
+                          nullptr);
+  }
+  case ExpressionType::Block: {
+    auto block = static_cast<const BlockExpression *>(node);
+    const Type *type = TypeFactory::CreateBasicType(TypeCode::Empty);
+    if (!block->Expressions().empty()) {
+      type = typeStack.back();
+      typeStack.resize(typeStack.size() - block->Expressions().size());
     }
-    case ExpressionType::Equal:
-    case ExpressionType::NotEqual: {
-      if (left->GetTypeCode() == TypeCode::Int32 &&
-          right->GetTypeCode() == TypeCode::Int32) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
-      } else if (left->GetTypeCode() == TypeCode::Int64 &&
-                 right->GetTypeCode() == TypeCode::Int64) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
-      } else if (left->GetTypeCode() == TypeCode::Float32 &&
-                 right->GetTypeCode() == TypeCode::Float32) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
-      } else if (left->GetTypeCode() == TypeCode::Float64 &&
-                 right->GetTypeCode() == TypeCode::Float64) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
-      } else if (left->GetTypeCode() == TypeCode::Boolean &&
-                 right->GetTypeCode() == TypeCode::Boolean) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
-      } else if (left->GetTypeCode() == TypeCode::Char &&
-                 right->GetTypeCode() == TypeCode::Char) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
-      } else if (left->GetTypeCode() == TypeCode::String &&
-                 right->GetTypeCode() == TypeCode::String) {
-        return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
-      } else {
-        throw TreeException(__FILE__, __LINE__, "type mismatch error.", node,
-                            nullptr);
-      }
+    return Register(node, type);
+  }
+  case ExpressionType::Conditional: {
+    const Type *ifFalse = PopType();
+    const Type *ifTrue = PopType();
+    const Type *test = PopType();
+    return CheckConditional(static_cast<const ConditionalExpression *>(node),
+                            test, ifTrue, ifFalse);
+  }
+  case ExpressionType::Call: {
+    auto call = static_cast<const CallExpression *>(node);
+    size_t start = typeStack.size() - call->Arguments().size();
+    std::vector<const Type *> arguments(typeStack.begin() + start,
+                                        typeStack.end());
+    typeStack.resize(start);
+    return CheckCall(call, PopType(), arguments);
+  }
+  case ExpressionType::Lambda: {
+    return CheckLambda(static_cast<const LambdaExpression *>(node), PopType());
+  }
+  case ExpressionType::Loop: {
+    const Type *body = PopType();
+    const Type *condition = PopType();
+    PopType();
+    return CheckLoop(static_cast<const LoopExpression *>(node), condition,
+                     body);
+  }
+  case ExpressionType::Default: {
+    return Register(node,
+                    static_cast<const DefaultExpression *>(node)->GetType());
+  }
+  case ExpressionType::VariableDeclaration: {
+    return CheckVariableDeclaration(
+        static_cast<const VariableDeclarationExpression *>(node), PopType(),
+        nullptr);
+  }
+  default: {
+    throw TreeException(__FILE__, __LINE__,
+                        "The node type is not supported by the type checker.",
+                        node, nullptr);
+  }
+  }
+}
+
+const Type *TypeChecker::PopType() {
+  const Type *type = typeStack.back();
+  typeStack.pop_back();
+  return type;
+}
+
+const Type *TypeChecker::CheckBinary(const BinaryExpression *node,
+                                     const Type *left, const Type *right) {
+  if (node->NodeType() == ExpressionType::Assign) {
+    if (node->Left()->NodeType() != ExpressionType::Parameter) {
+      throw TreeException(__FILE__, __LINE__,
+                          "type checking not supported error.", node, nullptr);
+    } else if (relations.IsAssignable(right, left)) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Empty));
+    } else {
+      throw TreeException(__FILE__, __LINE__, "type mismatch error.", node,
+                          nullptr);
     }
-    default: {
+  }
+  switch (node->NodeType()) {
+  case ExpressionType::Add:
+  case ExpressionType::Subtract:
+  case ExpressionType::Multiply:
+  case ExpressionType::Divide: {
+    if (left->GetTypeCode() == TypeCode::Int32 &&
+        right->GetTypeCode() == TypeCode::Int32) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Int32));
+    } else if (left->GetTypeCode() == TypeCode::Int64 &&
+               right->GetTypeCode() == TypeCode::Int64) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Int64));
+    } else if (left->GetTypeCode() == TypeCode::Float32 &&
+               right->GetTypeCode() == TypeCode::Float32) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Float32));
+    } else if (left->GetTypeCode() == TypeCode::Float64 &&
+               right->GetTypeCode() == TypeCode::Float64) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Float64));
+    } else if (node->NodeType() == ExpressionType::Add &&
+               left->GetTypeCode() == TypeCode::String &&
+               right->GetTypeCode() == TypeCode::String) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::String));
+    } else {
       throw TreeException(__FILE__, __LINE__, "type mismatch error.", node,
                           nullptr);
     }
+  }
+  case ExpressionType::GreaterThan:
+  case ExpressionType::LessThan:
+  case ExpressionType::GreaterThanOrEqual:
+  case ExpressionType::LessThanOrEqual: {
+    if (left->GetTypeCode() == TypeCode::Int32 &&
+        right->GetTypeCode() == TypeCode::Int32) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
+    } else if (left->GetTypeCode() == TypeCode::Int64 &&
+               right->GetTypeCode() == TypeCode::Int64) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
+    } else if (left->GetTypeCode() == TypeCode::Float32 &&
+               right->GetTypeCode() == TypeCode::Float32) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
+    } else if (left->GetTypeCode() == TypeCode::Float64 &&
+               right->GetTypeCode() == TypeCode::Float64) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
+    } else if (left->GetTypeCode() == TypeCode::Char &&
+               right->GetTypeCode() == TypeCode::Char) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
+    } else if (left->GetTypeCode() == TypeCode::String &&
+               right->GetTypeCode() == TypeCode::String) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
+    } else {
+      throw TreeException(__FILE__, __LINE__, "type mismatch error.", node,
+                          nullptr);
     }
   }
+  case ExpressionType::Equal:
+  case ExpressionType::NotEqual: {
+    if (left->GetTypeCode() == TypeCode::Int32 &&
+        right->GetTypeCode() == TypeCode::Int32) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
+    } else if (left->GetTypeCode() == TypeCode::Int64 &&
+               right->GetTypeCode() == TypeCode::Int64) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
+    } else if (left->GetTypeCode() == TypeCode::Float32 &&
+               right->GetTypeCode() == TypeCode::Float32) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
+    } else if (left->GetTypeCode() == TypeCode::Float64 &&
+               right->GetTypeCode() == TypeCode::Float64) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
+    } else if (left->GetTypeCode() == TypeCode::Boolean &&
+               right->GetTypeCode() == TypeCode::Boolean) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
+    } else if (left->GetTypeCode() == TypeCode::Char &&
+               right->GetTypeCode() == TypeCode::Char) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
+    } else if (left->GetTypeCode() == TypeCode::String &&
+               right->GetTypeCode() == TypeCode::String) {
+      return Register(node, TypeFactory::CreateBasicType(TypeCode::Boolean));
+    } else {
+      throw TreeException(__FILE__, __LINE__, "type mismatch error.", node,
+                          nullptr);
+    }
+  }
+  default: {
+    throw TreeException(__FILE__, __LINE__, "type mismatch error.", node,
+                        nullptr);
+  }
+  }
 }
 
-const Type *TypeChecker::VisitConstant(const ConstantExpression *node,
-                                       Scope<const Type *> *scope) {
+const Type *TypeChecker::CheckConstant(const ConstantExpression *node) {
+  /* Throws when the literal does not fit its type. */
+  Literal{node};
   return Register(node, TypeFactory::CreateBasicType(node->GetTypeCode()));
 }
 
-const Type *TypeChecker::VisitParameter(const ParameterExpression *node,
+const Type *TypeChecker::CheckParameter(const ParameterExpression *node,
                                         Scope<const Type *> *scope) {
-  if (scope->Exists(node->Name())) {
+  const Expression *declaration =
+      bindings ? bindings->at(node).declaration : nullptr;
+  if (declaration && (variableTypes.count(declaration) ||
+                      declaration->NodeType() == ExpressionType::Lambda)) {
+    return Register(node, GetVariableType(declaration));
+  } else if (scope && scope->Exists(node->Name())) {
     const Type *type = scope->Get(node->Name());
     return Register(node, type);
   } else {
@@ -136,23 +345,12 @@ const Type *TypeChecker::VisitParameter(const ParameterExpression *node,
   }
 }
 
-const Type *TypeChecker::VisitBlock(const BlockExpression *node,
-                                    Scope<const Type *> *parent) {
-  Scope<const Type *> scope(parent);
-  const Type *type = TypeFactory::CreateBasicType(TypeCode::Empty);
-  for (const auto &expression : node->Expressions()) {
-    type = Visit(expression, &scope);
-  }
-  return Register(node, type);
-}
-
-const Type *TypeChecker::VisitConditional(const ConditionalExpression *node,
-                                          Scope<const Type *> *scope) {
-  const Type *test = Visit(node->Test(), scope);
+const Type *TypeChecker::CheckConditional(const ConditionalExpression *node,
+                                          const Type *test,
+                                          const Type *ifTrue,
+                                          const Type *ifFalse) {
   if (test->GetTypeCode() == TypeCode::Boolean) {
-    const Type *ifTrue = Visit(node->IfTrue(), scope);
-    const Type *ifFalse = Visit(node->IfFalse(), scope);
-    return Register(node, Types.CreateUnionType(ifTrue, ifFalse));
+    return Register(node, types->CreateUnionType(ifTrue, ifFalse));
   } else {
     throw TreeException(__FILE__, __LINE__, "The type of condition of the "
                                             "conditional expression must be a "
@@ -161,9 +359,8 @@ const Type *TypeChecker::VisitConditional(const ConditionalExpression *node,
   }
 }
 
-const Type *TypeChecker::VisitUnary(const UnaryExpression *node,
-                                    Scope<const Type *> *scope) {
-  const Type *operand = Visit(node->Operand(), scope);
+const Type *TypeChecker::CheckUnary(const UnaryExpression *node,
+                                    const Type *operand) {
   switch (node->NodeType()) {
   case ExpressionType::Not: {
     if (operand->GetTypeCode() == TypeCode::Boolean) {
@@ -182,7 +379,7 @@ const Type *TypeChecker::VisitUnary(const UnaryExpression *node,
     }
   }
   case ExpressionType::Convert: {
-    if (TypeFactory::AreTypesEqual(operand, node->GetType())) {
+    if (relations.AreTypesEqual(operand, node->GetType())) {
       return Register(node, operand);
     } else {
       if (operand->GetTypeCode() == TypeCode::Int32 ||
@@ -211,15 +408,14 @@ const Type *TypeChecker::VisitUnary(const UnaryExpression *node,
   }
 }
 
-const Type *TypeChecker::VisitCall(const CallExpression *node,
-                                   Scope<const Type *> *scope) {
-  auto callableType = Visit(node->Function(), scope);
-  if (callableType->GetTypeCode() == TypeCode::Callable) {
-    auto t = static_cast<const CallableType *>(callableType);
-    if (t->Arguments().size() == node->Arguments().size()) {
-      for (size_t i = 0; i < node->Arguments().size(); i++) {
-        auto argType = Visit(node->Arguments().at(i), scope);
-        if (!TypeFactory::AreTypesEqual(argType, t->Arguments().at(i))) {
+const Type *TypeChecker::CheckCall(const CallExpression *node,
+                                   const Type *function,
+                                   const std::vector<const Type *> &arguments) {
+  if (function->GetTypeCode() == TypeCode::Callable) {
+    auto t = static_cast<const CallableType *>(function);
+    if (t->Arguments().size() == arguments.size()) {
+      for (size_t i = 0; i < arguments.size(); i++) {
+        if (!relations.IsAssignable(arguments.at(i), t->Arguments().at(i))) {
           throw TreeException(__FILE__, __LINE__,
                               "argument " + std::to_string(i) +
                                   " type mismatch error.",
@@ -239,28 +435,39 @@ const Type *TypeChecker::VisitCall(const CallExpression *node,
   }
 }
 
-const Type *TypeChecker::VisitLambda(const LambdaExpression *node,
-                                     Scope<const Type *> *parent) {
-  Scope<const Type *> scope(parent);
-  std::vector<const Type *> argumentTypes;
-  argumentTypes.reserve(node->Parameters().size());
+void TypeChecker::DeclareParameters(const LambdaExpression *node,
+                                    Scope<const Type *> *scope) {
   for (const auto &parameter : node->Parameters()) {
     spdlog::debug("Type checker declares parameter \"{}\".",
                   Utility::UTF32ToUTF8(parameter->Name()));
-    scope.Declare(parameter->Name(), parameter->GetType());
+    if (scope) {
+      scope->Declare(parameter->Name(), parameter->GetType());
+    }
+    variableTypes[parameter] = parameter->GetType();
+    Register(parameter, parameter->GetType());
+  }
+}
+
+const Type *TypeChecker::CheckLambda(const LambdaExpression *node,
+                                     const Type *bodyType) {
+  std::vector<const Type *> argumentTypes;
+  argumentTypes.reserve(node->Parameters().size());
+  for (const auto &parameter : node->Parameters()) {
     argumentTypes.push_back(parameter->GetType());
   }
-  const Type *returnType = Visit(node->Body(), &scope);
-  return Types.CreateCallableType(argumentTypes, returnType);
+  if (relations.IsAssignable(bodyType, node->ReturnType())) {
+    return Register(node, types->CreateCallableType(argumentTypes,
+                                                   node->ReturnType()));
+  } else {
+    throw TreeException(__FILE__, __LINE__, "return type mismatch error.",
+                        node, nullptr);
+  }
 }
 
-const Type *TypeChecker::VisitLoop(const LoopExpression *node,
-                                   Scope<const Type *> *parent) {
-  Scope<const Type *> scope(parent);
-  Visit(node->Initializer(), &scope);
-  const Type *type = Visit(node->Condition(), &scope);
-  if (type->GetTypeCode() == TypeCode::Boolean) {
-    return Visit(node->Body(), &scope);
+const Type *TypeChecker::CheckLoop(const LoopExpression *node,
+                                   const Type *condition, const Type *body) {
+  if (condition->GetTypeCode() == TypeCode::Boolean) {
+    return Register(node, body);
   } else {
     throw TreeException(
         __FILE__, __LINE__,
@@ -269,24 +476,44 @@ const Type *TypeChecker::VisitLoop(const LoopExpression *node,
   }
 }
 
-const Type *TypeChecker::VisitDefault(const DefaultExpression *node,
-                                      Scope<const Type *> *scope) {
-  return node->GetType();
-}
-
 const Type *
-TypeChecker::VisitVariableDeclaration(const VariableDeclarationExpression *node,
+TypeChecker::CheckVariableDeclaration(const VariableDeclarationExpression *node,
+                                      const Type *initializer,
                                       Scope<const Type *> *scope) {
-  const Type* initializer = Visit(node->Initializer(), scope);
-  scope->Declare(node->Name(), initializer);
-  
-  return TypeFactory::CreateBasicType(TypeCode::Empty);
+  if (scope) {
+    scope->Declare(node->Name(), initializer);
+  }
+  variableTypes[node] = initializer;
+
+  return Register(node, TypeFactory::CreateBasicType(TypeCode::Empty));
 }
 
 const Type *TypeChecker::GetType(const Expression *node) {
   return nodeTypes.at(node);
 }
 
+const Type *TypeChecker::GetVariableType(const Expression *declaration) {
+  auto it = variableTypes.find(declaration);
+  if (it != variableTypes.end()) {
+    return it->second;
+  } else if (declaration->NodeType() == ExpressionType::Lambda) {
+    auto lambda = static_cast<const LambdaExpression *>(declaration);
+    std::vector<const Type *> argumentTypes;
+    argumentTypes.reserve(lambda->Parameters().size());
+    for (const auto &parameter : lambda->Parameters()) {
+      argumentTypes.push_back(parameter->GetType());
+    }
+    const Type *type =
+        types->CreateCallableType(argumentTypes, lambda->ReturnType());
+    variableTypes[declaration] = type;
+    return type;
+  } else {
+    throw TreeException(__FILE__, __LINE__,
+                        "The declaration has not been type checked.",
+                        declaration, nullptr);
+  }
+}
+
 const Type *TypeChecker::Register(const Expression *node, const Type *type) {
   nodeTypes[node] = type;
   return type;
@@ -0,0 +1,151 @@
+#include <catch2/catch.hpp>
+
+#include "Driver/CompilerDatabase.hpp"
+
+using namespace Cygni::Driver;
+using namespace Cygni::Expressions;
+using namespace Cygni::Visitors;
+
+TEST_CASE("test compiler database", "[CompilerDatabase]") {
+  CompilerDatabase database;
+  database.SetSourceText("a", U"func f(x: Int): Int { var y = x + 1; y; }\n"
+                              U"func g(x: Int): Int { x * 2; }\n");
+  database.SetSourceText("b", U"func h(x: Int): Int { g(x) + f(x); }\n");
+
+  auto checkAll = [&database]() {
+    for (const auto &name : {U"f", U"g", U"h"}) {
+      database.TypeOfBody(name);
+    }
+  };
+
+  checkAll();
+  REQUIRE(database.Executions(QueryKind::TypeOfBody) == 3);
+  REQUIRE(database.Executions(QueryKind::AstOfFunction) == 3);
+  REQUIRE(database.TypeOfBody(U"h").diagnostic.empty());
+  REQUIRE(database.LocationOfFunction(U"h").file == "b");
+  REQUIRE(database.LocationOfFunction(U"h").number == 2);
+  REQUIRE(database.BindingsOfFunction(U"h").freeNames ==
+          std::vector<std::u32string>{U"g", U"f"});
+
+  checkAll();
+  REQUIRE(database.Executions(QueryKind::TypeOfBody) == 3);
+
+  SECTION("body edit") {
+    database.SetSourceText("a", U"func f(x: Int): Int { var y = x + 1; y; }\n"
+                                U"func g(x: Int): Int { x * 3; }\n");
+    checkAll();
+    REQUIRE(database.Executions(QueryKind::TokensOfFile) == 3);
+    REQUIRE(database.Executions(QueryKind::AstOfFunction) == 4);
+    REQUIRE(database.Executions(QueryKind::SignatureOfFunction) == 3);
+    REQUIRE(database.Executions(QueryKind::TypeOfBody) == 4);
+  }
+
+  SECTION("whitespace edit") {
+    database.SetSourceText("b", U"func h(x: Int): Int { g(x) + f(x); }\n\n\n");
+    checkAll();
+    REQUIRE(database.Executions(QueryKind::FunctionsOfFile) == 3);
+    REQUIRE(database.Executions(QueryKind::AstOfFunction) == 3);
+    REQUIRE(database.Executions(QueryKind::TypeOfBody) == 3);
+  }
+
+  SECTION("blank line above functions") {
+    REQUIRE(database.PositionOfFunction(U"g").line == 1);
+    database.SetSourceText("a", U"\nfunc f(x: Int): Int { var y = x + 1; y; }\n"
+                                U"func g(x: Int): Int { x * 2; }\n");
+    checkAll();
+    REQUIRE(database.Executions(QueryKind::FunctionsOfFile) == 3);
+    REQUIRE(database.Executions(QueryKind::TokensOfFunction) == 3);
+    REQUIRE(database.Executions(QueryKind::AstOfFunction) == 3);
+    REQUIRE(database.Executions(QueryKind::TypeOfBody) == 3);
+    REQUIRE(database.PositionOfFunction(U"g") == SourcePosition("a", 2));
+    REQUIRE(database.PositionOfFunction(U"h") == SourcePosition("b", 0));
+    REQUIRE(database.DiagnosticOfFunction(U"g").empty());
+  }
+
+  SECTION("signature edit") {
+    database.SetSourceText("a", U"func f(x: Int): Int { var y = x + 1; y; }\n"
+                                U"func g(x: Int): Bool { x == 3; }\n");
+    checkAll();
+    REQUIRE(database.Executions(QueryKind::TypeOfBody) == 5);
+    REQUIRE(database.TypeOfBody(U"g").diagnostic.empty());
+    REQUIRE(database.TypeOfBody(U"h").diagnostic == "type mismatch error.");
+    REQUIRE(database.DiagnosticOfFunction(U"h") ==
+            "b:1: 'h': type mismatch error.");
+  }
+
+  SECTION("definitions added and removed") {
+    database.SetSourceText("b", U"func h(x: Int): Int { k(x); }\n");
+    REQUIRE(database.TypeOfBody(U"h").diagnostic == "'k' not defined.");
+    REQUIRE(database.SignatureOfFunction(U"k") == nullptr);
+
+    database.SetSourceText("c", U"func k(x: Int): Int { x; }\n");
+    checkAll();
+    REQUIRE(database.TypeOfBody(U"h").diagnostic.empty());
+    REQUIRE(database.Executions(QueryKind::TypeOfBody) == 5);
+
+    const FunctionSlots &slots = database.SlotsOfFunction(U"h");
+    REQUIRE(slots.diagnostic.empty());
+    REQUIRE(slots.frame.frameSize == 1);
+    bool located = false;
+    for (const auto &item : slots.nameInfoTable) {
+      if (item.first->NodeType() == ExpressionType::Parameter &&
+          static_cast<const ParameterExpression *>(item.first)->Name() ==
+              U"k") {
+        REQUIRE(item.second.kind == LocationKind::Function);
+        REQUIRE(item.second.number == 3);
+        located = true;
+      }
+    }
+    REQUIRE(located);
+
+    database.RemoveSourceFile("c");
+    REQUIRE(database.TypeOfBody(U"h").diagnostic == "'k' not defined.");
+    REQUIRE(database.TypeOfBody(U"f").diagnostic.empty());
+    REQUIRE(database.Executions(QueryKind::TypeOfBody) == 6);
+  }
+
+  SECTION("duplicate definition") {
+    database.SetSourceText("c", U"func g(x: Int): Int { x; }\n");
+    REQUIRE(database.DiagnosticOfFunction(U"g") == "c:1: 'g' defined twice.");
+    REQUIRE(database.LocationOfFunction(U"g").file == "a");
+
+    database.SetSourceText("c", U"func k(): Int { 1; }\n"
+                                U"func k(): Int { 2; }\n");
+    REQUIRE(database.DiagnosticOfFunction(U"k") == "c:2: 'k' defined twice.");
+    REQUIRE(database.DiagnosticOfFunction(U"g").empty());
+  }
+
+  SECTION("literal out of range") {
+    database.SetSourceText("c", U"func k(): Int { 3000000000; }\n"
+                                U"func m(): Int { 99999999999999999999; }\n"
+                                U"func n(): Int { 2147483647; }\n");
+    REQUIRE(database.DiagnosticOfFunction(U"k") ==
+            "c:1: 'k': literal out of range.");
+    REQUIRE(database.DiagnosticOfFunction(U"m") ==
+            "c:2: 'm': literal out of range.");
+    REQUIRE(database.DiagnosticOfFunction(U"n").empty());
+  }
+
+  SECTION("exception from a dependency") {
+    database.SetSourceText("a", U"func f(x: Int): Int { 'ab'; }\n"
+                                U"func g(x: Int): Int { x * 2; }\n");
+    try {
+      checkAll();
+    } catch (...) {
+    }
+    database.SetSourceText("a", U"func f(x: Int): Int { var y = x + 1; y; }\n"
+                                U"func g(x: Int): Int { x * 3; }\n");
+    checkAll();
+    REQUIRE(database.TypeOfBody(U"h").diagnostic.empty());
+  }
+
+  SECTION("parse error") {
+    database.SetSourceText("a", U"func f(x: Int): Int { var y = x + ; y; }\n"
+                                U"func g(x: Int): Int { x * 2; }\n");
+    checkAll();
+    REQUIRE_FALSE(database.TypeOfBody(U"f").diagnostic.empty());
+    REQUIRE(database.SignatureOfFunction(U"f") == nullptr);
+    REQUIRE(database.TypeOfBody(U"h").diagnostic == "'f' not defined.");
+    REQUIRE(database.TypeOfBody(U"g").diagnostic.empty());
+  }
+}
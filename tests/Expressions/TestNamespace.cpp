@@ -52,4 +52,54 @@ TEST_CASE("namespace Universe::Galaxies", "[Namespace]") {
     REQUIRE(namespaceFactory.Search(root, {U"Universe", U"Galaxies", U"Spiral"}) != nullptr);
     REQUIRE(namespaceFactory.Search(root, {U"Universe", U"Galaxies", U"Elliptical"}) == nullptr);
     REQUIRE(namespaceFactory.Search(root, {U"Universe", U"Particles"}) != nullptr);
-}
\ No newline at end of file
+}
+TEST_CASE("namespace qualified symbols", "[Namespace]") {
+    NamespaceFactory namespaceFactory;
+    ExpressionFactory expressionFactory;
+    std::shared_ptr<Cygni::LexicalAnalysis::SourceCodeFile> sourceCodeFile =
+        std::make_shared<Cygni::LexicalAnalysis::SourceCodeFile>("source-code-file");
+    SourceRange range(sourceCodeFile, 1, 1, 1, 1);
+
+    Namespace* root = namespaceFactory.Create(nullptr, U"");
+    namespaceFactory.Insert(root, {U"Geometry", U"Shape", U"Polygon"});
+    Namespace* shape = namespaceFactory.Search(root, {U"Geometry", U"Shape"});
+
+    REQUIRE(shape->QualifiedName() == U"Geometry.Shape");
+    REQUIRE(namespaceFactory.Search(root, {}) == root);
+    REQUIRE(root->Children().Size() == 1);
+
+    auto area = expressionFactory.Create<LambdaExpression>(
+        range, U"Area",
+        expressionFactory.Create<DefaultExpression>(
+            range, TypeFactory::CreateBasicType(TypeCode::Empty)),
+        std::vector<ParameterExpression*>{},
+        TypeFactory::CreateBasicType(TypeCode::Empty));
+    auto sides = expressionFactory.Create<ParameterExpression>(
+        range, U"Sides", TypeFactory::CreateBasicType(TypeCode::Int32));
+    namespaceFactory.DefineFunction(shape, area);
+    namespaceFactory.DefineGlobalVariable(shape, sides);
+
+    REQUIRE(namespaceFactory.SearchFunction(root, {U"Geometry", U"Shape", U"Area"}) == area);
+    REQUIRE(namespaceFactory.SearchFunction(shape, {U"Area"}) == area);
+    REQUIRE(namespaceFactory.SearchFunction(root, {U"Geometry", U"Area"}) == nullptr);
+    REQUIRE(namespaceFactory.SearchGlobalVariable(root, {U"Geometry", U"Shape", U"Sides"}) == sides);
+    REQUIRE(*shape->Functions().Find(U"Area") == area);
+    REQUIRE_THROWS(namespaceFactory.Create(nullptr, U"Other"));
+
+    auto otherArea = expressionFactory.Create<LambdaExpression>(
+        range, U"Area",
+        expressionFactory.Create<DefaultExpression>(
+            range, TypeFactory::CreateBasicType(TypeCode::Int32)),
+        std::vector<ParameterExpression*>{},
+        TypeFactory::CreateBasicType(TypeCode::Int32));
+    auto otherSides = expressionFactory.Create<ParameterExpression>(
+        range, U"Sides", TypeFactory::CreateBasicType(TypeCode::Int64));
+    REQUIRE_THROWS_AS(namespaceFactory.DefineFunction(shape, otherArea),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(namespaceFactory.DefineGlobalVariable(shape, otherSides),
+                      std::invalid_argument);
+    REQUIRE(namespaceFactory.SearchFunction(shape, {U"Area"}) == area);
+    REQUIRE(*shape->Functions().Find(U"Area") == area);
+    REQUIRE(namespaceFactory.SearchGlobalVariable(shape, {U"Sides"}) == sides);
+    REQUIRE(shape->Functions().Size() == 1);
+}
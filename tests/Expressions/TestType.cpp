@@ -1,5 +1,6 @@
 #include <catch2/catch.hpp>
 
+#include <thread>
 #include "Expressions/Type.hpp"
 
 using namespace Cygni::Expressions;
@@ -26,3 +27,88 @@ TEST_CASE("type equality", "[Type]") {
       typeFactory.CreateArrayType(
           typeFactory.CreateBasicType(TypeCode::Char))));
 }
+
+TEST_CASE("type relation cache", "[Type]") {
+  TypeFactory typeFactory;
+  TypeFactory otherTypeFactory;
+  TypeRelationCache relations;
+
+  const Type *int32Type = TypeFactory::CreateBasicType(TypeCode::Int32);
+  const Type *float64Type = TypeFactory::CreateBasicType(TypeCode::Float64);
+
+  auto inner1 = typeFactory.CreateCallableType({int32Type}, float64Type);
+  auto inner2 = otherTypeFactory.CreateCallableType({int32Type}, float64Type);
+  auto outer1 = typeFactory.CreateCallableType({inner1, int32Type}, inner1);
+  auto outer2 =
+      otherTypeFactory.CreateCallableType({inner2, int32Type}, inner2);
+
+  REQUIRE(relations.AreTypesEqual(outer1, outer2));
+  REQUIRE(relations.Misses() == 2);
+  REQUIRE(relations.Hits() == 1);
+
+  REQUIRE(relations.AreTypesEqual(outer2, outer1));
+  REQUIRE(relations.Misses() == 2);
+  REQUIRE(relations.Hits() == 2);
+
+  REQUIRE_FALSE(relations.AreTypesEqual(
+      outer1, typeFactory.CreateCallableType({int32Type}, int32Type)));
+}
+
+TEST_CASE("type assignability", "[Type]") {
+  TypeFactory typeFactory;
+  TypeRelationCache relations;
+
+  const Type *int32Type = TypeFactory::CreateBasicType(TypeCode::Int32);
+  const Type *stringType = TypeFactory::CreateBasicType(TypeCode::String);
+  const Type *booleanType = TypeFactory::CreateBasicType(TypeCode::Boolean);
+  const Type *unionType = typeFactory.CreateUnionType(int32Type, stringType);
+
+  REQUIRE(relations.IsAssignable(int32Type, int32Type));
+  REQUIRE(relations.IsAssignable(int32Type, unionType));
+  REQUIRE(relations.IsAssignable(stringType, unionType));
+  REQUIRE_FALSE(relations.IsAssignable(booleanType, unionType));
+  REQUIRE_FALSE(relations.IsAssignable(unionType, int32Type));
+
+  auto narrow = typeFactory.CreateCallableType({unionType}, int32Type);
+  auto wide = typeFactory.CreateCallableType({int32Type}, unionType);
+  REQUIRE(relations.IsAssignable(narrow, wide));
+  REQUIRE_FALSE(relations.IsAssignable(wide, narrow));
+
+  size_t misses = relations.Misses();
+  REQUIRE(relations.IsAssignable(narrow, wide));
+  REQUIRE(relations.Misses() == misses);
+}
+
+TEST_CASE("type interning", "[Type]") {
+  TypeFactory typeFactory;
+
+  const Type *int32Type = TypeFactory::CreateBasicType(TypeCode::Int32);
+  const Type *charType = TypeFactory::CreateBasicType(TypeCode::Char);
+
+  REQUIRE(typeFactory.CreateCallableType({int32Type}, charType) ==
+          typeFactory.CreateCallableType({int32Type}, charType));
+  REQUIRE(typeFactory.CreateCallableType({int32Type}, charType) !=
+          typeFactory.CreateCallableType({charType}, int32Type));
+  REQUIRE(typeFactory.CreateUnionType(int32Type, charType) ==
+          typeFactory.CreateUnionType(charType, int32Type));
+  REQUIRE(typeFactory.CreateArrayType(int32Type) ==
+          typeFactory.CreateArrayType(int32Type));
+
+  std::vector<const Type *> results(8);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&typeFactory, &results, int32Type, charType, t]() {
+      const Type *type = int32Type;
+      for (int i = 0; i < 100; i++) {
+        type = typeFactory.CreateCallableType({type, charType}, int32Type);
+      }
+      results[t] = type;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (auto result : results) {
+    REQUIRE(result == results.front());
+  }
+}
@@ -0,0 +1,51 @@
+#include <catch2/catch.hpp>
+
+#include "Driver/CompilerDatabase.hpp"
+#include "Interpreter/ClosureInterpreter.hpp"
+#include "TestPrograms.hpp"
+
+using namespace Cygni::Driver;
+using namespace Cygni::Interpreter;
+using namespace Cygni::Tests;
+
+TEST_CASE("test closure interpreter", "[ClosureInterpreter]") {
+  CompilerDatabase database;
+  database.SetSourceText("program", BasicProgram);
+  ClosureInterpreter interpreter(&database);
+
+  REQUIRE(interpreter.Call(U"fib", {Value::Int32(20)}).int32 == 6765);
+  REQUIRE(interpreter.Call(U"sum", {Value::Int32(100)}).int32 == 4950);
+  Value repeated =
+      interpreter.Call(U"repeat", {Value::Text(U"ab"), Value::Int32(3)});
+  REQUIRE(repeated.type == TypeCode::String);
+  REQUIRE(*repeated.string == U"ababab");
+  REQUIRE(interpreter.Call(U"half", {Value::Float64(5.0)}).float64 == 2.5);
+  REQUIRE(interpreter.Call(U"same", {Value::Text(U"x"), Value::Text(U"x")})
+              .ToString() == "true");
+  REQUIRE(interpreter.Call(U"scoped", {Value::Int32(3)}).int32 == 7);
+  REQUIRE(interpreter.Call(U"divide", {Value::Int32(7), Value::Int32(2)})
+              .int32 == 3);
+  REQUIRE_THROWS_WITH(
+      interpreter.Call(U"divide", {Value::Int32(7), Value::Int32(0)}),
+      "division by zero.");
+  REQUIRE_THROWS_WITH(interpreter.Call(U"fib", {Value::Text(U"x")}),
+                      "argument 0 type mismatch error.");
+  REQUIRE(interpreter.Call(U"ack", {Value::Int32(2), Value::Int32(3)}).int32 ==
+          9);
+  REQUIRE_THROWS_WITH(interpreter.Call(U"deep", {Value::Int32(0)}),
+                      "stack overflow.");
+  REQUIRE(interpreter.Call(U"fib", {Value::Int32(10)}).int32 == 55);
+
+  ClosureInterpreter small(&database, 16);
+  REQUIRE(small.Call(U"fib", {Value::Int32(10)}).int32 == 55);
+  REQUIRE_THROWS_WITH(small.Call(U"fib", {Value::Int32(20)}),
+                      "stack overflow.");
+}
+
+TEST_CASE("test closure interpreter diagnostics", "[ClosureInterpreter]") {
+  CompilerDatabase database;
+  database.SetSourceText("program",
+                         U"func f(x: Int): Int { x + true; }\n");
+  REQUIRE_THROWS_WITH(ClosureInterpreter(&database),
+                      "program:1: 'f': type mismatch error.");
+}
@@ -0,0 +1,292 @@
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include "Driver/CompilerDatabase.hpp"
+#include "Interpreter/BytecodeCompiler.hpp"
+#include "Interpreter/JitMachine.hpp"
+#include "TestPrograms.hpp"
+#include "Utility/UTF32Functions.hpp"
+
+using namespace Cygni::Driver;
+using namespace Cygni::Interpreter;
+using namespace Cygni::Tests;
+
+namespace {
+
+class TestCall {
+public:
+  std::u32string function;
+  std::vector<Value> arguments;
+};
+
+class TestProgram {
+public:
+  const char32_t *source;
+  std::vector<TestCall> calls;
+  /* The functions the JIT is expected to compile. */
+  std::vector<std::u32string> compiled;
+};
+
+/* The result of a call as text, or the message it threw. */
+std::string Outcome(std::function<Value()> call) {
+  try {
+    Value result = call();
+    return std::to_string(static_cast<int>(result.type)) + " " +
+           result.ToString();
+  } catch (const std::exception &exception) {
+    return std::string("error: ") + exception.what();
+  }
+}
+
+const std::vector<TestProgram> &Programs() {
+  static const std::vector<TestProgram> programs = {
+      {BasicProgram,
+       {{U"fib", {Value::Int32(20)}},
+        {U"fib", {Value::Int32(0)}},
+        {U"sum", {Value::Int32(100)}},
+        {U"repeat", {Value::Text(U"ab"), Value::Int32(3)}},
+        {U"half", {Value::Float64(5.0)}},
+        {U"same", {Value::Text(U"x"), Value::Text(U"x")}},
+        {U"divide", {Value::Int32(7), Value::Int32(2)}},
+        {U"divide", {Value::Int32(-7), Value::Int32(2)}},
+        {U"divide", {Value::Int32(7), Value::Int32(0)}},
+        {U"divide", {Value::Int32(INT32_MIN), Value::Int32(-1)}},
+        {U"scoped", {Value::Int32(3)}},
+        {U"ack", {Value::Int32(2), Value::Int32(3)}},
+        {U"fib", {Value::Text(U"x")}},
+        {U"fib", {}},
+        {U"deep", {Value::Int32(0)}},
+        {U"missing", {}}},
+       {U"fib", U"sum", U"half", U"divide", U"scoped", U"ack", U"deep"}},
+      {TailCallProgram,
+       {{U"sum", {Value::Int32(700000), Value::Int32(0)}},
+        {U"even", {Value::Int32(100001)}},
+        {U"odd", {Value::Int32(7)}},
+        {U"last", {Value::Int32(4)}},
+        {U"around", {Value::Int32(4)}}},
+       {U"sum", U"even", U"odd", U"last", U"count", U"around"}},
+      {TypedProgram,
+       {{U"mix", {Value::Int64(3000000000LL), Value::Int64(7)}},
+        {U"mix", {Value::Int64(-5), Value::Int64(3)}},
+        {U"order", {Value::Int64(1), Value::Int64(2)}},
+        {U"order", {Value::Int64(2), Value::Int64(2)}},
+        {U"quotient", {Value::Int64(INT64_MIN), Value::Int64(-1)}},
+        {U"quotient", {Value::Int64(5), Value::Int64(0)}},
+        {U"scale", {Value::Float32(1.5f), Value::Float32(4.0f)}},
+        {U"smaller", {Value::Float32(1.5f), Value::Float32(4.0f)}},
+        {U"before", {Value::Char(U'a'), Value::Char(U'b')}},
+        {U"before", {Value::Char(U'z'), Value::Char(U'b')}},
+        {U"flip", {Value::Boolean(true)}},
+        {U"collatz", {Value::Int32(27)}},
+        {U"grid", {Value::Int32(30)}},
+        {U"area", {Value::Float64(2.0)}},
+        {U"area", {Value::Float64(-2.0)}},
+        {U"mix", {Value::Int32(1), Value::Int64(2)}}},
+       {U"mix", U"order", U"quotient", U"scale", U"smaller", U"before",
+        U"flip", U"collatz", U"grid", U"area"}}};
+  return programs;
+}
+
+}; /* namespace */
+
+/* Every program runs on the machine and through the JIT, which must agree
+ * on each result and error. */
+TEST_CASE("test jit against the virtual machine", "[JitMachine]") {
+  for (const TestProgram &program : Programs()) {
+    CompilerDatabase database;
+    database.SetSourceText("program", program.source);
+    BytecodeModule module = BytecodeCompiler(&database).Compile();
+    VirtualMachine machine(&module);
+    JitMachine jit(&module);
+    JitMachine tiered(&module, TierThresholds(1, 1));
+    if (JitMachine::IsSupported()) {
+      for (const std::u32string &name : program.compiled) {
+        REQUIRE(jit.IsCompiled(name));
+      }
+    }
+    for (const TestCall &call : program.calls) {
+      std::string expected = Outcome(
+          [&]() { return machine.Call(call.function, call.arguments); });
+      std::string actual =
+          Outcome([&]() { return jit.Call(call.function, call.arguments); });
+      INFO(Cygni::Utility::UTF32ToUTF8(call.function));
+      REQUIRE(actual == expected);
+      /* Once while the function is queued, once compiled. */
+      auto run = [&]() { return tiered.Call(call.function, call.arguments); };
+      REQUIRE(Outcome(run) == expected);
+      tiered.WaitForCompilation();
+      REQUIRE(Outcome(run) == expected);
+    }
+  }
+}
+
+TEST_CASE("test jit fallback", "[JitMachine]") {
+  CompilerDatabase database;
+  database.SetSourceText(
+      "program",
+      U"func twice(x: Int): Int { x * 2; }\n"
+      U"func apply(x: Int): Int { var f = twice; f(x); }\n"
+      U"func greet(s: String): String { s + \"!\"; }\n"
+      U"func both(x: Int): Int { apply(x) + twice(x); }\n");
+  BytecodeModule module = BytecodeCompiler(&database).Compile();
+  JitMachine jit(&module);
+  REQUIRE(jit.IsCompiled(U"twice") == JitMachine::IsSupported());
+  REQUIRE_FALSE(jit.IsCompiled(U"apply"));
+  REQUIRE_FALSE(jit.IsCompiled(U"greet"));
+  REQUIRE_FALSE(jit.IsCompiled(U"both"));
+  REQUIRE(jit.Call(U"both", {Value::Int32(5)}).int32 == 20);
+  REQUIRE(*jit.Call(U"greet", {Value::Text(U"hi")}).string == U"hi!");
+  REQUIRE(jit.Call(U"twice", {Value::Int32(21)}).int32 == 42);
+  REQUIRE((jit.CodeSize() > 0) == JitMachine::IsSupported());
+}
+
+TEST_CASE("test jit stack limits", "[JitMachine]") {
+  CompilerDatabase database;
+  database.SetSourceText(
+      "program",
+      U"func fib(n: Int): Int {"
+      U"  if (n < 2) { n; } else { fib(n - 1) + fib(n - 2); }"
+      U"}\n"
+      U"func down(n: Int): Int { if (n == 0) { 0; } else { down(n - 1); } }\n");
+  BytecodeModule module = BytecodeCompiler(&database).Compile();
+  JitMachine jit(&module, 64, 16);
+  REQUIRE(jit.Call(U"fib", {Value::Int32(10)}).int32 == 55);
+  REQUIRE_THROWS_WITH(jit.Call(U"fib", {Value::Int32(40)}), "stack overflow.");
+  REQUIRE(jit.Call(U"down", {Value::Int32(1000000)}).int32 == 0);
+  REQUIRE(jit.Call(U"fib", {Value::Int32(12)}).int32 == 144);
+}
+
+TEST_CASE("test jit tiering", "[JitMachine]") {
+  CompilerDatabase database;
+  database.SetSourceText(
+      "program",
+      U"func twice(x: Int): Int { x * 2; }\n"
+      U"func outer(x: Int): Int { inner(x) + 1; }\n"
+      U"func inner(x: Int): Int { x - 1; }\n"
+      U"func count(n: Int): Int {"
+      U"  var i = 0; while (i < n) { i = i + 1; } i;"
+      U"}\n"
+      U"func greet(s: String): String { s + \"!\"; }\n");
+  BytecodeModule module = BytecodeCompiler(&database).Compile();
+  JitMachine jit(&module, TierThresholds(10, 100));
+  bool supported = JitMachine::IsSupported();
+
+  for (int i = 0; i < 9; i++) {
+    REQUIRE(jit.Call(U"twice", {Value::Int32(i)}).int32 == 2 * i);
+  }
+  jit.WaitForCompilation();
+  REQUIRE_FALSE(jit.IsCompiled(U"twice"));
+  REQUIRE(jit.TierLog().empty());
+  REQUIRE(jit.Call(U"twice", {Value::Int32(9)}).int32 == 18);
+  jit.WaitForCompilation();
+  REQUIRE(jit.IsCompiled(U"twice") == supported);
+  REQUIRE(jit.Call(U"twice", {Value::Int32(21)}).int32 == 42);
+
+  /* A single call with a hot loop compiles the function for the next. */
+  REQUIRE(jit.Call(U"count", {Value::Int32(1000)}).int32 == 1000);
+  jit.WaitForCompilation();
+  REQUIRE(jit.IsCompiled(U"count") == supported);
+  REQUIRE(jit.Call(U"count", {Value::Int32(5)}).int32 == 5);
+
+  /* A callee is compiled with its caller. */
+  for (int i = 0; i < 10; i++) {
+    REQUIRE(jit.Call(U"outer", {Value::Int32(i)}).int32 == i);
+  }
+  jit.WaitForCompilation();
+  REQUIRE(jit.IsCompiled(U"inner") == supported);
+
+  for (int i = 0; i < 10; i++) {
+    REQUIRE(*jit.Call(U"greet", {Value::Text(U"hi")}).string == U"hi!");
+  }
+  REQUIRE_FALSE(jit.IsCompiled(U"greet"));
+
+  std::vector<std::string> log = jit.TierLog();
+  REQUIRE(log.back() == "greet: hot after 10 calls and 0 loop iterations, "
+                        "cannot be compiled, stays interpreted");
+  if (supported) {
+    /* 'inner' may get hot too while 'outer' compiles, so look for lines. */
+    auto logged = [&](const std::string &prefix) {
+      return std::any_of(log.begin(), log.end(), [&](const std::string &line) {
+        return line.compare(0, prefix.size(), prefix) == 0;
+      });
+    };
+    REQUIRE(log[0] == "twice: hot after 10 calls and 0 loop iterations, "
+                      "queued for compilation");
+    REQUIRE(logged("twice: compiled with 1 function into "));
+    REQUIRE(logged("count: hot after 1 calls and 100 loop iterations, "
+                   "queued for compilation"));
+    REQUIRE(logged("outer: compiled with 2 functions into "));
+  }
+}
+
+TEST_CASE("test jit on-stack replacement", "[JitMachine]") {
+  CompilerDatabase database;
+  database.SetSourceText(
+      "program",
+      U"func batch(n: Int): Int {"
+      U"  var i = 0; var total = 0; var x = 0.0;"
+      U"  while (i < n) {"
+      U"    total = total + i - total / 3; x = x + 0.5; i = i + 1;"
+      U"  }"
+      U"  if (x == 1000000.0) { total; } else { 0 - total; }"
+      U"}\n"
+      U"func twice(n: Int): Int { batch(n) + batch(n); }\n"
+      U"func nested(n: Int): Int {"
+      U"  var count = 0; var i = 2;"
+      U"  while (i < n) {"
+      U"    var j = 2; var prime = true;"
+      U"    while (j * j <= i) {"
+      U"      if (i - (i / j) * j == 0) { prime = false; }"
+      U"      j = j + 1;"
+      U"    }"
+      U"    if (prime) { count = count + 1; }"
+      U"    i = i + 1;"
+      U"  }"
+      U"  count;"
+      U"}\n"
+      U"func late(n: Int): Int {"
+      U"  var i = 0; var x = 0;"
+      U"  while (i < n) { x = x + 100 / (n - 1 - i); i = i + 1; }"
+      U"  x;"
+      U"}\n"
+      U"func text(n: Int): String {"
+      U"  var s = \"\"; var i = 0; while (i < n) { s = s + \"a\"; i = i + 1; }"
+      U"  s;"
+      U"}\n");
+  BytecodeModule module = BytecodeCompiler(&database).Compile();
+  VirtualMachine machine(&module);
+  bool supported = JitMachine::IsSupported();
+
+  /* Calls are never hot here, so only loops move code over. */
+  const std::pair<const char32_t *, int> runs[] = {
+      {U"batch", 2000000}, {U"twice", 2000000}, {U"nested", 60000}};
+  for (const auto &run : runs) {
+    JitMachine jit(&module, TierThresholds(1000000, 100));
+    jit.CompileSynchronously(true);
+    std::vector<Value> arguments{Value::Int32(run.second)};
+    INFO(Cygni::Utility::UTF32ToUTF8(run.first));
+    REQUIRE(jit.Call(run.first, arguments).int32 ==
+            machine.Call(run.first, arguments).int32);
+    std::vector<std::string> log = jit.TierLog();
+    std::string name = Cygni::Utility::UTF32ToUTF8(run.first);
+    if (run.first == std::u32string(U"twice")) {
+      name = "batch";
+    }
+    bool replaced = std::any_of(
+        log.begin(), log.end(), [&](const std::string &line) {
+          return line.find(name + ": replaced on the stack at the loop") == 0;
+        });
+    REQUIRE(replaced == supported);
+  }
+
+  JitMachine jit(&module, TierThresholds(1000000, 100));
+  REQUIRE_THROWS_WITH(jit.Call(U"late", {Value::Int32(1000000)}),
+                      "division by zero.");
+  REQUIRE(*jit.Call(U"text", {Value::Int32(1000)}).string ==
+          std::u32string(1000, U'a'));
+  REQUIRE(jit.TierLog().back() ==
+          "text: hot after 1 calls and 100 loop iterations, "
+          "cannot be compiled, stays interpreted");
+}
@@ -0,0 +1,96 @@
+#ifndef CYGNI_TESTS_TEST_PROGRAMS_HPP
+#define CYGNI_TESTS_TEST_PROGRAMS_HPP
+
+namespace Cygni {
+namespace Tests {
+
+/* Programs run by every execution engine, so the closure interpreter, the
+ * virtual machine, the register machine and the JIT are tested on the same
+ * source. */
+
+/* Recursion, loops, strings, doubles, nested scopes, division and a
+ * recursion deep enough to overflow any stack. */
+constexpr const char32_t *BasicProgram =
+    U"func fib(n: Int): Int {"
+    U"  if (n < 2) { n; } else { fib(n - 1) + fib(n - 2); }"
+    U"}\n"
+    U"func sum(n: Int): Int {"
+    U"  var total = 0; var i = 0;"
+    U"  while (i < n) { total = total + i; i = i + 1; }"
+    U"  total;"
+    U"}\n"
+    U"func repeat(s: String, n: Int): String {"
+    U"  var result = \"\"; var i = 0;"
+    U"  while (i < n) { result = result + s; i = i + 1; }"
+    U"  result;"
+    U"}\n"
+    U"func half(x: Double): Double { x / 2.0; }\n"
+    U"func same(a: String, b: String): Bool { a == b; }\n"
+    U"func divide(a: Int, b: Int): Int { a / b; }\n"
+    U"func scoped(x: Int): Int {"
+    U"  var a = x; { var b = a * 2; a = b; }; { var c = a + 1; a = c; };"
+    U"  a;"
+    U"}\n"
+    U"func ack(m: Int, n: Int): Int {"
+    U"  if (m == 0) { n + 1; } else {"
+    U"    if (n == 0) { ack(m - 1, 1); } else { ack(m - 1, ack(m, n - 1)); }"
+    U"  }"
+    U"}\n"
+    U"func deep(n: Int): Int { deep(n + 1) + 1; }\n";
+
+/* Calls in tail position, some of them in nested blocks, and one that is
+ * not. */
+constexpr const char32_t *TailCallProgram =
+    U"func sum(n: Int, total: Int): Int {"
+    U"  if (n == 0) { total; } else { sum(n - 1, total + 3); }"
+    U"}\n"
+    U"func even(n: Int): Bool {"
+    U"  if (n == 0) { true; } else { odd(n - 1); }"
+    U"}\n"
+    U"func odd(n: Int): Bool {"
+    U"  if (n == 0) { false; } else { even(n - 1); }"
+    U"}\n"
+    U"func last(n: Int): Int { var x = n; { x = x + 1; count(x); }; }\n"
+    U"func count(n: Int): Int { n; }\n"
+    U"func around(n: Int): Int { count(n) + 1; }\n";
+
+/* Arithmetic and comparisons on every basic type, and nested loops. */
+constexpr const char32_t *TypedProgram =
+    U"func mix(a: Long, b: Long): Long { (a * b - a) / b + a; }\n"
+    U"func order(a: Long, b: Long): Bool {"
+    U"  (a < b) == (a <= b) == (a != b);"
+    U"}\n"
+    U"func quotient(a: Long, b: Long): Long { a / b; }\n"
+    U"func scale(a: Float, b: Float): Float { a * b - a / b; }\n"
+    U"func smaller(a: Float, b: Float): Bool { a < b; }\n"
+    U"func before(a: Char, b: Char): Bool { a < b; }\n"
+    U"func flip(b: Bool): Bool { (b == false) != b; }\n"
+    U"func collatz(n: Int): Int {"
+    U"  var steps = 0; var x = n;"
+    U"  while (x != 1) {"
+    U"    if (x - (x / 2) * 2 == 0) { x = x / 2; } else { x = 3 * x + 1; }"
+    U"    steps = steps + 1;"
+    U"  }"
+    U"  steps;"
+    U"}\n"
+    U"func grid(n: Int): Int {"
+    U"  var total = 0; var i = 0;"
+    U"  while (i < n) {"
+    U"    var j = 0;"
+    U"    while (j < n) {"
+    U"      if (i >= j) { total = total + i * j; }"
+    U"      if (i > j) { total = total - 1; }"
+    U"      j = j + 1;"
+    U"    }"
+    U"    i = i + 1;"
+    U"  }"
+    U"  total;"
+    U"}\n"
+    U"func area(r: Double): Double {"
+    U"  var result = 0.0; if (r > 0.0) { result = r * r * 3.0; } result;"
+    U"}\n";
+
+}; /* namespace Tests */
+}; /* namespace Cygni */
+
+#endif /* CYGNI_TESTS_TEST_PROGRAMS_HPP */
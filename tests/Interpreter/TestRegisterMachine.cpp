@@ -0,0 +1,73 @@
+#include <catch2/catch.hpp>
+
+#include "Driver/CompilerDatabase.hpp"
+#include "Interpreter/RegisterCompiler.hpp"
+#include "Interpreter/RegisterMachine.hpp"
+#include "TestPrograms.hpp"
+
+using namespace Cygni::Driver;
+using namespace Cygni::Interpreter;
+using namespace Cygni::Tests;
+
+TEST_CASE("test register compiler", "[RegisterMachine]") {
+  CompilerDatabase database;
+  database.SetSourceText(
+      "program",
+      U"func count(n: Int): Int {"
+      U"  var i = 0; while (i < n) { i = i + 1; } i;"
+      U"}\n");
+  RegisterModule module = RegisterCompiler(&database).Compile();
+  const RegisterFunction &count = module.functions.at(0);
+  REQUIRE(count.frameSize == 2);
+  REQUIRE(count.registerCount == 3);
+  REQUIRE(Disassemble(count) == "0: LoadConstant r1 k0 (0)\n"
+                                "1: LessThan r2 r1 r0\n"
+                                "2: JumpIfFalse r2 5\n"
+                                "3: AddConstant r1 r1 k1 (1)\n"
+                                "4: Jump 1\n"
+                                "5: Return r1\n");
+
+  RegisterMachine machine(&module);
+  machine.CountInstructions(true);
+  REQUIRE(machine.Call(U"count", {Value::Int32(10)}).int32 == 10);
+  REQUIRE(machine.InstructionCount() == 1 + 10 * 4 + 3);
+}
+
+TEST_CASE("test register machine", "[RegisterMachine]") {
+  CompilerDatabase database;
+  database.SetSourceText(
+      "program",
+      std::u32string(BasicProgram) +
+          U"func nested(a: Int, b: Int): Int {"
+          U"  (a * 3 + b * 7 - (a / 3) * 2) / 5 + { var c = a; c = c + b; c; };"
+          U"}\n"
+          U"func pick(x: Int): Int {"
+          U"  var y = 0; if (x > 0) { y = x; } else { y = 0 - x; } y;"
+          U"}\n");
+  RegisterModule module = RegisterCompiler(&database).Compile();
+  RegisterMachine machine(&module);
+
+  REQUIRE(machine.Call(U"fib", {Value::Int32(20)}).int32 == 6765);
+  REQUIRE(machine.Call(U"sum", {Value::Int32(100)}).int32 == 4950);
+  Value repeated =
+      machine.Call(U"repeat", {Value::Text(U"ab"), Value::Int32(3)});
+  REQUIRE(repeated.type == TypeCode::String);
+  REQUIRE(*repeated.string == U"ababab");
+  REQUIRE(machine.Call(U"half", {Value::Float64(5.0)}).float64 == 2.5);
+  REQUIRE(machine.Call(U"same", {Value::Text(U"x"), Value::Text(U"x")})
+              .ToString() == "true");
+  REQUIRE(machine.Call(U"scoped", {Value::Int32(3)}).int32 == 7);
+  REQUIRE(machine.Call(U"divide", {Value::Int32(7), Value::Int32(2)}).int32 ==
+          3);
+  REQUIRE_THROWS_WITH(
+      machine.Call(U"divide", {Value::Int32(7), Value::Int32(0)}),
+      "division by zero.");
+  REQUIRE_THROWS_WITH(machine.Call(U"fib", {Value::Text(U"x")}),
+                      "argument 0 type mismatch error.");
+  REQUIRE_THROWS_WITH(machine.Call(U"deep", {Value::Int32(0)}),
+                      "stack overflow.");
+  REQUIRE(machine.Call(U"fib", {Value::Int32(10)}).int32 == 55);
+  REQUIRE(machine.Call(U"nested", {Value::Int32(9), Value::Int32(4)}).int32 ==
+          (9 * 3 + 4 * 7 - (9 / 3) * 2) / 5 + 13);
+  REQUIRE(machine.Call(U"pick", {Value::Int32(-5)}).int32 == 5);
+}
@@ -0,0 +1,211 @@
+#include <catch2/catch.hpp>
+
+#include "Driver/CompilerDatabase.hpp"
+#include "Interpreter/BytecodeCompiler.hpp"
+#include "Interpreter/VirtualMachine.hpp"
+#include "TestPrograms.hpp"
+
+using namespace Cygni::Driver;
+using namespace Cygni::Interpreter;
+using namespace Cygni::Tests;
+
+TEST_CASE("test bytecode operands", "[VirtualMachine]") {
+  std::vector<uint8_t> code;
+  for (uint32_t operand : {0u, 127u, 128u, 300u, 1u << 20}) {
+    WriteOperand(code, operand);
+  }
+  REQUIRE(code.size() == 1 + 1 + 2 + 2 + 3);
+  const uint8_t *ip = code.data();
+  for (uint32_t operand : {0u, 127u, 128u, 300u, 1u << 20}) {
+    REQUIRE(ReadOperand(ip) == operand);
+  }
+  REQUIRE(ip == code.data() + code.size());
+}
+
+TEST_CASE("test bytecode compiler", "[VirtualMachine]") {
+  CompilerDatabase database;
+  database.SetSourceText(
+      "program",
+      U"func count(n: Int): Int {"
+      U"  var i = 0; while (i < n) { i = i + 1; } i;"
+      U"}\n");
+  BytecodeModule module = BytecodeCompiler(&database).Compile();
+  const BytecodeFunction &count = module.functions.at(0);
+  REQUIRE(count.parameterCount == 1);
+  REQUIRE(count.frameSize == 2);
+  REQUIRE(count.maxStack == 2);
+  REQUIRE(Disassemble(count) == "0: PushConstant 0 (0)\n"
+                                "2: StoreLocal 1\n"
+                                "4: LoadLocal 1\n"
+                                "6: LoadLocal 0\n"
+                                "8: LessThanInt32\n"
+                                "9: JumpIfFalse 26\n"
+                                "14: LoadLocal 1\n"
+                                "16: PushConstant 1 (1)\n"
+                                "18: AddInt32\n"
+                                "19: StoreLocal 1\n"
+                                "21: Jump 4\n"
+                                "26: LoadLocal 1\n"
+                                "28: Return\n");
+
+  VirtualMachine machine(&module);
+  machine.CountInstructions(true);
+  REQUIRE(machine.Call(U"count", {Value::Int32(10)}).int32 == 10);
+  REQUIRE(machine.InstructionCount() == 2 + 10 * 3 + 1 + 2);
+
+  SequenceProfile profile;
+  machine.ProfileSequences(&profile);
+  for (const Superinstruction &superinstruction : Superinstructions()) {
+    machine.UseSuperinstruction(superinstruction.opCode, false);
+  }
+  REQUIRE(machine.Call(U"count", {Value::Int32(10)}).int32 == 10);
+  REQUIRE(machine.InstructionCount() == 35 + 2 + 10 * 9 + 4 + 2);
+  std::vector<OpCodeSequence> top = profile.Top(4, 1);
+  REQUIRE(top.at(0).opCodes ==
+          std::vector<OpCode>{OpCode::LoadLocal, OpCode::LoadLocal,
+                              OpCode::LessThanInt32, OpCode::JumpIfFalse});
+  REQUIRE(top.at(0).count == 11);
+
+  machine.CountInstructions(false);
+  REQUIRE(machine.Call(U"count", {Value::Int32(5)}).int32 == 5);
+  REQUIRE(machine.InstructionCount() == 133);
+}
+
+TEST_CASE("test virtual machine", "[VirtualMachine]") {
+  CompilerDatabase database;
+  database.SetSourceText("program", BasicProgram);
+  BytecodeModule module = BytecodeCompiler(&database).Compile();
+  VirtualMachine machine(&module);
+
+  REQUIRE(machine.Call(U"fib", {Value::Int32(20)}).int32 == 6765);
+  REQUIRE(machine.Call(U"sum", {Value::Int32(100)}).int32 == 4950);
+  Value repeated =
+      machine.Call(U"repeat", {Value::Text(U"ab"), Value::Int32(3)});
+  REQUIRE(repeated.type == TypeCode::String);
+  REQUIRE(*repeated.string == U"ababab");
+  REQUIRE(machine.Call(U"half", {Value::Float64(5.0)}).float64 == 2.5);
+  REQUIRE(machine.Call(U"same", {Value::Text(U"x"), Value::Text(U"x")})
+              .ToString() == "true");
+  REQUIRE(machine.Call(U"scoped", {Value::Int32(3)}).int32 == 7);
+  REQUIRE(machine.Call(U"divide", {Value::Int32(7), Value::Int32(2)}).int32 ==
+          3);
+  REQUIRE_THROWS_WITH(
+      machine.Call(U"divide", {Value::Int32(7), Value::Int32(0)}),
+      "division by zero.");
+  REQUIRE_THROWS_WITH(machine.Call(U"fib", {Value::Text(U"x")}),
+                      "argument 0 type mismatch error.");
+  REQUIRE_THROWS_WITH(machine.Call(U"deep", {Value::Int32(0)}),
+                      "stack overflow.");
+  REQUIRE(machine.Call(U"fib", {Value::Int32(10)}).int32 == 55);
+}
+
+TEST_CASE("test quickening", "[VirtualMachine]") {
+  BytecodeFunction add;
+  add.name = U"add";
+  add.parameterCount = 2;
+  add.frameSize = 2;
+  add.maxStack = 2;
+  add.parameterTypes = {TypeCode::Union, TypeCode::Union};
+  add.returnType = TypeCode::Union;
+  for (uint32_t slot : {0u, 1u}) {
+    add.code.push_back(static_cast<uint8_t>(OpCode::LoadLocal));
+    WriteOperand(add.code, slot);
+  }
+  add.code.push_back(static_cast<uint8_t>(OpCode::Add));
+  add.code.push_back(static_cast<uint8_t>(OpCode::Return));
+  BytecodeModule module;
+  module.functions.push_back(add);
+  module.functionNumbers[U"add"] = 0;
+  VirtualMachine machine(&module);
+
+  REQUIRE(machine.Call(U"add", {Value::Int32(1), Value::Int32(2)}).int32 == 3);
+  REQUIRE(machine.Quickenings() == 1);
+  REQUIRE(machine.Call(U"add", {Value::Int32(3), Value::Int32(4)}).int32 == 7);
+  REQUIRE(machine.Quickenings() == 1);
+  REQUIRE(machine.Deoptimizations() == 0);
+  Value sum = machine.Call(U"add", {Value::Float64(0.5), Value::Float64(2)});
+  REQUIRE(sum.type == TypeCode::Float64);
+  REQUIRE(sum.float64 == 2.5);
+  REQUIRE(machine.Deoptimizations() == 1);
+  REQUIRE(machine.Quickenings() == 2);
+  Value text = machine.Call(U"add", {Value::Text(U"a"), Value::Text(U"b")});
+  REQUIRE(*text.string == U"ab");
+  REQUIRE(machine.Deoptimizations() == 2);
+  REQUIRE(machine.Quickenings() == 2);
+}
+
+TEST_CASE("test inline caches", "[VirtualMachine]") {
+  CompilerDatabase database;
+  database.SetSourceText(
+      "program",
+      U"func twice(x: Int): Int { x * 2; }\n"
+      U"func square(x: Int): Int { x * x; }\n"
+      U"func inc(x: Int): Int { x + 1; }\n"
+      U"func dec(x: Int): Int { x - 1; }\n"
+      U"func zero(x: Int): Int { 0; }\n"
+      U"func mono(n: Int): Int {"
+      U"  var f = twice; var total = 0; var i = 0;"
+      U"  while (i < n) { total = total + f(i); i = i + 1; }"
+      U"  total;"
+      U"}\n"
+      U"func poly(n: Int): Int {"
+      U"  var f = twice; var total = 0; var i = 0;"
+      U"  while (i < n) {"
+      U"    if (i == 5) { f = square; }"
+      U"    total = total + f(i); i = i + 1;"
+      U"  }"
+      U"  total;"
+      U"}\n"
+      U"func mega(n: Int): Int {"
+      U"  var f = twice; var total = 0; var i = 0;"
+      U"  while (i < n) {"
+      U"    var k = i - (i / 5) * 5;"
+      U"    if (k == 0) { f = twice; } if (k == 1) { f = square; }"
+      U"    if (k == 2) { f = inc; } if (k == 3) { f = dec; }"
+      U"    if (k == 4) { f = zero; }"
+      U"    total = total + f(i); i = i + 1;"
+      U"  }"
+      U"  total;"
+      U"}\n");
+  BytecodeModule module = BytecodeCompiler(&database).Compile();
+  VirtualMachine machine(&module);
+
+  REQUIRE(machine.Call(U"mono", {Value::Int32(10)}).int32 == 90);
+  REQUIRE(machine.CacheMisses() == 1);
+  REQUIRE(machine.CacheHits() == 9);
+
+  REQUIRE(machine.Call(U"poly", {Value::Int32(10)}).int32 ==
+          20 + 25 + 36 + 49 + 64 + 81);
+  REQUIRE(machine.CacheMisses() == 3);
+  REQUIRE(machine.CacheHits() == 17);
+  REQUIRE(machine.MegamorphicTransitions() == 0);
+
+  REQUIRE(machine.Call(U"mega", {Value::Int32(10)}).int32 ==
+          (0 + 1 + 3 + 2 + 0) + (10 + 36 + 8 + 7 + 0));
+  REQUIRE(machine.CacheMisses() == 3 + 6);
+  REQUIRE(machine.CacheHits() == 17 + 4);
+  REQUIRE(machine.MegamorphicTransitions() == 1);
+}
+
+TEST_CASE("test tail calls", "[VirtualMachine]") {
+  CompilerDatabase database;
+  database.SetSourceText("program", TailCallProgram);
+  BytecodeModule module = BytecodeCompiler(&database).Compile();
+  auto numberOf = [&](const std::u32string &name) {
+    return module.functionNumbers.at(name);
+  };
+  std::string sum = Disassemble(module.functions.at(numberOf(U"sum")));
+  REQUIRE(sum.find("TailCall") != std::string::npos);
+  REQUIRE(Disassemble(module.functions.at(numberOf(U"last")))
+              .find("TailCall") != std::string::npos);
+  REQUIRE(Disassemble(module.functions.at(numberOf(U"around")))
+              .find("TailCall") == std::string::npos);
+
+  VirtualMachine machine(&module, 64, 16);
+  REQUIRE(machine.Call(U"sum", {Value::Int32(700000), Value::Int32(0)})
+              .int32 == 2100000);
+  REQUIRE(machine.Call(U"even", {Value::Int32(100001)}).ToString() ==
+          "false");
+  REQUIRE(machine.Call(U"last", {Value::Int32(4)}).int32 == 5);
+  REQUIRE(machine.Call(U"around", {Value::Int32(4)}).int32 == 5);
+}
@@ -0,0 +1,30 @@
+#include <catch2/catch.hpp>
+
+#include "Utility/FlatMap.hpp"
+
+using namespace Cygni::Utility;
+
+TEST_CASE("flat map insert and find", "[FlatMap]") {
+  FlatMap<int> map;
+
+  for (int i = 0; i < 1000; i++) {
+    REQUIRE(map.Insert(U"name" + std::u32string(i % 10 + 1, U'a') +
+                           std::u32string(i / 10 + 1, U'b'),
+                       i));
+  }
+  REQUIRE(map.Size() == 1000);
+  REQUIRE_FALSE(map.Insert(U"nameab", -1));
+  REQUIRE(map.At(U"nameab") == 0);
+  REQUIRE(map.At(U"nameaaabb") == 12);
+  REQUIRE(map.Find(U"name") == nullptr);
+  REQUIRE_THROWS(map.At(U"name"));
+
+  int sum = 0;
+  map.ForEach([&sum](const std::u32string &key, int value) { sum += value; });
+  REQUIRE(sum == 999 * 1000 / 2);
+}
+
+TEST_CASE("continued name hashes", "[FlatMap]") {
+  REQUIRE(HashName(U"c", HashName(U"a.b.")) == HashName(U"a.b.c"));
+  REQUIRE(HashName(U"a.b") != HashName(U"a.c"));
+}
@@ -0,0 +1,78 @@
+#include <catch2/catch.hpp>
+
+#include "LexicalAnalysis/Lexer.hpp"
+#include "SyntaxAnalysis/Parser.hpp"
+#include "Visitors/HirLowering.hpp"
+
+using namespace Cygni::LexicalAnalysis;
+using namespace Cygni::SyntaxAnalysis;
+using namespace Cygni::Expressions;
+using namespace Cygni::Visitors;
+using namespace Cygni::HighLevelIR;
+
+TEST_CASE("test lowering implicit conversions", "[HIR]") {
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("source-code-file");
+
+  Lexer lexer(sourceCodeFile,
+              U"func f(x: Int, c: Char): Int { "
+              U"var u = { if (x < x) { x; } else { c; } }; u = x; x; }");
+
+  std::vector<Token> tokens = lexer.ReadAll();
+  Parser parser(tokens, sourceCodeFile);
+  auto exp = parser.FunctionDeclarationStatement();
+
+  NameResolver resolver;
+  Scope<const Expression *> resolverScope;
+  resolver.Visit(exp, &resolverScope);
+
+  TypeChecker typeChecker(&resolver.Bindings());
+  Scope<const Type *> typeScope;
+  typeChecker.Visit(exp, &typeScope);
+
+  NameLocator nameLocator(&resolver.Bindings());
+  Scope<NameInfo> nameScope;
+  nameLocator.Visit(exp, &nameScope);
+
+  HirFactory factory;
+  HirLowering lowering(factory, typeChecker, nameLocator.NameInfoTable(),
+                       resolver.Bindings());
+  const HirNode *hir = lowering.Visit(exp);
+
+  REQUIRE(hir->NodeType() == ExpressionType::Lambda);
+  auto lambda = static_cast<const HirLambda *>(hir);
+  REQUIRE(lambda->GetType()->GetTypeCode() == TypeCode::Callable);
+  REQUIRE(lambda->Parameters().size() == 2);
+  REQUIRE(lambda->Parameters().at(1)->GetType()->GetTypeCode() ==
+          TypeCode::Char);
+  REQUIRE(lambda->Parameters().at(1)->Location().number == 1);
+
+  auto body = static_cast<const HirBlock *>(lambda->Body());
+  REQUIRE(body->Expressions().size() == 3);
+
+  auto declaration =
+      static_cast<const HirVariableDeclaration *>(body->Expressions().at(0));
+  REQUIRE(declaration->VariableType()->GetTypeCode() == TypeCode::Union);
+  REQUIRE(declaration->Location().kind == LocationKind::FunctionVariable);
+  REQUIRE(declaration->Location().number == 2);
+
+  auto block = static_cast<const HirBlock *>(declaration->Initializer());
+  auto conditional =
+      static_cast<const HirConditional *>(block->Expressions().at(0));
+  REQUIRE(conditional->IfTrue()->NodeType() == ExpressionType::Convert);
+  REQUIRE(conditional->IfFalse()->NodeType() == ExpressionType::Convert);
+  REQUIRE(conditional->IfTrue()->GetType()->GetTypeCode() == TypeCode::Union);
+
+  auto assign = static_cast<const HirBinary *>(body->Expressions().at(1));
+  REQUIRE(assign->NodeType() == ExpressionType::Assign);
+  auto target = static_cast<const HirVariable *>(assign->Left());
+  REQUIRE(target->Declaration() == declaration);
+  REQUIRE(target->Depth() == 1);
+  REQUIRE(assign->Right()->NodeType() == ExpressionType::Convert);
+  auto convert = static_cast<const HirUnary *>(assign->Right());
+  REQUIRE(convert->Operand()->GetType()->GetTypeCode() == TypeCode::Int32);
+  REQUIRE(static_cast<const HirVariable *>(convert->Operand())
+              ->Declaration() == lambda->Parameters().at(0));
+
+  REQUIRE(body->Expressions().at(2)->NodeType() == ExpressionType::Parameter);
+}
@@ -0,0 +1,90 @@
+#include <catch2/catch.hpp>
+
+#include <list>
+#include "LexicalAnalysis/Lexer.hpp"
+#include "SyntaxAnalysis/Parser.hpp"
+#include "Visitors/IncrementalTypeChecker.hpp"
+
+using namespace Cygni::LexicalAnalysis;
+using namespace Cygni::SyntaxAnalysis;
+using namespace Cygni::Expressions;
+using namespace Cygni::Visitors;
+
+class EditSession {
+private:
+  std::shared_ptr<SourceCodeFile> sourceCodeFile;
+  std::list<Parser> parsers;
+
+public:
+  EditSession()
+      : sourceCodeFile{std::make_shared<SourceCodeFile>("source-code-file")} {}
+
+  const LambdaExpression *Parse(const std::u32string &code) {
+    Lexer lexer(sourceCodeFile, code);
+    parsers.emplace_back(lexer.ReadAll(), sourceCodeFile);
+    return static_cast<const LambdaExpression *>(
+        parsers.back().FunctionDeclarationStatement());
+  }
+};
+
+TEST_CASE("test incremental type checking", "[IncrementalTypeChecker]") {
+  EditSession session;
+  IncrementalTypeChecker checker;
+
+  checker.SetFunction(session.Parse(U"func f(x: Int): Int { g(x) + 1; }"));
+  checker.SetFunction(session.Parse(U"func g(x: Int): Int { x * 2; }"));
+  checker.SetFunction(session.Parse(U"func h(c: Char): Char { c; }"));
+  REQUIRE(checker.Check() == 3);
+  REQUIRE(checker.Result(U"f").diagnostic.empty());
+  REQUIRE(checker.Result(U"f").dependencies ==
+          std::vector<std::u32string>{U"g"});
+
+  SECTION("body edits re-check only the edited function") {
+    checker.SetFunction(session.Parse(U"func g(x: Int): Int { x * 3; }"));
+    REQUIRE(checker.Check() == 1);
+    REQUIRE(checker.Check() == 0);
+  }
+
+  SECTION("signature edits re-check the callers") {
+    const LambdaExpression *h = checker.Result(U"h").function;
+    const Type *hType = checker.Result(U"h").nodeTypes.at(h);
+    checker.SetFunction(session.Parse(U"func g(x: Int): Char { 'c'; }"));
+    REQUIRE(checker.Check() == 2);
+    REQUIRE(checker.Result(U"f").diagnostic == "type mismatch error.");
+    REQUIRE(checker.Result(U"h").nodeTypes.at(h) == hType);
+  }
+
+  SECTION("removing and adding functions re-checks their callers") {
+    checker.Remove(U"g");
+    REQUIRE(checker.Check() == 1);
+    REQUIRE(checker.Result(U"f").diagnostic == "'g' not defined.");
+    checker.SetFunction(session.Parse(U"func g(x: Int): Int { x; }"));
+    REQUIRE(checker.Check() == 2);
+    REQUIRE(checker.Result(U"f").diagnostic.empty());
+  }
+}
+
+TEST_CASE("test incremental global variables", "[IncrementalTypeChecker]") {
+  EditSession session;
+  IncrementalTypeChecker checker;
+  ExpressionFactory factory;
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("source-code-file");
+  SourceRange range(sourceCodeFile, 1, 1, 1, 1);
+
+  checker.SetGlobalVariable(factory.Create<ParameterExpression>(
+      range, U"limit", TypeFactory::CreateBasicType(TypeCode::Int32)));
+  checker.SetFunction(
+      session.Parse(U"func k(x: Int): Bool { x < limit; }"));
+  REQUIRE(checker.Check() == 1);
+  REQUIRE(checker.Result(U"k").diagnostic.empty());
+
+  checker.SetGlobalVariable(factory.Create<ParameterExpression>(
+      range, U"limit", TypeFactory::CreateBasicType(TypeCode::Int32)));
+  REQUIRE(checker.Check() == 0);
+
+  checker.SetGlobalVariable(factory.Create<ParameterExpression>(
+      range, U"limit", TypeFactory::CreateBasicType(TypeCode::String)));
+  REQUIRE(checker.Check() == 1);
+  REQUIRE_FALSE(checker.Result(U"k").diagnostic.empty());
+}
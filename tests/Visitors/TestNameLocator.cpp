@@ -98,4 +98,95 @@ TEST_CASE("test variable locating", "[Variable]") {
   REQUIRE(checkedX);
   REQUIRE(checkedY);
   REQUIRE(checkedZ);
-}
\ No newline at end of file
+}
+TEST_CASE("test constant pools", "[Constant]") {
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("source-code-file");
+
+  Lexer firstLexer(sourceCodeFile,
+                   U"func f(x: Int): Int { var s = \"ab\"; var t = \"ab\"; "
+                   U"if (x > 42) { 42 + 7 * 42; } else { 7; } "
+                   U"var c = '1'; var d = '1'; var e = 007; "
+                   U"var p = 1.5; var q = 1.50; 1; }");
+  std::vector<Token> firstTokens = firstLexer.ReadAll();
+  Parser firstParser(firstTokens, sourceCodeFile);
+  auto first = static_cast<const LambdaExpression *>(
+      firstParser.FunctionDeclarationStatement());
+
+  Lexer secondLexer(sourceCodeFile,
+                    U"func g(): String { var s = \"cd\"; \"ab\"; }");
+  std::vector<Token> secondTokens = secondLexer.ReadAll();
+  Parser secondParser(secondTokens, sourceCodeFile);
+  auto second = static_cast<const LambdaExpression *>(
+      secondParser.FunctionDeclarationStatement());
+
+  Scope<NameInfo> scope;
+  NameLocator nameLocator;
+  nameLocator.Visit(first, &scope);
+  nameLocator.Visit(second, &scope);
+
+  const ConstantPool &constants =
+      nameLocator.FunctionFrames().at(first).constants;
+  REQUIRE(constants.Size() == 5);
+  REQUIRE(constants.Constants().at(0)->GetTypeCode() == TypeCode::Int32);
+  REQUIRE(constants.Constants().at(2)->GetTypeCode() == TypeCode::Char);
+  REQUIRE(constants.Constants().at(3)->GetTypeCode() == TypeCode::Float64);
+  REQUIRE(constants.Constants().at(4)->GetTypeCode() == TypeCode::Int32);
+  REQUIRE(nameLocator.FunctionFrames().at(first).frameSize == 8);
+  REQUIRE(nameLocator.FunctionFrames().at(second).constants.Size() == 0);
+
+  for (const auto &item : nameLocator.NameInfoTable()) {
+    if (item.first->NodeType() == ExpressionType::Constant) {
+      REQUIRE(static_cast<const ConstantExpression *>(item.first)
+                  ->GetTypeCode() != TypeCode::String);
+    }
+  }
+}
+
+TEST_CASE("test slot reuse", "[Variable]") {
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("source-code-file");
+
+  Lexer lexer(sourceCodeFile,
+              U"func f(x: Int): Int { var a = x; "
+              U"{ var b = a; var c = b; }; "
+              U"while (x < 10) { var d = x; x = d + 1; } "
+              U"{ var e = a; }; var f = a; f; }");
+  std::vector<Token> tokens = lexer.ReadAll();
+  Parser parser(tokens, sourceCodeFile);
+  auto exp = static_cast<const LambdaExpression *>(
+      parser.FunctionDeclarationStatement());
+
+  Scope<NameInfo> scope;
+  NameLocator nameLocator;
+  nameLocator.Visit(exp, &scope);
+
+  std::unordered_map<std::u32string, int> slots;
+  for (const auto &item : nameLocator.NameInfoTable()) {
+    if (item.first->NodeType() == ExpressionType::VariableDeclaration) {
+      auto declaration =
+          static_cast<const VariableDeclarationExpression *>(item.first);
+      slots[declaration->Name()] = item.second.number;
+    }
+  }
+  REQUIRE(slots.at(U"a") == 1);
+  REQUIRE(slots.at(U"b") == 2);
+  REQUIRE(slots.at(U"c") == 3);
+  REQUIRE(slots.at(U"d") == 2);
+  REQUIRE(slots.at(U"e") == 2);
+  REQUIRE(slots.at(U"f") == 2);
+  REQUIRE(nameLocator.FunctionFrames().at(exp).frameSize == 4);
+
+  NameResolver resolver;
+  Scope<const Expression *> resolverScope;
+  resolver.Visit(exp, &resolverScope);
+  NameLocator fusedNameLocator(&resolver.Bindings());
+  PassManager passManager;
+  passManager.Add(&fusedNameLocator);
+  passManager.Run(exp);
+  for (const auto &item : nameLocator.NameInfoTable()) {
+    REQUIRE(fusedNameLocator.NameInfoTable().at(item.first).number ==
+            item.second.number);
+  }
+  REQUIRE(fusedNameLocator.FunctionFrames().at(exp).frameSize == 4);
+}
@@ -0,0 +1,155 @@
+#include <catch2/catch.hpp>
+
+#include "LexicalAnalysis/Lexer.hpp"
+#include "SyntaxAnalysis/Parser.hpp"
+#include "Visitors/NameResolver.hpp"
+#include "Visitors/NameLocator.hpp"
+#include "Visitors/TypeChecker.hpp"
+
+using namespace Cygni::LexicalAnalysis;
+using namespace Cygni::SyntaxAnalysis;
+using namespace Cygni::Expressions;
+using namespace Cygni::Visitors;
+
+TEST_CASE("test binding shadowed variables", "[Binding]") {
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("source-code-file");
+
+  Lexer lexer(sourceCodeFile, U"func f(x: Int, y: Int): Int { var z = x; "
+                              U"{ var x = y; x; }; x + y + z; }");
+
+  std::vector<Token> tokens = lexer.ReadAll();
+  Parser parser(tokens, sourceCodeFile);
+  auto exp = parser.FunctionDeclarationStatement();
+
+  NameResolver resolver;
+  Scope<const Expression *> scope;
+  resolver.Visit(exp, &scope);
+
+  int uses = 0;
+  for (const auto &item : resolver.Bindings()) {
+    if (item.first == item.second.declaration) {
+      continue;
+    }
+    REQUIRE(item.first->NodeType() == ExpressionType::Parameter);
+    auto use = static_cast<const ParameterExpression *>(item.first);
+    const Binding &binding = item.second;
+    REQUIRE(binding.depth == 1);
+    if (binding.declaration->NodeType() == ExpressionType::Parameter) {
+      auto parameter =
+          static_cast<const ParameterExpression *>(binding.declaration);
+      REQUIRE(parameter->Name() == use->Name());
+      REQUIRE(binding.slot == (use->Name() == U"x" ? 0 : 1));
+    } else {
+      REQUIRE(binding.declaration->NodeType() ==
+              ExpressionType::VariableDeclaration);
+      auto declaration =
+          static_cast<const VariableDeclarationExpression *>(
+              binding.declaration);
+      REQUIRE(declaration->Name() == use->Name());
+      REQUIRE(binding.slot == (use->Name() == U"z" ? 2 : 3));
+    }
+    uses++;
+  }
+  REQUIRE(uses == 6);
+
+  TypeChecker typeChecker(&resolver.Bindings());
+  Scope<const Type *> typeScope;
+  const Type *type = typeChecker.Visit(exp, &typeScope);
+  REQUIRE(type->GetTypeCode() == TypeCode::Callable);
+  REQUIRE(static_cast<const CallableType *>(type)
+              ->GetReturnType()
+              ->GetTypeCode() == TypeCode::Int32);
+
+  NameLocator nameLocator(&resolver.Bindings());
+  Scope<NameInfo> nameScope;
+  nameLocator.Visit(exp, &nameScope);
+  for (const auto &item : resolver.Bindings()) {
+    REQUIRE(nameLocator.NameInfoTable().at(item.first).number ==
+            item.second.slot);
+  }
+}
+
+TEST_CASE("test binding slots of sibling blocks", "[Binding]") {
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("source-code-file");
+
+  Lexer lexer(sourceCodeFile,
+              U"func f(x: Int): Int { var a = x; { var b = a; a = b; }; "
+              U"{ var c = a; a = c; }; while (a < 9) { var d = a; a = d + 1; } "
+              U"a; }");
+
+  std::vector<Token> tokens = lexer.ReadAll();
+  Parser parser(tokens, sourceCodeFile);
+  auto exp = parser.FunctionDeclarationStatement();
+
+  NameResolver resolver;
+  Scope<const Expression *> scope;
+  resolver.Visit(exp, &scope);
+  NameLocator nameLocator(&resolver.Bindings());
+  Scope<NameInfo> nameScope;
+  nameLocator.Visit(exp, &nameScope);
+
+  int reused = 0;
+  for (const auto &item : resolver.Bindings()) {
+    REQUIRE(nameLocator.NameInfoTable().at(item.first).number ==
+            item.second.slot);
+    if (item.first == item.second.declaration && item.second.slot == 2) {
+      reused++;
+    }
+  }
+  REQUIRE(reused == 3);
+}
+
+TEST_CASE("test binding undefined variable", "[Binding]") {
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("source-code-file");
+
+  Lexer lexer(sourceCodeFile, U"{ { var a = 1; }; a; }");
+
+  std::vector<Token> tokens = lexer.ReadAll();
+  Parser parser(tokens, sourceCodeFile);
+  auto exp = parser.ParseBlock();
+
+  NameResolver resolver;
+  Scope<const Expression *> scope;
+  REQUIRE_THROWS_AS(resolver.Visit(exp, &scope), TreeException);
+}
+
+TEST_CASE("test binding free names", "[Binding]") {
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("source-code-file");
+
+  Lexer lexer(sourceCodeFile, U"func f(x: Int): Int { var a = g(x); "
+                              U"{ var g = h(a); }; g(h(a)) + k; }");
+
+  std::vector<Token> tokens = lexer.ReadAll();
+  Parser parser(tokens, sourceCodeFile);
+  auto exp = parser.FunctionDeclarationStatement();
+
+  NameResolver resolver;
+  resolver.CollectFreeNames();
+  Scope<const Expression *> scope;
+  resolver.Visit(exp, &scope);
+  REQUIRE(resolver.FreeNames() ==
+          std::vector<std::u32string>{U"g", U"h", U"k"});
+  for (const auto &item : resolver.Bindings()) {
+    if (item.first->NodeType() == ExpressionType::Parameter &&
+        static_cast<const ParameterExpression *>(item.first)->Name() == U"k") {
+      REQUIRE(item.second.declaration == nullptr);
+      REQUIRE(item.second.slot == -1);
+    }
+  }
+
+  TypeFactory types;
+  const Type *int32 = TypeFactory::CreateBasicType(TypeCode::Int32);
+  Scope<const Type *> globals;
+  globals.Declare(U"g", types.CreateCallableType({int32}, int32));
+  globals.Declare(U"h", types.CreateCallableType({int32}, int32));
+  TypeChecker typeChecker(&resolver.Bindings(), &types);
+  Scope<const Type *> typeScope(&globals);
+  REQUIRE_THROWS_WITH(typeChecker.Visit(exp, &typeScope), "'k' not defined.");
+  globals.Declare(U"k", int32);
+  REQUIRE(typeChecker.Visit(exp, &typeScope)->GetTypeCode() ==
+          TypeCode::Callable);
+}
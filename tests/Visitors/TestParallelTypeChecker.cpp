@@ -0,0 +1,68 @@
+#include <catch2/catch.hpp>
+
+#include "LexicalAnalysis/Lexer.hpp"
+#include "SyntaxAnalysis/Parser.hpp"
+#include "Utility/UTF32Functions.hpp"
+#include "Visitors/ParallelTypeChecker.hpp"
+
+using namespace Cygni::LexicalAnalysis;
+using namespace Cygni::SyntaxAnalysis;
+using namespace Cygni::Expressions;
+using namespace Cygni::Visitors;
+
+static std::vector<const LambdaExpression *>
+ParseFunctions(Parser &parser) {
+  std::vector<const LambdaExpression *> functions;
+  while (!parser.IsEof()) {
+    functions.push_back(static_cast<const LambdaExpression *>(
+        parser.FunctionDeclarationStatement()));
+  }
+  return functions;
+}
+
+TEST_CASE("test parallel type checking", "[ParallelTypeChecker]") {
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("source-code-file");
+
+  std::string code;
+  for (int i = 0; i < 200; i++) {
+    std::string next = "f" + std::to_string((i + 1) % 200);
+    code += "func f" + std::to_string(i) +
+            "(x: Int, c: Char): Int { var a = x * 2; "
+            "var u = { if (a < 10) { a; } else { c; } }; "
+            "while (a > 0) { a = a - 1; } " +
+            next + "(a, c); }\n";
+  }
+  Lexer lexer(sourceCodeFile, Cygni::Utility::UTF8ToUTF32(code));
+  std::vector<Token> tokens = lexer.ReadAll();
+  Parser parser(tokens, sourceCodeFile);
+  auto functions = ParseFunctions(parser);
+
+  ParallelTypeChecker sequential(1);
+  sequential.Check(functions);
+  ParallelTypeChecker parallel(4);
+  parallel.Check(functions);
+
+  REQUIRE(parallel.NodeTypes().size() == sequential.NodeTypes().size());
+  for (const auto &item : sequential.NodeTypes()) {
+    REQUIRE(TypeFactory::AreTypesEqual(parallel.GetType(item.first),
+                                       item.second));
+  }
+  REQUIRE(parallel.GetType(functions.at(7))->GetTypeCode() ==
+          TypeCode::Callable);
+}
+
+TEST_CASE("test parallel type checking errors", "[ParallelTypeChecker]") {
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("source-code-file");
+
+  Lexer lexer(sourceCodeFile, U"func f(x: Int): Int { g(x); }\n"
+                              U"func g(x: Int): Int { 'c'; }\n"
+                              U"func h(x: Int): Int { k(x); }\n");
+  std::vector<Token> tokens = lexer.ReadAll();
+  Parser parser(tokens, sourceCodeFile);
+  auto functions = ParseFunctions(parser);
+
+  ParallelTypeChecker checker(2);
+  REQUIRE_THROWS_WITH(checker.Check(functions), "return type mismatch error.");
+}
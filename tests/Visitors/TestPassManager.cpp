@@ -0,0 +1,57 @@
+#include <catch2/catch.hpp>
+
+#include "LexicalAnalysis/Lexer.hpp"
+#include "SyntaxAnalysis/Parser.hpp"
+#include "Visitors/NameLocator.hpp"
+#include "Visitors/NameResolver.hpp"
+#include "Visitors/PassManager.hpp"
+#include "Visitors/TypeChecker.hpp"
+
+using namespace Cygni::LexicalAnalysis;
+using namespace Cygni::SyntaxAnalysis;
+using namespace Cygni::Expressions;
+using namespace Cygni::Visitors;
+
+TEST_CASE("test fused passes", "[PassManager]") {
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("source-code-file");
+
+  Lexer lexer(sourceCodeFile,
+              U"func f(x: Int, y: Int): Int { var a = x + y * 2; "
+              U"{ var b = a; while (b < 10) { b = b + 1; } }; "
+              U"if (a == y) { var c = 'c'; c; } else { \"c\"; } a; }");
+
+  std::vector<Token> tokens = lexer.ReadAll();
+  Parser parser(tokens, sourceCodeFile);
+  auto exp = parser.FunctionDeclarationStatement();
+
+  Scope<const Type *> typeScope;
+  TypeChecker typeChecker;
+  typeChecker.Visit(exp, &typeScope);
+  Scope<NameInfo> nameScope;
+  NameLocator nameLocator;
+  nameLocator.Visit(exp, &nameScope);
+
+  Scope<const Expression *> scope;
+  NameResolver fusedResolver(&scope);
+  TypeChecker fusedTypeChecker(&fusedResolver.Bindings());
+  NameLocator fusedNameLocator(&fusedResolver.Bindings());
+  PassManager passManager;
+  passManager.Add(&fusedResolver);
+  passManager.Add(&fusedTypeChecker);
+  passManager.Add(&fusedNameLocator);
+  passManager.Run(exp);
+
+  REQUIRE(scope.Depth() == 0);
+  REQUIRE(fusedNameLocator.NameInfoTable().size() ==
+          nameLocator.NameInfoTable().size());
+  for (const auto &item : nameLocator.NameInfoTable()) {
+    const NameInfo &fused = fusedNameLocator.NameInfoTable().at(item.first);
+    REQUIRE(fused.kind == item.second.kind);
+    REQUIRE(fused.number == item.second.number);
+    REQUIRE(TypeFactory::AreTypesEqual(fusedTypeChecker.GetType(item.first),
+                                       typeChecker.GetType(item.first)));
+  }
+  REQUIRE(TypeFactory::AreTypesEqual(fusedTypeChecker.GetType(exp),
+                                     typeChecker.GetType(exp)));
+}
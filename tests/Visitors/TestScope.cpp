@@ -0,0 +1,46 @@
+#include <catch2/catch.hpp>
+
+#include "Visitors/Scope.hpp"
+
+using namespace Cygni::Visitors;
+
+TEST_CASE("scope shadowing", "[Scope]") {
+  Scope<int> scope;
+
+  scope.Declare(U"x", 1);
+  scope.Declare(U"y", 2);
+  REQUIRE(scope.Get(U"x") == 1);
+
+  scope.Enter();
+  scope.Declare(U"x", 10);
+  REQUIRE(scope.Get(U"x") == 10);
+  REQUIRE(scope.Get(U"y") == 2);
+
+  scope.Enter();
+  scope.Declare(U"z", 30);
+  scope.Declare(U"z", 31);
+  REQUIRE(scope.Get(U"z") == 31);
+  scope.Exit();
+
+  REQUIRE_FALSE(scope.Exists(U"z"));
+  REQUIRE(scope.Get(U"x") == 10);
+  scope.Exit();
+
+  REQUIRE(scope.Get(U"x") == 1);
+  REQUIRE_THROWS_AS(scope.Get(U"z"), ScopeException);
+}
+
+TEST_CASE("nested scope exits on unwinding", "[Scope]") {
+  Scope<int> scope;
+  scope.Declare(U"x", 1);
+
+  try {
+    NestedScope<int> nested(&scope);
+    scope.Declare(U"x", 2);
+    throw std::runtime_error("unwind");
+  } catch (const std::runtime_error &) {
+  }
+
+  REQUIRE(scope.Depth() == 0);
+  REQUIRE(scope.Get(U"x") == 1);
+}
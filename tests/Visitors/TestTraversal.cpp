@@ -0,0 +1,136 @@
+#include <catch2/catch.hpp>
+
+#include "LexicalAnalysis/Lexer.hpp"
+#include "SyntaxAnalysis/Parser.hpp"
+#include "Visitors/ExpressionJsonSerializer.hpp"
+#include "Visitors/HirLowering.hpp"
+#include "Visitors/PassManager.hpp"
+
+using namespace Cygni::LexicalAnalysis;
+using namespace Cygni::SyntaxAnalysis;
+using namespace Cygni::Expressions;
+using namespace Cygni::Visitors;
+using namespace Cygni::HighLevelIR;
+
+static const int DEEP_TREE_SIZE = 100000;
+
+TEST_CASE("test binary chain order", "[Traversal]") {
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("source-code-file");
+
+  Lexer lexer(sourceCodeFile,
+              U"func f(x: Int, y: Int, z: Int): Int { x - y * z - z; }");
+
+  std::vector<Token> tokens = lexer.ReadAll();
+  Parser parser(tokens, sourceCodeFile);
+  auto exp = parser.FunctionDeclarationStatement();
+
+  ExpressionJsonSerializer serializer;
+  Json body = serializer.Visit(exp)["Body"]["Expressions"][0];
+  REQUIRE(body["NodeType"] == "Subtract");
+  REQUIRE(body["Right"]["Name"] == "z");
+  REQUIRE(body["Left"]["NodeType"] == "Subtract");
+  REQUIRE(body["Left"]["Left"]["Name"] == "x");
+  REQUIRE(body["Left"]["Right"]["NodeType"] == "Multiply");
+  REQUIRE(body["Left"]["Right"]["Left"]["Name"] == "y");
+
+  Scope<NameInfo> scope;
+  NameLocator nameLocator;
+  nameLocator.Visit(exp, &scope);
+  REQUIRE(nameLocator.NameInfoTable().size() == 7);
+}
+
+TEST_CASE("test long binary chains", "[Traversal]") {
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("source-code-file");
+
+  std::u32string code = U"func f(x: Int): Int { x";
+  for (int i = 1; i < DEEP_TREE_SIZE; i++) {
+    code += i % 2 == 0 ? U" + x" : U" - x";
+  }
+  code += U"; }";
+
+  Lexer lexer(sourceCodeFile, code);
+  std::vector<Token> tokens = lexer.ReadAll();
+  Parser parser(tokens, sourceCodeFile);
+  auto exp = parser.FunctionDeclarationStatement();
+
+  NameResolver resolver;
+  Scope<const Expression *> resolverScope;
+  resolver.Visit(exp, &resolverScope);
+  REQUIRE(resolver.Bindings().size() == DEEP_TREE_SIZE + 1);
+
+  TypeChecker typeChecker(&resolver.Bindings());
+  Scope<const Type *> typeScope;
+  typeChecker.Visit(exp, &typeScope);
+
+  NameLocator nameLocator(&resolver.Bindings());
+  Scope<NameInfo> nameScope;
+  nameLocator.Visit(exp, &nameScope);
+  REQUIRE(nameLocator.NameInfoTable().size() == DEEP_TREE_SIZE + 1);
+
+  HirFactory factory;
+  HirLowering lowering(factory, typeChecker, nameLocator.NameInfoTable(),
+                       resolver.Bindings());
+  auto lambda = static_cast<const HirLambda *>(lowering.Visit(exp));
+  auto body = static_cast<const HirBlock *>(lambda->Body());
+  const HirNode *chain = body->Expressions().at(0);
+  REQUIRE(chain->GetType()->GetTypeCode() == TypeCode::Int32);
+  int length = 0;
+  while (chain->NodeType() != ExpressionType::Parameter) {
+    chain = static_cast<const HirBinary *>(chain)->Left();
+    length++;
+  }
+  REQUIRE(length == DEEP_TREE_SIZE - 1);
+
+  /* nlohmann::json copies and destroys values recursively, so the deep
+   * result is taken apart one level at a time. */
+  ExpressionJsonSerializer serializer;
+  Json root = serializer.Visit(exp);
+  Json json = std::move(root["Body"]["Expressions"][0]);
+  length = 0;
+  while (json["NodeType"] != "Parameter") {
+    Json left = std::move(json["Left"]);
+    json = std::move(left);
+    length++;
+  }
+  REQUIRE(length == DEEP_TREE_SIZE - 1);
+
+  Scope<const Expression *> scope;
+  NameResolver fusedResolver(&scope);
+  TypeChecker fusedTypeChecker(&fusedResolver.Bindings());
+  PassManager passManager;
+  passManager.Add(&fusedResolver);
+  passManager.Add(&fusedTypeChecker);
+  passManager.Run(exp);
+  REQUIRE(TypeFactory::AreTypesEqual(fusedTypeChecker.GetType(exp),
+                                     typeChecker.GetType(exp)));
+}
+
+TEST_CASE("test deeply nested trees", "[Traversal]") {
+  std::shared_ptr<SourceCodeFile> sourceCodeFile =
+      std::make_shared<SourceCodeFile>("source-code-file");
+  SourceRange range(sourceCodeFile, 1, 1, 1, 1);
+
+  ExpressionFactory expressionFactory;
+  Expression *exp = expressionFactory.Create<ConstantExpression>(
+      range, std::u32string(U"true"), TypeCode::Boolean);
+  for (int i = 0; i < DEEP_TREE_SIZE; i++) {
+    exp = expressionFactory.Create<UnaryExpression>(
+        range, ExpressionType::Not, exp,
+        TypeFactory::CreateBasicType(TypeCode::Unknown));
+  }
+
+  Scope<const Expression *> scope;
+  NameResolver resolver(&scope);
+  TypeChecker typeChecker(&resolver.Bindings());
+  NameLocator nameLocator(&resolver.Bindings());
+  PassManager passManager;
+  passManager.Add(&resolver);
+  passManager.Add(&typeChecker);
+  passManager.Add(&nameLocator);
+  passManager.Run(exp);
+
+  REQUIRE(typeChecker.GetType(exp)->GetTypeCode() == TypeCode::Boolean);
+  REQUIRE(nameLocator.NameInfoTable().size() == 1);
+}